@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <functional>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -53,6 +54,22 @@ struct Translation {
   double z;
 };
 
+/// \brief Hashes a pair of segment IDs. The IDs are combined with a multiplication by an odd
+/// constant and the result is mixed with the finalizer of SplitMix64, so that all the bits of the
+/// hash depend on both IDs. Segment IDs are often consecutive, and hashing them without mixing
+/// fills hash tables unevenly.
+// 分割块ID对的哈希：用奇数常数组合两个ID，再用SplitMix64的终结函数混合所有位
+inline uint64_t hashIdPair(const IdPair& pair) {
+  static_assert(std::is_same<IdPair, std::pair<int64_t, int64_t>>::value,
+                "The hashing function is valid only if IdPair is defined as "
+                "std::pair<int64_t, int64_t>");
+  uint64_t hash = static_cast<uint64_t>(pair.first) * 0x9e3779b97f4a7c15ull +
+                  static_cast<uint64_t>(pair.second);
+  hash = (hash ^ (hash >> 30u)) * 0xbf58476d1ce4e5b9ull;
+  hash = (hash ^ (hash >> 27u)) * 0x94d049bb133111ebull;
+  return hash ^ (hash >> 31u);
+}
+
 /// \brief Struct providing an hashing function for pairs of segment IDs.
 struct IdPairHash {
   /// \brief Hashing function for pairs of segment IDs.
@@ -62,15 +79,7 @@ struct IdPairHash {
   // 参数：ID对
   // 返回：ID对的散列
   size_t operator() (const IdPair& pair) const {
-    static_assert(std::is_same<IdPair, std::pair<int64_t, int64_t>>::value,
-                  "The hashing function is valid only if IdPair is defined as "
-                  "std::pair<int64_t, int64_t>");
-    // We expect IDs to be always positive, which enables this trick for combining the two IDs. If
-    // that would not be the case the hashing function could be less efficient, but still
-    // functional.
-	// ID应该是正的，才可以这一操作。如果不是正的，功能性可以满足，但效率会降低
-    return std::hash<uint64_t>{}(static_cast<uint64_t>(pair.first) << 1 +
-                                 static_cast<uint64_t>(pair.second));
+    return static_cast<size_t>(hashIdPair(pair));
   }
 };
 
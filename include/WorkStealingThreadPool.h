@@ -0,0 +1,104 @@
+#ifndef WORK_STEALING_THREAD_POOL_H_
+#define WORK_STEALING_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bron_kerbosch {
+
+/// \brief A pool of worker threads executing tasks. Every worker has its own task queue: tasks are
+/// taken from the back of the own queue and, when the own queue is empty, stolen from the front
+/// of the queues of the other workers. This balances the load when tasks have very different
+/// execution times.
+/// \remark Tasks must not block waiting for other tasks submitted to the same pool.
+// 工作窃取线程池：每个工作线程有自己的任务队列，自己的队列为空时从其他线程的队列窃取任务
+class WorkStealingThreadPool {
+ public:
+  /// \brief Initializes a new instance of the WorkStealingThreadPool class.
+  /// \param num_threads Number of worker threads. Must be greater than zero.
+  explicit WorkStealingThreadPool(size_t num_threads);
+
+  /// \brief Finalizes an instance of the WorkStealingThreadPool class. Pending tasks are
+  /// completed before the workers are stopped.
+  ~WorkStealingThreadPool();
+
+  WorkStealingThreadPool(const WorkStealingThreadPool&) = delete;
+  WorkStealingThreadPool& operator=(const WorkStealingThreadPool&) = delete;
+
+  /// \brief Gets the number of worker threads.
+  inline size_t getNumThreads() const { return workers_.size(); }
+
+  /// \brief Gets the index of the worker thread of this pool executing the caller.
+  /// \returns Index of the worker in [0, getNumThreads()), or \c kNotAWorker if the caller is not
+  /// a worker of this pool.
+  size_t getCurrentWorkerIndex() const;
+
+  /// \brief Submits a task to the pool.
+  /// \param function The function to be executed.
+  /// \returns A future that will contain the result of the function.
+  // 提交任务，返回保存结果的future
+  template<typename Function>
+  auto submit(Function&& function) -> std::future<decltype(function())> {
+    typedef decltype(function()) Result;
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+    std::future<Result> result = task->get_future();
+    enqueue([task](size_t) { (*task)(); });
+    return result;
+  }
+
+  /// \brief Executes \c function(index, worker_index) for every index in [begin, end) and waits
+  /// for all the calls to complete. \c worker_index identifies the worker executing the call and
+  /// can be used for indexing per-worker scratch data. If called from a worker of this pool, the
+  /// loop is executed sequentially on the calling worker.
+  /// \param begin First index of the range.
+  /// \param end Index after the last index of the range.
+  /// \param function The function to be executed.
+  // 对[begin, end)中每个索引并行执行 function(index, worker_index)，等待全部完成后返回
+  void parallelFor(size_t begin, size_t end,
+                   const std::function<void(size_t index, size_t worker_index)>& function);
+
+  /// \brief Value returned by getCurrentWorkerIndex() for threads that are not workers of the
+  /// pool.
+  static constexpr size_t kNotAWorker = std::numeric_limits<size_t>::max();
+
+ private:
+  typedef std::function<void(size_t worker_index)> Task;
+
+  // Task queue of a worker.
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  // Adds a task to the queue of the current worker, or to the queue of a worker chosen in
+  // round-robin order if the caller is not a worker.
+  void enqueue(Task task);
+
+  // Tries to get a task from the own queue, or to steal one from the other queues.
+  bool tryGetTask(size_t worker_index, Task& task);
+
+  // Main loop of the worker threads.
+  void workerLoop(size_t worker_index);
+
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+  std::vector<std::thread> workers_;
+
+  // Used for waking up idle workers.
+  std::mutex wake_mutex_;
+  std::condition_variable wake_condition_;
+  std::atomic<size_t> num_queued_tasks_;
+  std::atomic<size_t> next_queue_;
+  bool stop_ = false;
+}; // class WorkStealingThreadPool
+
+} // namespace bron_kerbosch
+
+#endif // WORK_STEALING_THREAD_POOL_H_
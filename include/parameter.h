@@ -93,6 +93,81 @@ struct GeometricConsistencyParams {
   // Maximum consistency distance between two matches in order for them to be cached as candidates.
   // Used in the incremental recognizer only.
   float max_consistency_distance_for_caching = 10.0f;
+
+  // Consistency graph construction parameters.
+  // Maximum memory in megabytes used by the candidate consistent matches cached by the incremental
+  // recognizer, checked after every recognition. When the candidates exceed it, the candidates of
+  // the matches cached the longest ago are evicted, and these matches are tested again as new
+  // matches in the next recognition. The consistency graph is not affected. The candidates of the
+  // matches cached in the current recognition are never evicted, so the limit can be exceeded
+  // when they do not fit. Zero means no limit.
+  double max_match_cache_memory_mb = 0.0;
+  // Partitioning of the matches used for restricting the consistency tests to nearby matches in
+  // the incremental recognizer. Options are "Grid" (dense 2D grid over the XY bounding box of the
+  // scene centroids) and "Voxel" (sparse hashed 3D voxels, whose memory only depends on the
+  // number of occupied voxels, for scenes with large or non-planar extents).
+  std::string matches_partitioner = "Grid";
+  // Number of threads used for building the consistency graph in the incremental recognizer. With
+  // more than one thread, stripes of consecutive partitions are processed concurrently. The graph
+  // and the cache do not depend on the number of threads.
+  int num_consistency_graph_threads = 1;
+  // If true, the matches are sorted along a Z-order (Morton) curve of their scene centroids
+  // before the consistency graph is built, so that matches close in the scene are close in memory.
+  // The candidate clusters contain the same matches as without sorting, up to ties between
+  // cliques of the same size.
+  bool enable_morton_ordering = false;
+  // If true, the incremental recognizer keeps the consistency graph across recognitions and only
+  // applies the changes: vertices of vanished or invalidated matches are disconnected, and edges
+  // are added or removed where the consistency changed. The cliques are searched directly on that
+  // graph, whose vertices are the cache slots of the matches.
+  bool enable_persistent_consistency_graph = false;
+
+  // Clique search parameters.
+  // Maximum number of candidate clusters returned by the recognizer. If 1, only a maximum clique
+  // is searched. Otherwise the largest maximal cliques are enumerated. If 0, all the maximal
+  // cliques with at least min_cluster_size matches are returned.
+  int max_num_candidate_clusters = 1;
+  // Algorithm used for finding the maximum clique in the consistency graph. Options are
+  // "Degeneracy" (search on the adjacency lists of the graph), "Bitset" (search on a dense
+  // bitset adjacency matrix, faster on graphs with up to a few thousands vertices), "Coloring"
+  // (bitset branch and bound with greedy coloring bounds, best on dense graphs),
+  // "MaximumWeight" (clique maximizing the sum of the match weights, by default their confidence,
+  // with weighted coloring bounds) and "Heuristic" (approximate search with the clique search
+  // heuristic only, for graphs too big for an exact search). The strategy is used when
+  // max_num_candidate_clusters is 1.
+  std::string clique_search_strategy = "Degeneracy";
+  // Number of threads used by the "Degeneracy" clique search. With more than one thread, the
+  // searches rooted at each vertex are distributed on a thread pool.
+  int num_clique_search_threads = 1;
+  // If true, the maximum clique of consistency graphs with at most 256 vertices is searched with
+  // bitset kernels specialized for 64, 128 or 256 vertices. Applies to the "Bitset" and
+  // "Coloring" strategies only.
+  bool enable_fixed_width_clique_kernels = false;
+  // If true, before the clique search the consistency graph is reduced to its k-core, where k is
+  // min_cluster_size - 1. Matches outside the k-core cannot belong to a big enough cluster.
+  bool enable_k_core_reduction = false;
+  // If true, before the clique search the vertices of the consistency graph are renumbered in
+  // degeneracy order, so that the neighbors and the degrees read by the search are accessed
+  // almost sequentially. The cliques found are mapped back to the original matches.
+  bool enable_degeneracy_relabeling = false;
+  // If true, a big clique is first searched with a heuristic (greedy construction followed by a
+  // local search), and the exact clique search then only looks for bigger cliques. Used when
+  // max_num_candidate_clusters is 1. Does not apply to the "MaximumWeight" strategy.
+  bool enable_clique_search_heuristic = false;
+  // Time in milliseconds spent in the local search of the clique search heuristic. If zero, only
+  // the greedy construction is performed.
+  double clique_search_heuristic_time_ms = 1.0;
+  // Time budget for the clique search in milliseconds. When the budget is exhausted, the best
+  // clique found so far is used, or the clique of the greedy construction of the heuristic if the
+  // search did not find any. Zero means no limit.
+  double clique_search_time_budget_ms = 0.0;
+  // Maximum number of nodes of the search tree expanded by the clique search. Zero means no
+  // limit.
+  int clique_search_max_expanded_nodes = 0;
+  // If true, the maximum clique found in a frame is used as initial lower bound of the clique
+  // search in the next frame. Matches are tracked across frames by their IDs. Used in the
+  // incremental recognizer only, when max_num_candidate_clusters is 1.
+  bool enable_warm_start = false;
 }; // struct GeometricConsistencyParams
 
 struct GroundTruthParameters {
@@ -0,0 +1,122 @@
+#ifndef ASYNC_RECOGNIZER_HPP_
+#define ASYNC_RECOGNIZER_HPP_
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "parameter.h"
+#include "recognizers/IncrementalGeometricConsistencyRecognizer.hpp"
+#include "RecognizerData.h"
+
+namespace bron_kerbosch {
+
+/// \brief Asynchronous front-end of the incremental recognizer for streams of frames. The frames
+/// are recognized in submission order by two pipelined stages running on their own threads: the
+/// consistency graph of a frame is built while the cliques of the previous frame are searched.
+/// The frames waiting for the first stage are stored in a bounded queue. When the queue is full,
+/// submit() either blocks or drops the oldest queued frame.
+/// With the persistent consistency graph, which both stages use, the graph of a frame is only
+/// built once the previous frame is completed.
+// 增量识别器的异步前端：两个流水线阶段分别在各自的线程上运行，建图与上一帧的团搜索重叠；
+// 等待的帧存储在有界队列中，队列满时阻塞或丢弃最早的帧
+class AsyncRecognizer {
+ public:
+  /// \brief Behavior of submit() when the queue is full.
+  enum class QueueFullPolicy {
+    /// \brief Wait until a frame leaves the queue.
+    kBlock,
+    /// \brief Drop the oldest frame of the queue, whose result is marked as dropped.
+    kDropOldest
+  };
+
+  /// \brief Result of the recognition of a frame.
+  struct Result {
+    /// \brief True if the frame was dropped from the queue without being recognized.
+    bool dropped = false;
+    /// \brief The candidate transformations between model and scene, sorted in decreasing
+    /// recognition quality order. If empty, the model was not recognized.
+    std::vector<Eigen::Matrix4f, Eigen::aligned_allocator<Eigen::Matrix4f>>
+    candidate_transformations;
+    /// \brief The candidate clusters of matches corresponding to the transformations.
+    std::vector<PairwiseMatches> candidate_clusters;
+  };
+
+  /// \brief Initializes a new instance of the AsyncRecognizer class.
+  /// \param params The parameters of the geometry consistency grouping.
+  /// \param max_model_radius Radius of the bounding cylinder of the model.
+  /// \param max_queued_frames Maximum number of frames waiting for the first stage. Must be
+  /// greater than zero.
+  /// \param queue_full_policy Behavior of submit() when the queue is full.
+  AsyncRecognizer(const GeometricConsistencyParams& params, float max_model_radius,
+                  size_t max_queued_frames, QueueFullPolicy queue_full_policy);
+
+  /// \brief Finalizes an instance of the AsyncRecognizer class. The submitted frames are
+  /// recognized before the stages are stopped.
+  ~AsyncRecognizer();
+
+  AsyncRecognizer(const AsyncRecognizer&) = delete;
+  AsyncRecognizer& operator=(const AsyncRecognizer&) = delete;
+
+  /// \brief Submits a frame for recognition.
+  /// \param predicted_matches Vector of possible correspondences between model and scene.
+  /// \returns A future that will contain the result of the recognition of the frame.
+  // 提交一帧进行识别，返回保存识别结果的future
+  std::future<Result> submit(PairwiseMatches predicted_matches);
+
+  /// \brief Gets the number of frames dropped because the queue was full.
+  size_t getNumDroppedFrames() const;
+
+ private:
+  typedef GraphBasedGeometricConsistencyRecognizer::PreparedRecognition PreparedRecognition;
+
+  // A frame waiting for the first stage.
+  struct QueuedFrame {
+    PairwiseMatches predicted_matches;
+    std::promise<Result> result;
+  };
+
+  // A frame between the two stages.
+  struct PreparedFrame {
+    PairwiseMatches predicted_matches;
+    PreparedRecognition prepared;
+    std::promise<Result> result;
+  };
+
+  // Main loops of the stages.
+  void prepareLoop();
+  void completeLoop();
+
+  IncrementalGeometricConsistencyRecognizer recognizer_;
+  const size_t max_queued_frames_;
+  const QueueFullPolicy queue_full_policy_;
+
+  // The frames between the stages are stored in a ring of two buffers, whose storage is reused:
+  // one frame can be prepared while another one is completed. Only one frame is allowed between
+  // the stages when the persistent graph is used.
+  static constexpr size_t kNumPreparedFrameBuffers = 2u;
+  PreparedFrame prepared_frames_[kNumPreparedFrameBuffers];
+  const size_t max_prepared_frames_;
+  size_t first_prepared_frame_ = 0u;
+  size_t num_prepared_frames_ = 0u;
+
+  // State shared by the stages and the callers, protected by mutex_.
+  mutable std::mutex mutex_;
+  std::condition_variable condition_;
+  std::deque<QueuedFrame> queued_frames_;
+  size_t num_dropped_frames_ = 0u;
+  bool stop_ = false;
+  bool prepare_stage_done_ = false;
+
+  std::thread prepare_thread_;
+  std::thread complete_thread_;
+}; // class AsyncRecognizer
+
+} // namespace bron_kerbosch
+
+#endif // ASYNC_RECOGNIZER_HPP_
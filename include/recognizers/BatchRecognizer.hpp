@@ -0,0 +1,121 @@
+#ifndef BATCH_RECOGNIZER_HPP_
+#define BATCH_RECOGNIZER_HPP_
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "parameter.h"
+#include "recognizers/IncrementalGeometricConsistencyRecognizer.hpp"
+#include "RecognizerData.h"
+#include "WorkStealingThreadPool.h"
+
+namespace bron_kerbosch {
+
+/// \brief Recognizes a model in many independent sets of matches concurrently, e.g. for several
+/// robots or submaps at once. The sets are distributed on an internal thread pool. Every worker
+/// owns a recognizer, whose graphs and clique search buffers are reused by the sets it processes,
+/// and the cache of the recognizer is cleared before every set, so that the results only depend
+/// on the set. The sets are processed in decreasing size order, so that a few large sets do not
+/// end up running alone after all the small ones.
+// 并发识别多组相互独立的匹配（例如多个机器人或子地图）。每个工作线程拥有一个识别器，
+// 其图和团搜索缓冲在处理的各组之间复用；各组按大小降序处理，以平衡大小差异很大的任务
+class BatchRecognizer {
+ public:
+  /// \brief Result of the recognition of a set of matches.
+  struct Result {
+    /// \brief The candidate transformations between model and scene, sorted in decreasing
+    /// recognition quality order. If empty, the model was not recognized.
+    std::vector<Eigen::Matrix4f, Eigen::aligned_allocator<Eigen::Matrix4f>>
+    candidate_transformations;
+    /// \brief The candidate clusters of matches corresponding to the transformations.
+    std::vector<PairwiseMatches> candidate_clusters;
+  };
+
+  /// \brief Function giving the key of the model group of a match, e.g. the map tile, from the
+  /// ID of the model segment of the match (\c ids_.first).
+  typedef std::function<Id(Id model_segment_id)> ModelGroupFunction;
+
+  /// \brief Result of the recognition of the matches of a model group.
+  struct GroupResult {
+    /// \brief The key of the model group.
+    Id group_key;
+    /// \brief Number of matches of the group.
+    size_t num_matches;
+    /// \brief The result of the recognition of the matches of the group.
+    Result result;
+  };
+
+  /// \brief Initializes a new instance of the BatchRecognizer class.
+  /// \param params The parameters of the geometry consistency grouping. The sets are recognized
+  /// sequentially by the workers, so the clique search and the consistency graph construction of
+  /// every set use one thread.
+  /// \param max_model_radius Radius of the bounding cylinder of the model.
+  /// \param num_threads Number of worker threads. Must be greater than zero.
+  BatchRecognizer(const GeometricConsistencyParams& params, float max_model_radius,
+                  size_t num_threads);
+
+  BatchRecognizer(const BatchRecognizer&) = delete;
+  BatchRecognizer& operator=(const BatchRecognizer&) = delete;
+
+  /// \brief Recognizes the model in every set of matches and waits for all the recognitions to
+  /// complete.
+  /// \param match_sets The sets of matches.
+  /// \param results Vector in which the results will be stored. \c results[i] is the result of
+  /// \c match_sets[i]. Previously allocated memory is reused.
+  // 识别每组匹配中的模型，results[i] 为 match_sets[i] 的结果
+  void recognize(const std::vector<PairwiseMatches>& match_sets, std::vector<Result>& results);
+
+  /// \brief Recognizes the model in every set of matches.
+  /// \param match_sets The sets of matches.
+  /// \returns The results of the sets, in the order of the sets.
+  std::vector<Result> recognize(const std::vector<PairwiseMatches>& match_sets) {
+    std::vector<Result> results;
+    recognize(match_sets, results);
+    return results;
+  }
+
+  /// \brief Recognizes the model groups in a scene separately. The matches are split by model
+  /// group and every group is recognized as an independent set, as matches with different models
+  /// cannot belong to the same recognition. This replaces one consistency graph of all the
+  /// matches with one smaller graph per group.
+  /// \param predicted_matches Vector of possible correspondences between the models and the
+  /// scene.
+  /// \param get_model_group Function giving the key of the model group of a match.
+  /// \param group_results Vector in which the results of the groups will be stored, in increasing
+  /// key order.
+  // 按模型分组分别识别：匹配按模型组拆分，每组作为独立的一组匹配识别，
+  // 以每组一个较小的一致性图代替所有匹配的一个一致性图
+  void recognizeModelGroups(const PairwiseMatches& predicted_matches,
+                            const ModelGroupFunction& get_model_group,
+                            std::vector<GroupResult>& group_results);
+
+  /// \brief Gets the number of worker threads.
+  inline size_t getNumThreads() const { return thread_pool_.getNumThreads(); }
+
+ private:
+  // Recognizes the model in the first num_sets sets of matches.
+  void recognizeSets(const std::vector<PairwiseMatches>& match_sets, size_t num_sets,
+                     std::vector<Result>& results);
+
+  WorkStealingThreadPool thread_pool_;
+
+  // Recognizer of every worker.
+  std::vector<std::unique_ptr<IncrementalGeometricConsistencyRecognizer>> recognizers_;
+
+  // Indices of the sets in decreasing size order.
+  std::vector<size_t> set_order_;
+
+  // Buffers for splitting the matches by model group: the group key of every match, the match
+  // indices sorted by group, and the matches and the results of the groups.
+  std::vector<Id> match_group_keys_;
+  std::vector<size_t> match_group_order_;
+  std::vector<PairwiseMatches> group_match_sets_;
+  std::vector<Result> group_set_results_;
+}; // class BatchRecognizer
+
+} // namespace bron_kerbosch
+
+#endif // BATCH_RECOGNIZER_HPP_
@@ -0,0 +1,186 @@
+#ifndef BITSET_ADJACENCY_MATRIX_HPP_
+#define BITSET_ADJACENCY_MATRIX_HPP_
+
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
+#include <boost/graph/graph_traits.hpp>
+#include <glog/logging.h>
+
+#include "recognizers/CompressedSparseRowGraph.hpp"
+#include "recognizers/SortedAdjacencyGraph.hpp"
+
+namespace bron_kerbosch {
+
+/// \brief Dense adjacency matrix of an undirected graph where every row is stored as a bitset.
+/// Rows are padded to a multiple of a cache line and start on a cache line boundary, so that set
+/// operations on rows can be performed word by word without crossing row boundaries.
+// 以位集形式存储的无向图稠密邻接矩阵，每一行按缓存行对齐并补齐
+class BitsetAdjacencyMatrix {
+ public:
+  /// \brief Type of the words composing a bitset.
+  typedef uint64_t Word;
+
+  /// \brief Number of bits in a word.
+  static constexpr size_t kBitsPerWord = 64u;
+
+  /// \brief Initializes a new instance of the BitsetAdjacencyMatrix class.
+  /// \param num_vertices Number of vertices of the graph. The matrix is initialized without edges.
+  explicit BitsetAdjacencyMatrix(const size_t num_vertices = 0u) { reset(num_vertices); }
+
+  /// \brief Removes all the edges and resizes the matrix to the specified number of vertices.
+  /// Previously allocated memory is reused when possible.
+  /// \param num_vertices Number of vertices of the graph.
+  // 清空所有边并调整矩阵大小，尽量复用已分配的内存
+  void reset(const size_t num_vertices) {
+    num_vertices_ = num_vertices;
+    words_per_row_ = getNumWords(num_vertices);
+    const size_t blocks_per_row = words_per_row_ / kWordsPerBlock;
+    blocks_.assign(blocks_per_row * num_vertices, CacheLineBlock());
+  }
+
+  /// \brief Fills the matrix with the edges of a graph.
+  /// \param graph The input graph. The graph must be undirected and have vertex descriptors of
+  /// type \c size_t.
+  // 用图的边填充矩阵
+  template<typename Graph>
+  void assignFromGraph(const Graph& graph) {
+    static_assert(std::is_same<typename boost::graph_traits<Graph>::vertex_descriptor,
+                               size_t>::value,
+                  "BitsetAdjacencyMatrix only supports graphs with vertex descriptors of type "
+                  "size_t.");
+    reset(boost::num_vertices(graph));
+    typename boost::graph_traits<Graph>::vertex_iterator v_it, v_end;
+    for (boost::tie(v_it, v_end) = boost::vertices(graph); v_it != v_end; ++v_it) {
+      Word* row = getRow(*v_it);
+      typename boost::graph_traits<Graph>::out_edge_iterator e_it, e_end;
+      for (boost::tie(e_it, e_end) = boost::out_edges(*v_it, graph); e_it != e_end; ++e_it) {
+        setBit(row, boost::target(*e_it, graph));
+      }
+    }
+  }
+
+  /// \brief Adds an undirected edge between two vertices.
+  inline void addEdge(const size_t u, const size_t v) {
+    setBit(getRow(u), v);
+    setBit(getRow(v), u);
+  }
+
+  /// \brief Checks if two vertices are connected by an edge.
+  inline bool hasEdge(const size_t u, const size_t v) const {
+    return testBit(getRow(u), v);
+  }
+
+  /// \brief Gets the bitset containing the neighbors of a vertex.
+  /// \param vertex The vertex.
+  /// \returns Pointer to the first word of the row. The row has \c getWordsPerRow() words.
+  inline const Word* getRow(const size_t vertex) const {
+    return blocks_[vertex * (words_per_row_ / kWordsPerBlock)].words;
+  }
+
+  /// \brief Gets the number of vertices of the graph.
+  inline size_t getNumVertices() const { return num_vertices_; }
+
+  /// \brief Gets the number of words in every row of the matrix.
+  inline size_t getWordsPerRow() const { return words_per_row_; }
+
+  /// \brief Gets the number of words needed for storing a bitset of the specified size. The
+  /// number is rounded up to a full cache line.
+  static inline size_t getNumWords(const size_t num_bits) {
+    const size_t num_blocks = (num_bits + kBitsPerBlock - 1u) / kBitsPerBlock;
+    return num_blocks * kWordsPerBlock;
+  }
+
+  /// \brief Sets a bit of a bitset.
+  static inline void setBit(Word* set, const size_t bit) {
+    set[bit / kBitsPerWord] |= Word(1u) << (bit % kBitsPerWord);
+  }
+
+  /// \brief Clears a bit of a bitset.
+  static inline void clearBit(Word* set, const size_t bit) {
+    set[bit / kBitsPerWord] &= ~(Word(1u) << (bit % kBitsPerWord));
+  }
+
+  /// \brief Tests a bit of a bitset.
+  static inline bool testBit(const Word* set, const size_t bit) {
+    return (set[bit / kBitsPerWord] >> (bit % kBitsPerWord)) & Word(1u);
+  }
+
+  /// \brief Counts the number of bits set in a word.
+  static inline size_t popCount(const Word word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_popcountll(word));
+#else
+    return std::bitset<kBitsPerWord>(word).count();
+#endif
+  }
+
+  /// \brief Gets the index of the highest bit set in a non-zero word.
+  static inline size_t highestBit(const Word word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return kBitsPerWord - 1u - static_cast<size_t>(__builtin_clzll(word));
+#else
+    size_t bit = 0u;
+    for (Word w = word; w >>= 1u; ++bit) {}
+    return bit;
+#endif
+  }
+
+  /// \brief Gets the index of the lowest bit set in a non-zero word.
+  static inline size_t lowestBit(const Word word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_ctzll(word));
+#else
+    return highestBit(word & (~word + 1u));
+#endif
+  }
+
+  /// \brief Counts the number of bits set in a bitset.
+  static inline size_t count(const Word* set, const size_t num_words) {
+    size_t bits = 0u;
+    for (size_t i = 0u; i < num_words; ++i) bits += popCount(set[i]);
+    return bits;
+  }
+
+  /// \brief Computes the intersection of two bitsets, word by word.
+  /// \param a The first bitset.
+  /// \param b The second bitset.
+  /// \param result The bitset where the intersection is stored. Can alias \c a or \c b.
+  /// \param num_words Number of words of the bitsets.
+  /// \returns The number of bits set in the intersection.
+  // 按字计算两个位集的交集，并返回交集中的元素个数
+  static inline size_t intersect(const Word* a, const Word* b, Word* result,
+                                 const size_t num_words) {
+    size_t bits = 0u;
+    for (size_t i = 0u; i < num_words; ++i) {
+      result[i] = a[i] & b[i];
+      bits += popCount(result[i]);
+    }
+    return bits;
+  }
+
+ private:
+  static constexpr size_t kCacheLineSize = 64u;
+  static constexpr size_t kWordsPerBlock = kCacheLineSize / sizeof(Word);
+  static constexpr size_t kBitsPerBlock = kWordsPerBlock * kBitsPerWord;
+
+  // A cache line worth of words. Over-aligned allocations are guaranteed by C++17, so every row
+  // starts at a cache line boundary.
+  struct alignas(kCacheLineSize) CacheLineBlock {
+    Word words[kWordsPerBlock] = { };
+  };
+
+  inline Word* getRow(const size_t vertex) {
+    return blocks_[vertex * (words_per_row_ / kWordsPerBlock)].words;
+  }
+
+  size_t num_vertices_ = 0u;
+  size_t words_per_row_ = 0u;
+  std::vector<CacheLineBlock> blocks_;
+}; // class BitsetAdjacencyMatrix
+
+} // namespace bron_kerbosch
+
+#endif // BITSET_ADJACENCY_MATRIX_HPP_
@@ -0,0 +1,127 @@
+#ifndef CANDIDATE_LIST_POOL_HPP_
+#define CANDIDATE_LIST_POOL_HPP_
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <glog/logging.h>
+
+namespace bron_kerbosch {
+
+/// \brief Storage of the candidate consistent matches of the cache slots of the incremental
+/// recognizer. The lists of all the slots are stored in a single array and every slot keeps the
+/// offset and the size of its list, so that no memory is allocated per slot. A candidate is
+/// stored in 32 bits: the cache slot of the candidate and a flag telling if the pair is
+/// consistent.
+/// Lists can only shrink in place. Replacing a list appends the new list at the end of the array
+/// and leaves a gap, and compact() removes the gaps and releases the unused memory.
+// 增量识别器缓存槽的候选一致匹配存储：所有列表存储在一个数组中，每个槽记录偏移和大小，
+// 候选项以32位存储（候选缓存槽和一致性标志），compact()去除空隙并释放未使用的内存
+class CandidateListPool {
+ public:
+  /// \brief Type of the stored candidates.
+  typedef uint32_t Candidate;
+
+  /// \brief Maximum cache slot that can be stored in a candidate.
+  static constexpr size_t kMaxCacheSlot = (size_t(1u) << 31u) - 1u;
+
+  /// \brief Makes a candidate from its cache slot and its consistency flag.
+  static inline Candidate makeCandidate(const size_t cache_slot, const bool is_consistent) {
+    DCHECK_LE(cache_slot, kMaxCacheSlot);
+    return static_cast<Candidate>(cache_slot) | (is_consistent ? kConsistentBit : 0u);
+  }
+
+  /// \brief Gets the cache slot of a candidate.
+  static inline size_t getCacheSlot(const Candidate candidate) {
+    return candidate & ~kConsistentBit;
+  }
+
+  /// \brief Checks if a candidate is consistent with the match owning the list.
+  static inline bool isConsistent(const Candidate candidate) {
+    return (candidate & kConsistentBit) != 0u;
+  }
+
+  /// \brief Changes the number of lists. Added lists are empty and the storage of removed lists
+  /// becomes unused.
+  /// \param num_lists The new number of lists.
+  void resize(size_t num_lists);
+
+  /// \brief Removes all the lists. The storage is kept.
+  inline void clear() {
+    candidates_.clear();
+    lists_.clear();
+  }
+
+  /// \brief Gets the number of lists.
+  inline size_t getNumLists() const { return lists_.size(); }
+
+  /// \brief Gets the size of a list.
+  inline size_t getListSize(const size_t list) const { return lists_[list].size; }
+
+  /// \brief Gets the first candidate of a list. The candidates of the list are contiguous.
+  inline Candidate* getList(const size_t list) { return candidates_.data() + lists_[list].offset; }
+  inline const Candidate* getList(const size_t list) const {
+    return candidates_.data() + lists_[list].offset;
+  }
+
+  /// \brief Shrinks a list in place, keeping its first candidates. Different lists can be
+  /// shrunk concurrently.
+  /// \param list The list.
+  /// \param size The new size of the list, not bigger than the current size.
+  inline void truncateList(const size_t list, const size_t size) {
+    DCHECK_LE(size, lists_[list].size);
+    lists_[list].size = size;
+  }
+
+  /// \brief Replaces the candidates of a list. A list that is not bigger than the current one is
+  /// written in place. Otherwise the new candidates are appended at the end of the storage and the
+  /// previous storage of the list becomes unused.
+  /// \param list The list.
+  /// \param first Pointer to the first candidate.
+  /// \param last Pointer after the last candidate.
+  void assignList(size_t list, const Candidate* first, const Candidate* last);
+
+  /// \brief Gets the number of candidates stored in the lists.
+  size_t getNumLiveCandidates() const;
+
+  /// \brief Gets the number of candidates stored, including the unused ones.
+  inline size_t getNumStoredCandidates() const { return candidates_.size(); }
+
+  /// \brief Gets the memory allocated by the pool, in bytes.
+  inline size_t getMemoryBytes() const {
+    return candidates_.capacity() * sizeof(Candidate) + getListsMemoryBytes();
+  }
+
+  /// \brief Gets the memory allocated for the positions of the lists, in bytes. It does not
+  /// grow when compacting.
+  inline size_t getListsMemoryBytes() const { return lists_.capacity() * sizeof(ListRange); }
+
+  /// \brief Checks if more than half the storage is unused, in which case compacting is
+  /// worthwhile. Small pools are never considered fragmented.
+  bool isFragmented() const;
+
+  /// \brief Moves the lists next to each other, in list order, and releases the unused memory.
+  /// \param num_cache_slots Candidates whose cache slot is not smaller are removed from the
+  /// lists. This allows reducing the number of cache slots.
+  // 将列表依次紧密排列并释放未使用的内存，同时移除缓存槽不小于 num_cache_slots 的候选项
+  void compact(size_t num_cache_slots = std::numeric_limits<size_t>::max());
+
+ private:
+  static constexpr Candidate kConsistentBit = Candidate(1u) << 31u;
+  // Pools smaller than this number of candidates are not compacted.
+  static constexpr size_t kMinCandidatesForCompaction = 4096u;
+
+  // Position of a list in the storage.
+  struct ListRange {
+    size_t offset = 0u;
+    size_t size = 0u;
+  };
+
+  std::vector<Candidate> candidates_;
+  std::vector<ListRange> lists_;
+}; // class CandidateListPool
+
+} // namespace bron_kerbosch
+
+#endif // CANDIDATE_LIST_POOL_HPP_
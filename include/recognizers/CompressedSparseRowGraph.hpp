@@ -0,0 +1,331 @@
+#ifndef COMPRESSED_SPARSE_ROW_GRAPH_HPP_
+#define COMPRESSED_SPARSE_ROW_GRAPH_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/property_map/property_map.hpp>
+#include <glog/logging.h>
+
+namespace bron_kerbosch {
+
+/// \brief Immutable undirected graph stored in compressed sparse row format: the neighbors of all
+/// the vertices are stored in a single array, sorted by vertex and then by neighbor, and an array
+/// of offsets gives the range of the neighbors of each vertex. Compared to
+/// boost::adjacency_list<vecS, vecS, undirectedS>, there is no per-vertex container and no global
+/// edge list, so an edge takes two 32-bit words, and testing whether two vertices are adjacent is
+/// a binary search on the sorted neighbors.
+/// The graph models the Boost Graph Library VertexListGraph, IncidenceGraph, EdgeListGraph and
+/// AdjacencyMatrix concepts, so that it can be used with GraphUtilities.
+// 压缩稀疏行（CSR）格式存储的不可变无向图：所有顶点的邻居按顶点和邻居排序存储在一个数组中，
+// 偏移数组给出每个顶点的邻居范围。边的邻接测试为有序邻居上的二分查找
+class CompressedSparseRowGraph {
+ public:
+  /// \brief Type used for storing the neighbors.
+  typedef uint32_t StoredVertex;
+
+  // Types required by boost::graph_traits.
+  typedef size_t vertex_descriptor;
+  typedef size_t vertices_size_type;
+  typedef size_t edges_size_type;
+  typedef size_t degree_size_type;
+  typedef boost::undirected_tag directed_category;
+  typedef boost::allow_parallel_edge_tag edge_parallel_category;
+  struct traversal_category : public virtual boost::vertex_list_graph_tag,
+                              public virtual boost::incidence_graph_tag,
+                              public virtual boost::edge_list_graph_tag,
+                              public virtual boost::adjacency_matrix_tag { };
+
+  /// \brief Edge of the graph. For out-edges, the source is the vertex whose out-edges are
+  /// iterated.
+  struct edge_descriptor {
+    edge_descriptor() = default;
+    edge_descriptor(const size_t source, const size_t target) : source(source), target(target) { }
+    bool operator==(const edge_descriptor& other) const {
+      return source == other.source && target == other.target;
+    }
+    bool operator!=(const edge_descriptor& other) const { return !(*this == other); }
+    size_t source = 0u;
+    size_t target = 0u;
+  };
+
+  typedef boost::counting_iterator<size_t> vertex_iterator;
+
+  /// \brief Iterator on the out-edges of a vertex.
+  class out_edge_iterator : public boost::iterator_facade<
+      out_edge_iterator, edge_descriptor, std::random_access_iterator_tag, edge_descriptor> {
+   public:
+    out_edge_iterator() = default;
+    out_edge_iterator(const size_t source, const StoredVertex* neighbor)
+      : source_(source), neighbor_(neighbor) { }
+
+   private:
+    friend class boost::iterator_core_access;
+    edge_descriptor dereference() const { return edge_descriptor(source_, *neighbor_); }
+    bool equal(const out_edge_iterator& other) const { return neighbor_ == other.neighbor_; }
+    void increment() { ++neighbor_; }
+    void decrement() { --neighbor_; }
+    void advance(const std::ptrdiff_t n) { neighbor_ += n; }
+    std::ptrdiff_t distance_to(const out_edge_iterator& other) const {
+      return other.neighbor_ - neighbor_;
+    }
+
+    size_t source_ = 0u;
+    const StoredVertex* neighbor_ = nullptr;
+  };
+
+  /// \brief Iterator on the edges of the graph. Every undirected edge is visited once, from its
+  /// vertex with the smaller index.
+  class edge_iterator : public boost::iterator_facade<
+      edge_iterator, edge_descriptor, std::forward_iterator_tag, edge_descriptor> {
+   public:
+    edge_iterator() = default;
+    edge_iterator(const CompressedSparseRowGraph& graph, const size_t source)
+      : graph_(&graph), source_(source) {
+      if (source_ < graph_->getNumVertices()) {
+        position_ = graph_->getUpperNeighborsBegin(source_);
+        skipExhaustedVertices();
+      }
+    }
+
+   private:
+    friend class boost::iterator_core_access;
+    edge_descriptor dereference() const {
+      return edge_descriptor(source_, graph_->neighbors_[position_]);
+    }
+    bool equal(const edge_iterator& other) const {
+      return source_ == other.source_ && (source_ == graph_->getNumVertices() ||
+                                          position_ == other.position_);
+    }
+    void increment() {
+      ++position_;
+      skipExhaustedVertices();
+    }
+
+    // Moves to the first vertex that has neighbors with a bigger index left to visit.
+    void skipExhaustedVertices() {
+      while (position_ == graph_->offsets_[source_ + 1u]) {
+        if (++source_ == graph_->getNumVertices()) return;
+        position_ = graph_->getUpperNeighborsBegin(source_);
+      }
+    }
+
+    const CompressedSparseRowGraph* graph_ = nullptr;
+    size_t source_ = 0u;
+    size_t position_ = 0u;
+  };
+
+  /// \brief Initializes a new instance of the CompressedSparseRowGraph class.
+  /// \param num_vertices Number of vertices of the graph. The graph is initialized without edges.
+  explicit CompressedSparseRowGraph(const size_t num_vertices = 0u)
+    : offsets_(num_vertices + 1u, 0u) {
+    CHECK_LE(num_vertices, std::numeric_limits<StoredVertex>::max());
+  }
+
+  /// \brief Initializes a new instance of the CompressedSparseRowGraph class from a list of edges.
+  /// \param first Iterator to the first edge. Edges are pairs of vertex indices.
+  /// \param last Iterator after the last edge.
+  /// \param num_vertices Number of vertices of the graph.
+  template<typename EdgeIterator>
+  CompressedSparseRowGraph(const EdgeIterator first, const EdgeIterator last,
+                           const size_t num_vertices) {
+    assign(first, last, num_vertices);
+  }
+
+  /// \brief Replaces the graph with the graph defined by a list of edges. The graph is built in
+  /// two passes over the edges: the first counts the degree of every vertex and the second
+  /// writes the neighbors at the offsets given by the prefix sums of the degrees. Previously
+  /// allocated memory is reused when possible.
+  /// \param first Iterator to the first edge. Edges are pairs of vertex indices.
+  /// \param last Iterator after the last edge.
+  /// \param num_vertices Number of vertices of the graph.
+  // 由边列表两遍构建图：第一遍统计每个顶点的度，第二遍按度的前缀和偏移写入邻居
+  template<typename EdgeIterator>
+  void assign(const EdgeIterator first, const EdgeIterator last, const size_t num_vertices) {
+    CHECK_LE(num_vertices, std::numeric_limits<StoredVertex>::max());
+
+    // 1) Count the degree of every vertex and compute the offsets of the neighbors.
+    offsets_.assign(num_vertices + 1u, 0u);
+    size_t num_edges = 0u;
+    for (EdgeIterator it = first; it != last; ++it) {
+      DCHECK_LT(it->first, num_vertices);
+      DCHECK_LT(it->second, num_vertices);
+      ++offsets_[it->first + 1u];
+      ++offsets_[it->second + 1u];
+      ++num_edges;
+    }
+    for (size_t i = 0u; i < num_vertices; ++i) offsets_[i + 1u] += offsets_[i];
+    num_edges_ = num_edges;
+
+    // 2) Write the neighbors, using the offsets as insertion points.
+    neighbors_.resize(2u * num_edges);
+    for (EdgeIterator it = first; it != last; ++it) {
+      neighbors_[offsets_[it->first]++] = static_cast<StoredVertex>(it->second);
+      neighbors_[offsets_[it->second]++] = static_cast<StoredVertex>(it->first);
+    }
+
+    // The insertion points are now the offsets of the following vertices. Shift them back and
+    // sort the neighbors. Neighbors are already sorted when the edges are sorted.
+    for (size_t i = num_vertices; i > 0u; --i) offsets_[i] = offsets_[i - 1u];
+    offsets_[0] = 0u;
+    for (size_t i = 0u; i < num_vertices; ++i) {
+      StoredVertex* const begin = neighbors_.data() + offsets_[i];
+      StoredVertex* const end = neighbors_.data() + offsets_[i + 1u];
+      if (!std::is_sorted(begin, end)) std::sort(begin, end);
+    }
+  }
+
+  /// \brief Gets the number of vertices of the graph.
+  inline size_t getNumVertices() const { return offsets_.size() - 1u; }
+
+  /// \brief Gets the number of edges of the graph.
+  inline size_t getNumEdges() const { return num_edges_; }
+
+  /// \brief Gets the degree of a vertex.
+  inline size_t getDegree(const size_t vertex) const {
+    return offsets_[vertex + 1u] - offsets_[vertex];
+  }
+
+  /// \brief Gets the neighbors of a vertex, sorted in increasing order.
+  /// \returns Pair of pointers to the first neighbor and after the last neighbor.
+  inline std::pair<const StoredVertex*, const StoredVertex*> getNeighbors(
+      const size_t vertex) const {
+    return std::make_pair(neighbors_.data() + offsets_[vertex],
+                          neighbors_.data() + offsets_[vertex + 1u]);
+  }
+
+  /// \brief Checks if two vertices are adjacent. The neighbors of the vertex with the lower degree
+  /// are binary searched.
+  inline bool areAdjacent(const size_t first_vertex, const size_t second_vertex) const {
+    const bool search_first = getDegree(first_vertex) <= getDegree(second_vertex);
+    const auto neighbors = getNeighbors(search_first ? first_vertex : second_vertex);
+    const StoredVertex value = static_cast<StoredVertex>(search_first ? second_vertex :
+                                                                        first_vertex);
+
+    // Branchless binary search: the conditional move does not depend on branch prediction.
+    const StoredVertex* base = neighbors.first;
+    size_t length = neighbors.second - neighbors.first;
+    if (length == 0u) return false;
+    while (length > 1u) {
+      const size_t half = length / 2u;
+      base = base[half] <= value ? base + half : base;
+      length -= half;
+    }
+    return *base == value;
+  }
+
+  /// \brief Gets the null vertex, as required by boost::graph_traits.
+  static vertex_descriptor null_vertex() { return std::numeric_limits<size_t>::max(); }
+
+ private:
+  // Gets the position of the first neighbor of a vertex with a bigger index.
+  inline size_t getUpperNeighborsBegin(const size_t vertex) const {
+    const auto neighbors = getNeighbors(vertex);
+    return std::upper_bound(neighbors.first, neighbors.second,
+                            static_cast<StoredVertex>(vertex)) - neighbors_.data();
+  }
+
+  // Offsets of the neighbors of every vertex, plus the total number of neighbors.
+  std::vector<size_t> offsets_;
+  // Neighbors of all the vertices.
+  std::vector<StoredVertex> neighbors_;
+  size_t num_edges_ = 0u;
+}; // class CompressedSparseRowGraph
+
+// Boost Graph Library interface. The functions are found by argument-dependent lookup and are also
+// made visible in the boost namespace, since generic code calls them with qualified names.
+inline size_t num_vertices(const CompressedSparseRowGraph& graph) {
+  return graph.getNumVertices();
+}
+
+inline size_t num_edges(const CompressedSparseRowGraph& graph) {
+  return graph.getNumEdges();
+}
+
+inline std::pair<CompressedSparseRowGraph::vertex_iterator,
+                 CompressedSparseRowGraph::vertex_iterator>
+vertices(const CompressedSparseRowGraph& graph) {
+  typedef CompressedSparseRowGraph::vertex_iterator VertexIterator;
+  return std::make_pair(VertexIterator(0u), VertexIterator(graph.getNumVertices()));
+}
+
+inline std::pair<CompressedSparseRowGraph::out_edge_iterator,
+                 CompressedSparseRowGraph::out_edge_iterator>
+out_edges(const size_t vertex, const CompressedSparseRowGraph& graph) {
+  typedef CompressedSparseRowGraph::out_edge_iterator OutEdgeIterator;
+  const auto neighbors = graph.getNeighbors(vertex);
+  return std::make_pair(OutEdgeIterator(vertex, neighbors.first),
+                        OutEdgeIterator(vertex, neighbors.second));
+}
+
+inline size_t out_degree(const size_t vertex,
+                         const CompressedSparseRowGraph& graph) {
+  return graph.getDegree(vertex);
+}
+
+inline size_t degree(const size_t vertex, const CompressedSparseRowGraph& graph) {
+  return graph.getDegree(vertex);
+}
+
+inline std::pair<CompressedSparseRowGraph::edge_iterator,
+                 CompressedSparseRowGraph::edge_iterator>
+edges(const CompressedSparseRowGraph& graph) {
+  typedef CompressedSparseRowGraph::edge_iterator EdgeIterator;
+  return std::make_pair(EdgeIterator(graph, 0u), EdgeIterator(graph, graph.getNumVertices()));
+}
+
+inline size_t source(const CompressedSparseRowGraph::edge_descriptor& edge,
+                     const CompressedSparseRowGraph&) {
+  return edge.source;
+}
+
+inline size_t target(const CompressedSparseRowGraph::edge_descriptor& edge,
+                     const CompressedSparseRowGraph&) {
+  return edge.target;
+}
+
+inline std::pair<CompressedSparseRowGraph::edge_descriptor, bool> edge(
+    const size_t first_vertex, const size_t second_vertex,
+    const CompressedSparseRowGraph& graph) {
+  return std::make_pair(
+      CompressedSparseRowGraph::edge_descriptor(first_vertex, second_vertex),
+      graph.areAdjacent(first_vertex, second_vertex));
+}
+
+} // namespace bron_kerbosch
+
+namespace boost {
+
+template<>
+struct property_map<bron_kerbosch::CompressedSparseRowGraph, vertex_index_t> {
+  typedef typed_identity_property_map<size_t> type;
+  typedef type const_type;
+};
+
+inline typed_identity_property_map<size_t> get(vertex_index_t,
+                                               const bron_kerbosch::CompressedSparseRowGraph&) {
+  return typed_identity_property_map<size_t>();
+}
+
+using bron_kerbosch::num_vertices;
+using bron_kerbosch::num_edges;
+using bron_kerbosch::vertices;
+using bron_kerbosch::out_edges;
+using bron_kerbosch::out_degree;
+using bron_kerbosch::degree;
+using bron_kerbosch::edges;
+using bron_kerbosch::source;
+using bron_kerbosch::target;
+using bron_kerbosch::edge;
+
+} // namespace boost
+
+#endif // COMPRESSED_SPARSE_ROW_GRAPH_HPP_
@@ -1,12 +1,20 @@
 #ifndef SEGMATCH_GRAPH_BASED_GEOMETRIC_CONSISTENCY_RECOGNIZER_HPP_
 #define SEGMATCH_GRAPH_BASED_GEOMETRIC_CONSISTENCY_RECOGNIZER_HPP_
 
-#include <boost/graph/adjacency_list.hpp>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #include "parameter.h"
+#include "recognizers/CompressedSparseRowGraph.hpp"
 #include "recognizers/CorrespondenceRecognizer.hpp"
 #include "recognizers/GraphUtilities.hpp"
+#include "recognizers/SortedAdjacencyGraph.hpp"
 #include "RecognizerData.h"
+#include "WorkStealingThreadPool.h"
 #include <pcl/registration/icp.h>
 #include <pcl/common/transforms.h>
 
@@ -22,7 +30,7 @@ class GraphBasedGeometricConsistencyRecognizer : public CorrespondenceRecognizer
   /// \brief Initializes a new instance of the GraphBasedGeometricConsistencyRecognizer class.
   /// \param params The parameters of the geometry consistency grouping.
   explicit GraphBasedGeometricConsistencyRecognizer(
-      const GeometricConsistencyParams& params) noexcept;
+      const GeometricConsistencyParams& params);
 
   /// \brief Sets the current matches and tries to recognize the model.
   /// \param predicted_matches Vector of possible correspondences between model and scene.
@@ -30,6 +38,48 @@ class GraphBasedGeometricConsistencyRecognizer : public CorrespondenceRecognizer
   // 参数：场景与模型间的可能一致性
   void recognize(const PairwiseMatches& predicted_matches) override;
 
+  /// \brief State of a recognition between its two stages: the construction of the consistency
+  /// graph and the search of the cliques. Every stage only uses the state of the recognizer it
+  /// needs, so the graph of a recognition can be built while the cliques of the previous
+  /// recognition are searched. The storage is reused when the instance is reused.
+  // 识别两个阶段（构建一致性图与搜索团）之间的状态，使下一次识别的建图可与上一次的团搜索并行
+  struct PreparedRecognition {
+    /// \brief Number of the recognition, counted from 1 in the order of the calls to
+    /// prepareRecognition(). Decides which recognitions are stopped by cancelCliqueSearch().
+    size_t recognition_number = 0u;
+    /// \brief The matches passed to prepareRecognition(), which must outlive the recognition.
+    const PairwiseMatches* caller_matches = nullptr;
+    /// \brief The matches in Morton order and their indices in caller_matches, if enabled.
+    PairwiseMatches morton_ordered_matches;
+    std::vector<size_t> morton_order;
+    /// \brief The consistency graph, if the recognizer builds a new graph in every recognition.
+    CompressedSparseRowGraph consistency_graph;
+    /// \brief The persistent graph of the recognizer, if the cliques are searched on it. The
+    /// persistent graph is modified by prepareRecognition(), so the next recognition can only be
+    /// prepared once this one is completed.
+    const SortedAdjacencyGraph* persistent_graph = nullptr;
+    /// \brief Matches represented by the vertices of the persistent graph.
+    std::vector<size_t> persistent_graph_vertex_matches;
+  };
+
+  /// \brief Performs the first stage of a recognition: builds the consistency graph of the
+  /// matches, or updates the persistent graph. recognize() is equivalent to
+  /// prepareRecognition() followed by completeRecognition(). Recognitions must be prepared and
+  /// completed in the same order.
+  /// \param predicted_matches Vector of possible correspondences between model and scene. It is
+  /// referenced by \c prepared and must not be modified until the recognition is completed.
+  /// \param prepared The state of the recognition.
+  // 识别的第一阶段：构建匹配的一致性图（或更新持久图）
+  void prepareRecognition(const PairwiseMatches& predicted_matches,
+                          PreparedRecognition& prepared);
+
+  /// \brief Performs the second stage of a recognition: searches the cliques of the prepared
+  /// graph and estimates the candidate transformations. Can run concurrently with the
+  /// preparation of the next recognition, unless the persistent graph is used.
+  /// \param prepared The state of the recognition, filled by prepareRecognition().
+  // 识别的第二阶段：在准备好的图中搜索团并估计候选变换，可与下一次识别的准备并行
+  virtual void completeRecognition(const PreparedRecognition& prepared);
+
   /// \brief Gets the candidate transformations between model and scene.
   /// \returns Vector containing the candidate transformations. Transformations are sorted in
   /// decreasing recognition quality order. If empty, the model was not recognized.
@@ -50,9 +100,35 @@ class GraphBasedGeometricConsistencyRecognizer : public CorrespondenceRecognizer
     return candidate_matches_;
   }
 
+  /// \brief Stops the clique searches of the recognitions in progress, i.e. of the recognitions
+  /// whose preparation started before the call and which are not completed yet. A recognition
+  /// cancelled while its graph is built stops its clique search as soon as it starts. The
+  /// cancelled recognitions complete using the best clique found so far, and the recognitions
+  /// prepared after the call are not affected. Can be called from any thread.
+  // 停止正在进行的识别（调用前已开始准备且尚未完成的识别）的团搜索，使用目前找到的最好结果完成识别。
+  // 之后准备的识别不受影响。可从任意线程调用
+  void cancelCliqueSearch();
+
+  /// \brief Checks if the cliques found in the last recognition are proven to be optimal.
+  /// \returns False if the clique search was stopped because its budget was exhausted or because
+  /// it was cancelled.
+  bool isLastCliqueSearchOptimal() const { return last_clique_search_optimal_; }
+
+  /// \brief Function computing the weight of a match for the "MaximumWeight" clique search.
+  /// Weights must be non-negative.
+  typedef std::function<double(const PairwiseMatch& match)> MatchWeightFunction;
+
+  /// \brief Sets the function computing the weights of the matches used by the "MaximumWeight"
+  /// clique search. By default the weight of a match is its confidence.
+  /// \param match_weight_function The weight function. If empty, the default is restored.
+  // 设置最大权团搜索使用的匹配权重函数，默认使用匹配的置信度
+  void setMatchWeightFunction(MatchWeightFunction match_weight_function) {
+    match_weight_function_ = std::move(match_weight_function);
+  }
+
  protected:
   // Data types for the consistency graph.
-  typedef boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS> ConsistencyGraph;
+  typedef CompressedSparseRowGraph ConsistencyGraph;
 
   /// \brief Builds a consistency graph of the provided matches.
   /// \param predicted_matches Vector of possible correspondences between model and scene.
@@ -64,10 +140,96 @@ class GraphBasedGeometricConsistencyRecognizer : public CorrespondenceRecognizer
   // 实现在incremental
   virtual ConsistencyGraph buildConsistencyGraph(const PairwiseMatches& predicted_matches) = 0;
 
+  // Type of a consistency graph kept and updated across recognitions. Vertices can be added and
+  // edges can be added and removed without rebuilding the graph.
+  typedef SortedAdjacencyGraph PersistentConsistencyGraph;
+
+  /// \brief Updates the consistency graph kept across recognitions, for recognizers that
+  /// maintain one. In that case buildConsistencyGraph() is not called and the cliques are
+  /// searched directly on the persistent graph. The default implementation returns null.
+  /// \param predicted_matches Vector of possible correspondences between model and scene.
+  /// \param vertex_match_indices Vector in which the index of the match represented by every
+  /// vertex of the graph will be stored. Vertices that do not represent any match are isolated
+  /// and get the value \c kNoMatch.
+  /// \returns Pointer to the updated graph, or null if the recognizer builds a new consistency
+  /// graph in every recognition.
+  // 更新跨帧保留的一致性图，默认返回空指针（每次识别都构建新的一致性图）
+  virtual const PersistentConsistencyGraph* updatePersistentConsistencyGraph(
+      const PairwiseMatches& predicted_matches, std::vector<size_t>& vertex_match_indices) {
+    return nullptr;
+  }
+
+  /// \brief Value of \c vertex_match_indices for vertices that do not represent any match.
+  static constexpr size_t kNoMatch = std::numeric_limits<size_t>::max();
+
+  /// \brief Function checking if two matches, given by their indices, are consistent.
+  typedef std::function<bool(size_t match_index_1, size_t match_index_2)> ConsistencyTest;
+
+  /// \brief Gets a clique of the consistency graph that is used as initial lower bound of the
+  /// maximum clique search: only bigger cliques are searched, and if none exists the clique is
+  /// returned as cluster. The default implementation returns an empty clique.
+  /// \param predicted_matches Vector of possible correspondences between model and scene.
+  /// \param are_consistent Function checking if two matches are connected in the consistency
+  /// graph.
+  /// \returns Vector containing the indices of the matches forming the clique.
+  // 获取一致性图中的一个团作为最大团搜索的初始下界，默认返回空团
+  virtual std::vector<size_t> getWarmStartClique(const PairwiseMatches& predicted_matches,
+                                                 const ConsistencyTest& are_consistent) {
+    return std::vector<size_t>();
+  }
+
   // The parameters of the geometry consistency grouping.
   GeometricConsistencyParams params_;
 
  private:
+  // Algorithms available for finding the maximum clique.
+  enum class CliqueSearchStrategy { kDegeneracy, kBitset, kColoring, kMaximumWeight, kHeuristic };
+
+  // Find the clusters in the consistency graph of the matches. Vertex i of the graph represents
+  // match predicted_matches[i], or match predicted_matches[(*vertex_match_indices)[i]] if
+  // vertex_match_indices is not null. The candidate clusters contain matches of caller_matches,
+  // which are the matches passed to prepareRecognition().
+  // If morton_order is not null, predicted_matches[i] is caller_matches[(*morton_order)[i]].
+  template <typename Graph>
+  void recognizeWithGraph(const PairwiseMatches& caller_matches,
+                          const PairwiseMatches& predicted_matches, const Graph& consistency_graph,
+                          const std::vector<size_t>* vertex_match_indices,
+                          const std::vector<size_t>* morton_order);
+
+  // Clears the results of the previous recognition and sets the clique search state of the
+  // prepared recognition.
+  void startRecognition(const PreparedRecognition& prepared);
+
+  // Compute the weights of the matches if needed and find the cliques of the graph searched for
+  // cliques. get_match_index(i) gives the index of the match represented by vertex i.
+  template <typename Graph, typename GetMatchIndex>
+  std::vector<std::vector<size_t>> findCliquesWithWeights(const PairwiseMatches& predicted_matches,
+                                                          const Graph& search_graph,
+                                                          size_t min_clique_size,
+                                                          const GetMatchIndex& get_match_index);
+
+  // Find the cliques of the consistency graph that are returned as candidate clusters, sorted in
+  // decreasing size order.
+  template <typename Graph>
+  std::vector<std::vector<size_t>> findCliques(const Graph& consistency_graph,
+                                               size_t min_clique_size);
+
+  // Find the maximum clique in the consistency graph using the selected strategy.
+  template <typename Graph>
+  std::vector<size_t> findMaximumClique(const Graph& consistency_graph, size_t min_clique_size);
+
+  // Reduce the consistency graph to the k-core that can contain cliques of the minimum size, which
+  // is stored in reduced_graph_. Vertex i of the reduced graph represents vertex
+  // reduced_graph_matches_[i] of the consistency graph.
+  template <typename Graph>
+  void reduceToKCore(const Graph& consistency_graph, size_t min_clique_size);
+
+  // Renumber the vertices of the consistency graph in degeneracy order and store the result in
+  // relabeled_graph_. Vertex i of the relabeled graph represents vertex
+  // relabeled_graph_vertices_[i] of the consistency graph.
+  template <typename Graph>
+  void relabelInDegeneracyOrder(const Graph& consistency_graph);
+
   // Estimate 3D transform between model and scene.
   Eigen::Matrix4f estimateRigidTransformation(const PairwiseMatches& true_matches);
 
@@ -75,6 +237,44 @@ class GraphBasedGeometricConsistencyRecognizer : public CorrespondenceRecognizer
   std::vector<Eigen::Matrix4f, Eigen::aligned_allocator<Eigen::Matrix4f>>
   candidate_transfomations_;
   std::vector<PairwiseMatches> candidate_matches_;
+
+  // The algorithm used for finding the maximum clique.
+  CliqueSearchStrategy clique_search_strategy_;
+
+  // Thread pool used for the parallel clique search. Null if the search is sequential.
+  std::unique_ptr<WorkStealingThreadPool> clique_search_thread_pool_;
+
+  // Budget and cancellation state of the clique search. The cancellation flag is set for the
+  // completed recognition if its number is not greater than last_cancelled_recognition_. The
+  // numbers and the flag are protected by cancellation_mutex_, so that a cancellation of the
+  // previous recognitions does not set the flag of a recognition prepared after it.
+  CliqueSearchBudget clique_search_budget_;
+  std::atomic<bool> clique_search_cancelled_;
+  bool last_clique_search_optimal_ = true;
+  std::mutex cancellation_mutex_;
+  size_t num_prepared_recognitions_ = 0u;
+  size_t last_cancelled_recognition_ = 0u;
+
+  // Memory used by the clique search, reused across recognitions.
+  CliqueSearchWorkspace clique_search_workspace_;
+
+  // Weights of the matches for the maximum weight clique search.
+  MatchWeightFunction match_weight_function_;
+  std::vector<double> match_weights_;
+
+  // Core numbers of the vertices of the consistency graph, the k-core of the consistency graph
+  // and the matches represented by its vertices. The storage is reused across recognitions.
+  std::vector<size_t> core_numbers_;
+  ConsistencyGraph reduced_graph_;
+  std::vector<size_t> reduced_graph_matches_;
+
+  // The graph searched for cliques relabeled in degeneracy order and its vertices. The storage is
+  // reused across recognitions.
+  ConsistencyGraph relabeled_graph_;
+  std::vector<size_t> relabeled_graph_vertices_;
+
+  // State of the recognitions performed by recognize(), reused across recognitions.
+  PreparedRecognition prepared_recognition_;
 }; // class GraphBasedGeometricConsistencyRecognizer
 
 } // namespace segmatch
@@ -1,8 +1,18 @@
 #ifndef GRAPH_UTILITIES_HPP_
 #define GRAPH_UTILITIES_HPP_
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <iostream>
 #include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
 
 #include <boost/graph/connected_components.hpp>
 #include <boost/graph/filtered_graph.hpp>
@@ -10,8 +20,90 @@
 #include <boost/graph/graphviz.hpp>
 #include <glog/logging.h>
 
+#include "recognizers/BitsetAdjacencyMatrix.hpp"
+#include "recognizers/CompressedSparseRowGraph.hpp"
+#include "recognizers/SortedAdjacencyGraph.hpp"
+#include "WorkStealingThreadPool.h"
+
 namespace bron_kerbosch {
 
+/// \brief Statistics collected during a maximum clique search.
+struct CliqueSearchStatistics {
+  /// \brief Number of nodes of the search tree that have been expanded.
+  size_t num_expanded_nodes = 0u;
+  /// \brief True if the search completed, i.e. the returned result is proven to be optimal.
+  /// False if the search was stopped because of its budget or because it was cancelled.
+  bool optimality_proven = true;
+};
+
+/// \brief Limits on the resources that a clique search can use. When a limit is reached the
+/// search stops and returns the best result found so far. Limits are checked periodically, so
+/// they can be exceeded by a small number of nodes.
+// 团搜索可使用的资源上限，达到上限时停止搜索并返回目前最好的结果
+struct CliqueSearchBudget {
+  typedef std::chrono::steady_clock Clock;
+  /// \brief Time point at which the search must stop.
+  Clock::time_point deadline = Clock::time_point::max();
+  /// \brief Maximum number of nodes of the search tree that can be expanded.
+  size_t max_expanded_nodes = std::numeric_limits<size_t>::max();
+  /// \brief If not null, the search stops as soon as the flag is set. The flag can be set from
+  /// another thread.
+  const std::atomic<bool>* cancellation_flag = nullptr;
+};
+
+/// \brief Memory used by the clique searches of GraphUtilities. When the same workspace is passed
+/// to consecutive searches the buffers allocated by the previous searches are reused, so that once
+/// they have grown to the size needed by the graphs the searches do not allocate memory. A
+/// workspace must not be used by multiple searches at the same time.
+// 团搜索使用的内存。连续的搜索使用同一个工作空间时复用之前分配的缓冲区，缓冲区足够大后搜索不再分配内存
+class CliqueSearchWorkspace {
+ private:
+  friend class GraphUtilities;
+
+  // Buffers of a worker of the parallel search.
+  struct WorkerBuffers {
+    std::vector<size_t> candidate_stack;
+    std::vector<size_t> clique;
+  };
+
+  // Vertex ordering.
+  std::vector<size_t> bin_sizes_;
+  std::vector<size_t> bin_starts_;
+  std::vector<size_t> sorted_vertices_;
+  std::vector<size_t> vertex_positions_;
+  std::vector<size_t> vertex_degrees_;
+
+  // Candidate sets of all the levels of the recursion, stored one after the other, and the
+  // vertices of the clique being expanded.
+  std::vector<size_t> candidate_stack_;
+  std::vector<size_t> clique_;
+  std::vector<WorkerBuffers> worker_buffers_;
+
+  // Buffers of the searches on bitsets.
+  BitsetAdjacencyMatrix adjacency_matrix_;
+  std::vector<BitsetAdjacencyMatrix::Word> bitset_stack_;
+  std::vector<BitsetAdjacencyMatrix::Word> uncolored_;
+  std::vector<BitsetAdjacencyMatrix::Word> color_class_;
+  std::vector<size_t> colored_vertices_;
+  std::vector<size_t> vertex_colors_;
+
+  // Buffers of the maximum weight clique search.
+  std::vector<double> vertex_weights_;
+  std::vector<double> vertex_bounds_;
+
+  // Buffers of the construction of induced subgraphs.
+  std::vector<size_t> subgraph_vertices_;
+  std::vector<std::pair<size_t, size_t>> subgraph_edges_;
+
+  // Buffers of the heuristic clique search.
+  std::vector<size_t> vertex_marks_;
+  std::vector<size_t> clique_positions_;
+  std::vector<size_t> adjacent_clique_vertices_;
+  std::vector<size_t> tabu_expirations_;
+  std::vector<size_t> add_candidates_;
+  std::vector<size_t> swap_candidates_;
+}; // class CliqueSearchWorkspace
+
 /// \brief Provide generic graph utility functions.
 class GraphUtilities {
  public:
@@ -46,15 +138,21 @@ class GraphUtilities {
   /// must support random access.
   /// \param min_clique_size The minimum size of the maximum clique, smaller cliques will be
   /// ignored. Must be greater or equal 2.
+  /// \param statistics If not null, statistics about the search are stored here.
+  /// \param budget If not null, limits on the resources that the search can use. If the search
+  /// is stopped the biggest clique found so far is returned.
+  /// \param workspace If not null, the memory used by the search is taken from the workspace.
   /// \returns Vector containing the vertices belonging to a maximum clique. If the vector is
   /// empty, no clique with the specified minimum size exists.
   // 找到数据最大集团图的顶点，只返回最大集团
   // 提取算法遵循论文中的描述：对算法进行了改进，使顶点访问的简并度增加，将搜索深度限制到图的简并度
-  // 参数：输入图，数据结构支持随机存取  最小集团规模，更小的忽略，大于等于2  
+  // 参数：输入图，数据结构支持随机存取  最小集团规模，更小的忽略，大于等于2
   // 返回：最大集团的顶点
   template<typename Graph>
   static std::vector<typename boost::graph_traits<Graph>::vertex_descriptor> findMaximumClique(
-      const Graph& graph, const size_t min_clique_size) {
+      const Graph& graph, const size_t min_clique_size,
+      CliqueSearchStatistics* statistics = nullptr, const CliqueSearchBudget* budget = nullptr,
+      CliqueSearchWorkspace* workspace = nullptr) {
     // Ensure that the graph type is supported and define type shortcuts.
     CHECK(min_clique_size >= 2);
 	// 静态验证 图是无向的 数据结构允许随机访问
@@ -62,22 +160,28 @@ class GraphUtilities {
     typedef boost::graph_traits<Graph> GraphTraits;
     typedef typename GraphTraits::vertex_descriptor Vertex;
 
-    const size_t n_vertices = boost::num_vertices(graph);
-    std::vector<Vertex> neighbors;
-    neighbors.reserve(n_vertices);
+    CliqueSearchWorkspace local_workspace;
+    CliqueSearchWorkspace& ws = workspace != nullptr ? *workspace : local_workspace;
 
-    std::vector<Vertex> maximum_clique_tmp;
+    const size_t n_vertices = boost::num_vertices(graph);
+    std::vector<Vertex>& maximum_clique_tmp = ws.clique_;
     std::vector<Vertex> maximum_clique;
+    maximum_clique_tmp.clear();
     maximum_clique_tmp.reserve(n_vertices);
     size_t max_found_size = min_clique_size - 1u;
+    SearchMonitor monitor(budget);
 
     // Use bin-sort to sort the vertex indices in increasing degree order.
 	// 用bin-sort对顶点索引按递增度排序
-    std::vector<size_t> bin_starts;
-    std::vector<Vertex> sorted_vertices;
-    std::vector<size_t> vertex_positions;
-    std::vector<size_t> vertex_degrees;
-    binSortVerticesByDegree(graph, bin_starts, sorted_vertices, vertex_positions, vertex_degrees);
+    const size_t maximum_degree = binSortVerticesByDegree(graph, ws);
+    std::vector<size_t>& bin_starts = ws.bin_starts_;
+    std::vector<Vertex>& sorted_vertices = ws.sorted_vertices_;
+    std::vector<size_t>& vertex_positions = ws.vertex_positions_;
+    std::vector<size_t>& vertex_degrees = ws.vertex_degrees_;
+
+    // The neighbors of the root vertex are the first subset on the candidate stack.
+    std::vector<Vertex>& candidate_stack = ws.candidate_stack_;
+    if (candidate_stack.size() < maximum_degree) candidate_stack.resize(maximum_degree);
 
     // Try to find a clique starting from each vertex.
 	// 从每个顶点寻找团
@@ -88,7 +192,7 @@ class GraphUtilities {
       // Skip the vertex if it doesn't have enough neighbors to be a maximum clique.
 	  // 如果度较小，直接跳过，不满足形成最大团要求
       if (vertex_degree >= max_found_size) {
-        neighbors.clear();
+        size_t n_neighbors = 0u;
 
         // Collect all the neighbors that have enough neighbors to be a maximum clique.
 		// 收集可成最大团的所有相邻元素
@@ -97,24 +201,24 @@ class GraphUtilities {
           const Vertex neighbor = boost::target(*e_it, graph);
           if(vertex_positions[neighbor] > vertex_positions[vertex] &&
               vertex_degrees[neighbor] >= max_found_size)
-            neighbors.push_back(neighbor);
+            candidate_stack[n_neighbors++] = neighbor;
         }
 
         // Get the size of the maximum clique contained in the subgraph defined by the current vertex
         // and its neighbors.
 		// 获取由当前顶点及其相邻点定义的子图的最大团尺寸
-		// 参数：图  相邻点  度  ~~  最小集团规模  ~~
-        const size_t new_found_size = findMaximumCliqueSubset(graph, neighbors, vertex_degrees, 1u,
-                                                              max_found_size, maximum_clique_tmp);
+		// 参数：图  工作空间  相邻点在栈中的范围  ~~  最小集团规模  ~~
+        const size_t new_found_size = findMaximumCliqueSubset(graph, ws, 0u, n_neighbors, 1u,
+                                                              max_found_size, monitor);
 
         // If a bigger clique is found, set it as the new maximum clique.
         if(new_found_size > max_found_size) {
           max_found_size = new_found_size;
           maximum_clique_tmp.push_back(vertex);
-          maximum_clique = std::move(maximum_clique_tmp);
-        } else {
-          maximum_clique_tmp.clear();
+          maximum_clique.assign(maximum_clique_tmp.begin(), maximum_clique_tmp.end());
         }
+        maximum_clique_tmp.clear();
+        if (monitor.isStopped()) break;
       }
 
       // Decrease the degree of neighbor vertices of higher degree. This is equivalent to removing
@@ -141,9 +245,938 @@ class GraphUtilities {
       }
     }
 
+    monitor.getStatistics(statistics);
+    return maximum_clique;
+  }
+
+  /// \brief Finds the vertices of a graph belonging to a maximum clique. Only one maximum clique
+  /// is returned.
+  /// Parallel version of findMaximumClique(). The degeneracy order is computed first, then the
+  /// searches rooted at each vertex are distributed on a thread pool. All workers prune against
+  /// a shared lower bound, so that a big clique found by one worker speeds up all the others.
+  /// The size of the returned clique is the same of findMaximumClique(), but when multiple
+  /// maximum cliques exist the returned one depends on the scheduling.
+  /// \param graph The input graph. The graph must be indirected and the underlying data structure
+  /// must support random access.
+  /// \param min_clique_size The minimum size of the maximum clique, smaller cliques will be
+  /// ignored. Must be greater or equal 2.
+  /// \param thread_pool The thread pool used for the search.
+  /// \param statistics If not null, statistics about the search are stored here.
+  /// \param budget If not null, limits on the resources that the search can use. If the search
+  /// is stopped the biggest clique found so far is returned.
+  /// \param workspace If not null, the memory used by the search is taken from the workspace.
+  /// \returns Vector containing the vertices belonging to a maximum clique. If the vector is
+  /// empty, no clique with the specified minimum size exists.
+  // findMaximumClique() 的并行版本：以各顶点为根的搜索分配到线程池，所有线程共享原子下界进行剪枝
+  template<typename Graph>
+  static std::vector<typename boost::graph_traits<Graph>::vertex_descriptor>
+  findMaximumCliqueParallel(const Graph& graph, const size_t min_clique_size,
+                            WorkStealingThreadPool& thread_pool,
+                            CliqueSearchStatistics* statistics = nullptr,
+                            const CliqueSearchBudget* budget = nullptr,
+                            CliqueSearchWorkspace* workspace = nullptr) {
+    // Ensure that the graph type is supported and define type shortcuts.
+    CHECK(min_clique_size >= 2);
+    assertIsUndirectedAndRandomAccessGraph(graph);
+    typedef boost::graph_traits<Graph> GraphTraits;
+    typedef typename GraphTraits::vertex_descriptor Vertex;
+
+    CliqueSearchWorkspace local_workspace;
+    CliqueSearchWorkspace& ws = workspace != nullptr ? *workspace : local_workspace;
+
+    // Sort the vertices in degeneracy order. This also gives the core numbers of the vertices.
+    computeDegeneracyOrdering(graph, ws);
+    const std::vector<Vertex>& sorted_vertices = ws.sorted_vertices_;
+    const std::vector<size_t>& vertex_positions = ws.vertex_positions_;
+    const std::vector<size_t>& core_numbers = ws.vertex_degrees_;
+
+    // Per-worker buffers.
+    std::vector<CliqueSearchWorkspace::WorkerBuffers>& worker_data = ws.worker_buffers_;
+    if (worker_data.size() < thread_pool.getNumThreads()) {
+      worker_data.resize(thread_pool.getNumThreads());
+    }
+
+    std::atomic<size_t> shared_max_found_size(min_clique_size - 1u);
+    std::atomic<size_t> num_expanded_nodes(0u);
+    std::atomic<bool> stopped(false);
+    std::mutex maximum_clique_mutex;
+    std::vector<Vertex> maximum_clique;
+
+    // Vertices with high core number are processed first, as they are the most likely to be part
+    // of big cliques.
+    const size_t n_vertices = sorted_vertices.size();
+    thread_pool.parallelFor(0u, n_vertices, [&](const size_t index, const size_t worker_index) {
+      const size_t position = n_vertices - 1u - index;
+      const Vertex vertex = sorted_vertices[position];
+      size_t max_found_size = shared_max_found_size.load(std::memory_order_relaxed);
+      if (core_numbers[vertex] < max_found_size || stopped.load(std::memory_order_relaxed)) return;
+
+      // Collect the neighbors following the vertex in degeneracy order that have a core number
+      // high enough to be part of a maximum clique.
+      CliqueSearchWorkspace::WorkerBuffers& data = worker_data[worker_index];
+      std::vector<Vertex>& candidate_stack = data.candidate_stack;
+      const size_t vertex_degree = boost::out_degree(vertex, graph);
+      if (candidate_stack.size() < vertex_degree) candidate_stack.resize(vertex_degree);
+      size_t n_neighbors = 0u;
+      typename GraphTraits::out_edge_iterator e_it, e_end;
+      for (boost::tie(e_it, e_end) = boost::out_edges(vertex, graph); e_it != e_end; ++e_it) {
+        const Vertex neighbor = boost::target(*e_it, graph);
+        if (vertex_positions[neighbor] > position && core_numbers[neighbor] >= max_found_size)
+          candidate_stack[n_neighbors++] = neighbor;
+      }
+      if (n_neighbors < max_found_size) return;
+
+      data.clique.assign(1u, vertex);
+      SearchMonitor monitor(budget, &num_expanded_nodes, &stopped);
+      findMaximumCliqueSubsetShared(graph, candidate_stack, 0u, n_neighbors, core_numbers,
+                                    data.clique, shared_max_found_size, maximum_clique_mutex,
+                                    maximum_clique, monitor);
+      monitor.flush();
+    });
+
+    if (statistics != nullptr) {
+      statistics->num_expanded_nodes = num_expanded_nodes;
+      statistics->optimality_proven = !stopped;
+    }
+    return maximum_clique;
+  }
+
+  /// \brief Finds the vertices of a graph belonging to a maximum clique. Only one maximum clique
+  /// is returned.
+  /// Uses the same degeneracy-ordered search of findMaximumClique(), but the graph is first
+  /// converted to a dense bitset adjacency matrix. Candidate sets are bitsets as well, so that
+  /// adjacency tests are replaced by word-parallel intersections and candidate counting by
+  /// population counts. Memory usage is quadratic in the number of vertices.
+  /// \param graph The input graph. The graph must be indirected and the underlying data structure
+  /// must support random access.
+  /// \param min_clique_size The minimum size of the maximum clique, smaller cliques will be
+  /// ignored. Must be greater or equal 2.
+  /// \param statistics If not null, statistics about the search are stored here.
+  /// \param budget If not null, limits on the resources that the search can use. If the search
+  /// is stopped the biggest clique found so far is returned.
+  /// \param workspace If not null, the memory used by the search is taken from the workspace.
+  /// \returns Vector containing the vertices belonging to a maximum clique. If the vector is
+  /// empty, no clique with the specified minimum size exists.
+  // 与 findMaximumClique() 相同的简并序搜索，但使用位集邻接矩阵：候选集合求交为按字与运算，计数为popcount
+  template<typename Graph>
+  static std::vector<typename boost::graph_traits<Graph>::vertex_descriptor>
+  findMaximumCliqueBitset(const Graph& graph, const size_t min_clique_size,
+                          CliqueSearchStatistics* statistics = nullptr,
+                          const CliqueSearchBudget* budget = nullptr,
+                          CliqueSearchWorkspace* workspace = nullptr) {
+    // Ensure that the graph type is supported and define type shortcuts.
+    CHECK(min_clique_size >= 2);
+    assertIsUndirectedAndRandomAccessGraph(graph);
+    typedef boost::graph_traits<Graph> GraphTraits;
+    typedef typename GraphTraits::vertex_descriptor Vertex;
+    typedef BitsetAdjacencyMatrix::Word Word;
+
+    std::vector<Vertex> maximum_clique;
+    if (boost::num_vertices(graph) == 0u) return maximum_clique;
+
+    CliqueSearchWorkspace local_workspace;
+    CliqueSearchWorkspace& ws = workspace != nullptr ? *workspace : local_workspace;
+
+    // Sort the vertices in degeneracy order. This also gives the core numbers of the vertices.
+    const size_t degeneracy = computeDegeneracyOrdering(graph, ws);
+    const std::vector<Vertex>& sorted_vertices = ws.sorted_vertices_;
+    const std::vector<size_t>& vertex_positions = ws.vertex_positions_;
+    const std::vector<size_t>& core_numbers = ws.vertex_degrees_;
+
+    BitsetAdjacencyMatrix& adjacency_matrix = ws.adjacency_matrix_;
+    adjacency_matrix.assignFromGraph(graph);
+    const size_t n_words = adjacency_matrix.getWordsPerRow();
+
+    // One candidate set for each level of the recursion. The depth of the search is limited by
+    // the degeneracy of the graph.
+    std::vector<Word>& candidate_sets = ws.bitset_stack_;
+    candidate_sets.resize((degeneracy + 2u) * n_words);
+    std::vector<Vertex>& clique = ws.clique_;
+    clique.reserve(degeneracy + 1u);
+    size_t max_found_size = min_clique_size - 1u;
+    SearchMonitor monitor(budget);
+
+    // Try to find a clique starting from each vertex.
+    for (size_t i = 0u; i < sorted_vertices.size() && !monitor.isStopped(); ++i) {
+      const Vertex vertex = sorted_vertices[i];
+      if (core_numbers[vertex] < max_found_size) continue;
+
+      // Collect the neighbors following the vertex in degeneracy order that have a core number
+      // high enough to be part of a maximum clique.
+      Word* candidates = candidate_sets.data();
+      std::fill(candidates, candidates + n_words, Word(0u));
+      size_t n_candidates = 0u;
+      typename GraphTraits::out_edge_iterator e_it, e_end;
+      for (boost::tie(e_it, e_end) = boost::out_edges(vertex, graph); e_it != e_end; ++e_it) {
+        const Vertex neighbor = boost::target(*e_it, graph);
+        if (vertex_positions[neighbor] > i && core_numbers[neighbor] >= max_found_size) {
+          BitsetAdjacencyMatrix::setBit(candidates, neighbor);
+          ++n_candidates;
+        }
+      }
+      if (n_candidates < max_found_size) continue;
+
+      clique.assign(1u, vertex);
+      expandCliqueBitset(adjacency_matrix, candidate_sets, 0u, n_candidates, n_words, clique,
+                         max_found_size, maximum_clique, monitor);
+    }
+
+    monitor.getStatistics(statistics);
+    return maximum_clique;
+  }
+
+  /// \brief Finds the vertices of a graph belonging to a maximum clique. Only one maximum clique
+  /// is returned.
+  /// Branch and bound search using greedy coloring as upper bound, following the MCQ / MCS
+  /// family of algorithms:
+  /// "An efficient branch-and-bound algorithm for finding a maximum clique", Tomita, Etsuji and
+  /// Seki, Tomokazu ( https://doi.org/10.1007/3-540-45066-1_22 )
+  /// The coloring is computed on bitsets as in "An exact bit-parallel algorithm for the maximum
+  /// clique problem", San Segundo, Pablo et al. ( https://doi.org/10.1016/j.cor.2010.07.019 ).
+  /// Vertices are numbered in reverse degeneracy order and candidates are branched on in
+  /// decreasing color order, so that subtrees whose color bound cannot beat the best clique found
+  /// are pruned. This is most effective on dense graphs.
+  /// \param graph The input graph. The graph must be indirected and the underlying data structure
+  /// must support random access.
+  /// \param min_clique_size The minimum size of the maximum clique, smaller cliques will be
+  /// ignored. Must be greater or equal 2.
+  /// \param statistics If not null, statistics about the search are stored here.
+  /// \param budget If not null, limits on the resources that the search can use. If the search
+  /// is stopped the biggest clique found so far is returned.
+  /// \param workspace If not null, the memory used by the search is taken from the workspace.
+  /// \returns Vector containing the vertices belonging to a maximum clique. If the vector is
+  /// empty, no clique with the specified minimum size exists.
+  // 基于贪心着色上界的分支定界最大团搜索（MCQ/MCS 风格），按颜色降序分支
+  template<typename Graph>
+  static std::vector<typename boost::graph_traits<Graph>::vertex_descriptor>
+  findMaximumCliqueColoring(const Graph& graph, const size_t min_clique_size,
+                            CliqueSearchStatistics* statistics = nullptr,
+                            const CliqueSearchBudget* budget = nullptr,
+                            CliqueSearchWorkspace* workspace = nullptr) {
+    // Ensure that the graph type is supported and define type shortcuts.
+    CHECK(min_clique_size >= 2);
+    assertIsUndirectedAndRandomAccessGraph(graph);
+    typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
+    typedef BitsetAdjacencyMatrix::Word Word;
+
+    std::vector<Vertex> maximum_clique;
+    const size_t n_vertices = boost::num_vertices(graph);
+    if (n_vertices == 0u) return maximum_clique;
+
+    CliqueSearchWorkspace local_workspace;
+    CliqueSearchWorkspace& ws = workspace != nullptr ? *workspace : local_workspace;
+
+    // Renumber the vertices in reverse degeneracy order: vertices of high core number come first
+    // and are colored first.
+    const size_t degeneracy = computeDegeneracyOrdering(graph, ws);
+    std::vector<Vertex>& sorted_vertices = ws.sorted_vertices_;
+    std::vector<size_t>& vertex_positions = ws.vertex_positions_;
+    const std::vector<size_t>& core_numbers = ws.vertex_degrees_;
+    std::reverse(sorted_vertices.begin(), sorted_vertices.end());
+    for (size_t i = 0u; i < n_vertices; ++i) vertex_positions[sorted_vertices[i]] = i;
+
+    BitsetAdjacencyMatrix& adjacency_matrix = ws.adjacency_matrix_;
+    adjacency_matrix.reset(n_vertices);
+    typename boost::graph_traits<Graph>::edge_iterator e_it, e_end;
+    for (boost::tie(e_it, e_end) = boost::edges(graph); e_it != e_end; ++e_it) {
+      adjacency_matrix.addEdge(vertex_positions[boost::source(*e_it, graph)],
+                               vertex_positions[boost::target(*e_it, graph)]);
+    }
+
+    ColoringSearchState state(ws, degeneracy, min_clique_size - 1u, budget);
+
+    // Only vertices with a high enough core number can belong to a maximum clique.
+    Word* candidates = state.candidate_sets.data();
+    std::fill(candidates, candidates + state.n_words, Word(0u));
+    size_t n_candidates = 0u;
+    for (size_t i = 0u; i < n_vertices; ++i) {
+      if (core_numbers[sorted_vertices[i]] >= state.max_found_size) {
+        BitsetAdjacencyMatrix::setBit(candidates, i);
+        ++n_candidates;
+      }
+    }
+    if (n_candidates > state.max_found_size) expandCliqueColoring(state, 0u);
+
+    // Map the clique back to the original vertex descriptors.
+    maximum_clique.reserve(state.maximum_clique.size());
+    for (const size_t position : state.maximum_clique) {
+      maximum_clique.push_back(sorted_vertices[position]);
+    }
+    state.monitor.getStatistics(statistics);
     return maximum_clique;
   }
 
+  /// \brief Finds the vertices of a graph belonging to a maximum weight clique, i.e. the clique
+  /// with at least \c min_clique_size vertices that maximizes the sum of the weights of its
+  /// vertices. Only one maximum weight clique is returned.
+  /// Branch and bound search on bitsets, like findMaximumCliqueColoring(). The upper bound is
+  /// the weighted coloring bound: every color class is an independent set and contributes at most
+  /// one vertex to a clique, so the weight of a clique is bounded by the sum of the maximum
+  /// weights of the color classes.
+  /// \param graph The input graph. The graph must be indirected and the underlying data structure
+  /// must support random access.
+  /// \param vertex_weights The weight of every vertex of the graph. Weights must be non-negative.
+  /// \param min_clique_size The minimum size of the clique, smaller cliques will be ignored. Must
+  /// be greater or equal 2.
+  /// \param statistics If not null, statistics about the search are stored here.
+  /// \param budget If not null, limits on the resources that the search can use. If the search
+  /// is stopped the heaviest clique found so far is returned.
+  /// \param workspace If not null, the memory used by the search is taken from the workspace.
+  /// \returns Vector containing the vertices belonging to a maximum weight clique. If the vector
+  /// is empty, no clique with the specified minimum size exists.
+  // 最大权团搜索：基于加权着色上界的分支定界，每个颜色类最多贡献其中权重最大的顶点
+  template<typename Graph>
+  static std::vector<typename boost::graph_traits<Graph>::vertex_descriptor>
+  findMaximumWeightClique(const Graph& graph, const std::vector<double>& vertex_weights,
+                          const size_t min_clique_size,
+                          CliqueSearchStatistics* statistics = nullptr,
+                          const CliqueSearchBudget* budget = nullptr,
+                          CliqueSearchWorkspace* workspace = nullptr) {
+    // Ensure that the graph type is supported and define type shortcuts.
+    CHECK(min_clique_size >= 2);
+    assertIsUndirectedAndRandomAccessGraph(graph);
+    typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
+    typedef BitsetAdjacencyMatrix::Word Word;
+
+    std::vector<Vertex> maximum_clique;
+    const size_t n_vertices = boost::num_vertices(graph);
+    CHECK_EQ(vertex_weights.size(), n_vertices);
+    if (n_vertices == 0u) return maximum_clique;
+
+    CliqueSearchWorkspace local_workspace;
+    CliqueSearchWorkspace& ws = workspace != nullptr ? *workspace : local_workspace;
+
+    // Renumber the vertices in reverse degeneracy order, as in findMaximumCliqueColoring().
+    const size_t degeneracy = computeDegeneracyOrdering(graph, ws);
+    std::vector<Vertex>& sorted_vertices = ws.sorted_vertices_;
+    std::vector<size_t>& vertex_positions = ws.vertex_positions_;
+    const std::vector<size_t>& core_numbers = ws.vertex_degrees_;
+    std::reverse(sorted_vertices.begin(), sorted_vertices.end());
+    for (size_t i = 0u; i < n_vertices; ++i) vertex_positions[sorted_vertices[i]] = i;
+
+    BitsetAdjacencyMatrix& adjacency_matrix = ws.adjacency_matrix_;
+    adjacency_matrix.reset(n_vertices);
+    typename boost::graph_traits<Graph>::edge_iterator e_it, e_end;
+    for (boost::tie(e_it, e_end) = boost::edges(graph); e_it != e_end; ++e_it) {
+      adjacency_matrix.addEdge(vertex_positions[boost::source(*e_it, graph)],
+                               vertex_positions[boost::target(*e_it, graph)]);
+    }
+
+    WeightedColoringSearchState state(ws, degeneracy, min_clique_size, budget);
+    for (size_t i = 0u; i < n_vertices; ++i) {
+      CHECK_GE(vertex_weights[sorted_vertices[i]], 0.0);
+      state.vertex_weights[i] = vertex_weights[sorted_vertices[i]];
+    }
+
+    // Only vertices with a high enough core number can belong to a clique of the minimum size.
+    Word* candidates = state.candidate_sets.data();
+    std::fill(candidates, candidates + state.n_words, Word(0u));
+    size_t n_candidates = 0u;
+    for (size_t i = 0u; i < n_vertices; ++i) {
+      if (core_numbers[sorted_vertices[i]] + 1u >= min_clique_size) {
+        BitsetAdjacencyMatrix::setBit(candidates, i);
+        ++n_candidates;
+      }
+    }
+    if (n_candidates >= min_clique_size) expandCliqueWeighted(state, 0u, 0.0);
+
+    // Map the clique back to the original vertex descriptors.
+    maximum_clique.reserve(state.maximum_clique.size());
+    for (const size_t position : state.maximum_clique) {
+      maximum_clique.push_back(sorted_vertices[position]);
+    }
+    state.monitor.getStatistics(statistics);
+    return maximum_clique;
+  }
+
+  /// \brief Finds the vertices of a graph belonging to a maximum clique. Only one maximum clique
+  /// is returned.
+  /// Version of findMaximumCliqueColoring() specialized for graphs with at most
+  /// \c kMaxNumVertices vertices. Adjacency rows and candidate sets are fixed-size arrays of
+  /// \c kMaxNumVertices / 64 words, so that all the set operations have a trip count known at
+  /// compile time and are fully unrolled. The candidate sets of the levels of the recursion are
+  /// stored in the workspace (in a temporary one if \c workspace is null), so that the recursion
+  /// only uses a few words of stack per level.
+  /// \param graph The input graph. The graph must be indirected, the underlying data structure
+  /// must support random access and the number of vertices must not exceed \c kMaxNumVertices.
+  /// \param min_clique_size The minimum size of the maximum clique, smaller cliques will be
+  /// ignored. Must be greater or equal 2.
+  /// \param statistics If not null, statistics about the search are stored here.
+  /// \param budget If not null, limits on the resources that the search can use. If the search
+  /// is stopped the biggest clique found so far is returned.
+  /// \param workspace If not null, the memory used by the search is taken from the workspace.
+  /// \returns Vector containing the vertices belonging to a maximum clique. If the vector is
+  /// empty, no clique with the specified minimum size exists.
+  // findMaximumCliqueColoring() 针对小图（最多 kMaxNumVertices 个顶点）的特化版本，位集为定长数组，集合运算完全展开
+  template<size_t kMaxNumVertices, typename Graph>
+  static std::vector<typename boost::graph_traits<Graph>::vertex_descriptor>
+  findMaximumCliqueFixedWidth(const Graph& graph, const size_t min_clique_size,
+                              CliqueSearchStatistics* statistics = nullptr,
+                              const CliqueSearchBudget* budget = nullptr,
+                              CliqueSearchWorkspace* workspace = nullptr) {
+    static_assert(kMaxNumVertices == 64u || kMaxNumVertices == 128u || kMaxNumVertices == 256u,
+                  "GraphUtilities::findMaximumCliqueFixedWidth supports only graphs with at most "
+                  "64, 128 or 256 vertices.");
+    // Ensure that the graph type is supported and define type shortcuts.
+    CHECK(min_clique_size >= 2);
+    assertIsUndirectedAndRandomAccessGraph(graph);
+    typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
+    typedef FixedWidthColoringSearch<kMaxNumVertices / BitsetAdjacencyMatrix::kBitsPerWord>
+        Search;
+
+    std::vector<Vertex> maximum_clique;
+    const size_t n_vertices = boost::num_vertices(graph);
+    CHECK_LE(n_vertices, kMaxNumVertices);
+    if (n_vertices == 0u) return maximum_clique;
+
+    CliqueSearchWorkspace local_workspace;
+    CliqueSearchWorkspace& ws = workspace != nullptr ? *workspace : local_workspace;
+
+    // Renumber the vertices in reverse degeneracy order, as in findMaximumCliqueColoring().
+    const size_t degeneracy = computeDegeneracyOrdering(graph, ws);
+    std::vector<Vertex>& sorted_vertices = ws.sorted_vertices_;
+    std::vector<size_t>& vertex_positions = ws.vertex_positions_;
+    const std::vector<size_t>& core_numbers = ws.vertex_degrees_;
+    std::reverse(sorted_vertices.begin(), sorted_vertices.end());
+    for (size_t i = 0u; i < n_vertices; ++i) vertex_positions[sorted_vertices[i]] = i;
+
+    Search search(ws, degeneracy, min_clique_size - 1u, budget);
+    typename boost::graph_traits<Graph>::edge_iterator e_it, e_end;
+    for (boost::tie(e_it, e_end) = boost::edges(graph); e_it != e_end; ++e_it) {
+      search.addEdge(vertex_positions[boost::source(*e_it, graph)],
+                     vertex_positions[boost::target(*e_it, graph)]);
+    }
+
+    // Only vertices with a high enough core number can belong to a maximum clique.
+    size_t n_candidates = 0u;
+    for (size_t i = 0u; i < n_vertices; ++i) {
+      if (core_numbers[sorted_vertices[i]] >= search.max_found_size) {
+        BitsetAdjacencyMatrix::setBit(search.getCandidates(0u), i);
+        ++n_candidates;
+      }
+    }
+    if (n_candidates > search.max_found_size) search.expand(0u);
+
+    // Map the clique back to the original vertex descriptors.
+    maximum_clique.reserve(search.maximum_clique_size);
+    for (size_t i = 0u; i < search.maximum_clique_size; ++i) {
+      maximum_clique.push_back(sorted_vertices[search.maximum_clique[i]]);
+    }
+    search.monitor.getStatistics(statistics);
+    return maximum_clique;
+  }
+
+  /// \brief Finds a big clique of a graph with a heuristic. The returned clique is not guaranteed
+  /// to be maximum, but it is usually close to it and it is found much faster than with the exact
+  /// searches, so it can be used as initial lower bound of an exact search or on its own on
+  /// graphs too big for an exact search.
+  /// A clique is first built greedily from every vertex in reverse degeneracy order, always adding
+  /// the candidate with the highest core number. The biggest clique is then improved with a local
+  /// search that adds vertices adjacent to the whole clique, swaps a clique vertex with a vertex
+  /// adjacent to all the others (plateau moves, with a tabu list preventing immediate reversal)
+  /// and, when neither move is possible, perturbs the clique by adding a random vertex and
+  /// removing its non-neighbors, as in:
+  /// "Dynamic Local Search for the Maximum Clique Problem", Pullan, Wayne and Hoos, Holger H.
+  /// ( https://doi.org/10.1613/jair.1815 )
+  /// \param graph The input graph. The graph must be indirected and the underlying data structure
+  /// must support random access.
+  /// \param min_clique_size The minimum size of the clique, smaller cliques will be ignored. Must
+  /// be greater or equal 2.
+  /// \param time_slice Maximum time spent in the local search. If zero, only the greedy
+  /// construction is performed.
+  /// \param statistics If not null, statistics about the search are stored here. Optimality is
+  /// proven only if the clique reaches the degeneracy bound, or if no clique of the minimum size
+  /// can exist.
+  /// \param budget If not null, limits on the resources that the search can use. The local search
+  /// ends at the deadline of the budget if it comes before the end of the time slice.
+  /// \param workspace If not null, the memory used by the search is taken from the workspace.
+  /// \returns Vector containing the vertices belonging to the clique. If the vector is empty, no
+  /// clique with the specified minimum size was found.
+  // 启发式团搜索：按简并序反向贪心构造团，再在时间片内进行局部搜索（加点、交换、扰动）改进
+  template<typename Graph>
+  static std::vector<typename boost::graph_traits<Graph>::vertex_descriptor> findCliqueHeuristic(
+      const Graph& graph, const size_t min_clique_size,
+      const CliqueSearchBudget::Clock::duration time_slice,
+      CliqueSearchStatistics* statistics = nullptr, const CliqueSearchBudget* budget = nullptr,
+      CliqueSearchWorkspace* workspace = nullptr) {
+    // Ensure that the graph type is supported and define type shortcuts.
+    CHECK(min_clique_size >= 2);
+    assertIsUndirectedAndRandomAccessGraph(graph);
+    typedef boost::graph_traits<Graph> GraphTraits;
+    typedef typename GraphTraits::vertex_descriptor Vertex;
+
+    CliqueSearchWorkspace local_workspace;
+    CliqueSearchWorkspace& ws = workspace != nullptr ? *workspace : local_workspace;
+
+    // A clique of size s is contained in the (s-1)-core, so the degeneracy bounds the size of the
+    // maximum clique.
+    const size_t n_vertices = boost::num_vertices(graph);
+    const size_t degeneracy = computeDegeneracyOrdering(graph, ws);
+    const size_t upper_bound = n_vertices == 0u ? 0u : degeneracy + 1u;
+    const std::vector<Vertex>& sorted_vertices = ws.sorted_vertices_;
+    const std::vector<size_t>& core_numbers = ws.vertex_degrees_;
+    std::vector<size_t>& vertex_marks = ws.vertex_marks_;
+    vertex_marks.assign(n_vertices, 0u);
+    size_t mark = 0u;
+
+    std::vector<Vertex> maximum_clique;
+    SearchMonitor construction_monitor(budget);
+
+    // 1) Greedy construction. Only vertices with core number at least the size of the best
+    // clique can belong to a bigger clique.
+    // 贪心构造：每次加入核数最大的候选顶点
+    std::vector<Vertex>& candidates = ws.candidate_stack_;
+    std::vector<Vertex>& clique = ws.clique_;
+    for (size_t i = n_vertices; i-- > 0u && maximum_clique.size() < upper_bound;) {
+      const Vertex vertex = sorted_vertices[i];
+      if (core_numbers[vertex] < maximum_clique.size()) continue;
+      if (!construction_monitor.expandNode()) break;
+
+      clique.assign(1u, vertex);
+      candidates.clear();
+      typename GraphTraits::out_edge_iterator e_it, e_end;
+      for (boost::tie(e_it, e_end) = boost::out_edges(vertex, graph); e_it != e_end; ++e_it) {
+        const Vertex neighbor = boost::target(*e_it, graph);
+        if (core_numbers[neighbor] >= maximum_clique.size()) candidates.push_back(neighbor);
+      }
+      while (!candidates.empty()) {
+        const Vertex next = *std::max_element(
+            candidates.begin(), candidates.end(),
+            [&](const Vertex a, const Vertex b) { return core_numbers[a] < core_numbers[b]; });
+        clique.push_back(next);
+
+        // Keep only the candidates adjacent to the added vertex.
+        ++mark;
+        for (boost::tie(e_it, e_end) = boost::out_edges(next, graph); e_it != e_end; ++e_it) {
+          vertex_marks[boost::target(*e_it, graph)] = mark;
+        }
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                        [&](const Vertex c) { return vertex_marks[c] != mark; }),
+                         candidates.end());
+      }
+      if (clique.size() > maximum_clique.size()) {
+        maximum_clique.assign(clique.begin(), clique.end());
+      }
+    }
+
+    // 2) Local search starting from the biggest clique, within the time slice.
+    // 局部搜索：在时间片内从最大的团出发改进
+    CliqueSearchBudget local_search_budget = budget != nullptr ? *budget : CliqueSearchBudget();
+    const CliqueSearchBudget::Clock::time_point now = CliqueSearchBudget::Clock::now();
+    if (time_slice < local_search_budget.deadline - now) {
+      local_search_budget.deadline = now + time_slice;
+    }
+    SearchMonitor local_search_monitor(&local_search_budget);
+    if (!construction_monitor.isStopped() &&
+        time_slice > CliqueSearchBudget::Clock::duration::zero() && !maximum_clique.empty() &&
+        maximum_clique.size() < upper_bound) {
+      LocalSearchState<Graph> state(graph, ws, mark);
+      for (const Vertex vertex : maximum_clique) state.addVertex(vertex);
+
+      // Vertices that can belong to a clique bigger than the best one are in a suffix of the
+      // degeneracy order, since core numbers do not decrease along it.
+      size_t eligible_begin = 0u;
+      const auto update_eligible_begin = [&]() {
+        while (eligible_begin < n_vertices &&
+               core_numbers[sorted_vertices[eligible_begin]] < maximum_clique.size()) {
+          ++eligible_begin;
+        }
+      };
+      update_eligible_begin();
+
+      std::mt19937 random_generator(kLocalSearchRandomSeed);
+      size_t step = 0u;
+      while (local_search_monitor.expandNode()) {
+        ++step;
+        state.collectMoves(maximum_clique.size(), step);
+        if (!state.add_candidates.empty()) {
+          // Add a random vertex adjacent to all the vertices of the clique.
+          state.addVertex(state.add_candidates[random_generator() % state.add_candidates.size()]);
+        } else if (!state.swap_candidates.empty()) {
+          // Swap a random vertex with the only vertex of the clique it is not adjacent to.
+          const Vertex vertex =
+              state.swap_candidates[random_generator() % state.swap_candidates.size()];
+          const Vertex removed_vertex = state.removeNonNeighbors(vertex);
+          state.tabu_expirations[removed_vertex] = step + kLocalSearchTabuTenure;
+          state.addVertex(vertex);
+        } else {
+          // Perturb the clique with a random vertex that could belong to a bigger clique.
+          if (eligible_begin == n_vertices) break;
+          const Vertex vertex = sorted_vertices[
+              eligible_begin + random_generator() % (n_vertices - eligible_begin)];
+          if (state.clique_positions[vertex] != LocalSearchState<Graph>::kNotInClique) {
+            state.clear();
+          } else {
+            state.removeNonNeighbors(vertex);
+          }
+          state.addVertex(vertex);
+        }
+
+        if (state.clique.size() > maximum_clique.size()) {
+          maximum_clique.assign(state.clique.begin(), state.clique.end());
+          if (maximum_clique.size() == upper_bound) break;
+          update_eligible_begin();
+        }
+      }
+    }
+
+    if (statistics != nullptr) {
+      construction_monitor.getStatistics(statistics);
+      CliqueSearchStatistics local_search_statistics;
+      local_search_monitor.getStatistics(&local_search_statistics);
+      statistics->num_expanded_nodes += local_search_statistics.num_expanded_nodes;
+      statistics->optimality_proven =
+          maximum_clique.size() == upper_bound || upper_bound < min_clique_size;
+    }
+    if (maximum_clique.size() < min_clique_size) maximum_clique.clear();
+    return maximum_clique;
+  }
+
+  /// \brief Finds the largest maximal cliques of a graph.
+  /// Enumerates maximal cliques with the Bron-Kerbosch algorithm with pivoting, with the outer
+  /// level visiting vertices in degeneracy order as described in:
+  /// "Listing All Maximal Cliques in Sparse Graphs in Near-Optimal Time", Eppstein, David and
+  /// Loeffler, Maarten and Strash, Darren ( https://arxiv.org/abs/1006.5440 )
+  /// Pivots are chosen as in Tomita et al. to maximize the number of excluded candidates. At most
+  /// \c max_num_cliques cliques are kept during the enumeration, and the size of the smallest of
+  /// them is used as a lower bound for pruning the rest of the search.
+  /// \param graph The input graph. The graph must be indirected and the underlying data structure
+  /// must support random access.
+  /// \param min_clique_size The minimum size of the cliques, smaller cliques will be ignored.
+  /// Must be greater or equal 2.
+  /// \param max_num_cliques Maximum number of cliques returned. If zero, all the maximal cliques
+  /// with at least \c min_clique_size vertices are returned.
+  /// \param statistics If not null, statistics about the search are stored here.
+  /// \param budget If not null, limits on the resources that the search can use. If the
+  /// enumeration is stopped the cliques found so far are returned.
+  /// \param workspace If not null, the memory used by the search is taken from the workspace.
+  /// \returns Vector containing the cliques, sorted in decreasing size order.
+  // 用带枢轴的 Bron-Kerbosch 算法（外层按简并序）枚举极大团，返回最大的 max_num_cliques 个团
+  template<typename Graph>
+  static std::vector<std::vector<typename boost::graph_traits<Graph>::vertex_descriptor>>
+  findLargestMaximalCliques(const Graph& graph, const size_t min_clique_size,
+                            const size_t max_num_cliques,
+                            CliqueSearchStatistics* statistics = nullptr,
+                            const CliqueSearchBudget* budget = nullptr,
+                            CliqueSearchWorkspace* workspace = nullptr) {
+    // Ensure that the graph type is supported and define type shortcuts.
+    CHECK(min_clique_size >= 2);
+    assertIsUndirectedAndRandomAccessGraph(graph);
+    typedef boost::graph_traits<Graph> GraphTraits;
+    typedef typename GraphTraits::vertex_descriptor Vertex;
+    typedef BitsetAdjacencyMatrix::Word Word;
+
+    const size_t n_vertices = boost::num_vertices(graph);
+    if (n_vertices == 0u) return std::vector<std::vector<Vertex>>();
+
+    CliqueSearchWorkspace local_workspace;
+    CliqueSearchWorkspace& ws = workspace != nullptr ? *workspace : local_workspace;
+
+    // Sort the vertices in degeneracy order. This also gives the core numbers of the vertices.
+    const size_t degeneracy = computeDegeneracyOrdering(graph, ws);
+    const std::vector<Vertex>& sorted_vertices = ws.sorted_vertices_;
+    const std::vector<size_t>& vertex_positions = ws.vertex_positions_;
+    const std::vector<size_t>& core_numbers = ws.vertex_degrees_;
+
+    ws.adjacency_matrix_.assignFromGraph(graph);
+    CliqueEnumerationState state(ws, degeneracy, min_clique_size, max_num_cliques, budget);
+
+    for (size_t i = 0u; i < n_vertices && !state.monitor.isStopped(); ++i) {
+      const Vertex vertex = sorted_vertices[i];
+      if (core_numbers[vertex] + 1u < state.getMinReportedSize()) continue;
+
+      // Neighbors following the vertex in degeneracy order are candidates, the preceding ones
+      // have already been processed and are excluded.
+      Word* candidates = state.getCandidates(0u);
+      Word* excluded = state.getExcluded(0u);
+      std::fill(candidates, candidates + state.n_words, Word(0u));
+      std::fill(excluded, excluded + state.n_words, Word(0u));
+      typename GraphTraits::out_edge_iterator e_it, e_end;
+      for (boost::tie(e_it, e_end) = boost::out_edges(vertex, graph); e_it != e_end; ++e_it) {
+        const Vertex neighbor = boost::target(*e_it, graph);
+        if (vertex_positions[neighbor] > i) {
+          BitsetAdjacencyMatrix::setBit(candidates, neighbor);
+        } else {
+          BitsetAdjacencyMatrix::setBit(excluded, neighbor);
+        }
+      }
+
+      state.clique.assign(1u, vertex);
+      enumerateMaximalCliques(state, 0u);
+    }
+
+    // Sort the cliques in decreasing size order.
+    std::vector<std::vector<Vertex>> cliques = std::move(state.cliques);
+    std::sort(cliques.begin(), cliques.end(),
+              [](const std::vector<Vertex>& a, const std::vector<Vertex>& b) {
+      return a.size() > b.size();
+    });
+    state.monitor.getStatistics(statistics);
+    return cliques;
+  }
+
+  /// \brief Computes the core number of every vertex of a graph, i.e. the largest k such that the
+  /// vertex belongs to the k-core of the graph (the maximal subgraph in which every vertex has
+  /// degree at least k). Uses the linear time algorithm described in:
+  /// "An O(m) Algorithm for Cores Decomposition of Networks", Batagelj, Vladimir and Zaversnik,
+  /// Matjaz ( https://arxiv.org/abs/cs/0310049 )
+  /// \param graph The input graph. The graph must be indirected and the underlying data structure
+  /// must support random access.
+  /// \param core_numbers Vector in which the core numbers of the vertices will be stored.
+  /// \param workspace If not null, the memory used by the decomposition is taken from the
+  /// workspace.
+  /// \returns The degeneracy of the graph, i.e. the maximum core number.
+  // 计算每个顶点的核数（顶点所属的最大k核的k值），返回图的简并度
+  template<typename Graph>
+  static size_t computeCoreNumbers(const Graph& graph, std::vector<size_t>& core_numbers,
+                                   CliqueSearchWorkspace* workspace = nullptr) {
+    CliqueSearchWorkspace local_workspace;
+    CliqueSearchWorkspace& ws = workspace != nullptr ? *workspace : local_workspace;
+    const size_t degeneracy = computeDegeneracyOrdering(graph, ws);
+    core_numbers.assign(ws.vertex_degrees_.begin(), ws.vertex_degrees_.end());
+    return degeneracy;
+  }
+
+  /// \brief Computes a degeneracy order of the vertices of a graph, i.e. the order in which the
+  /// vertices are removed when a vertex of minimum degree is removed repeatedly. Every vertex has
+  /// at most degeneracy neighbors that come after it in the order, and core numbers do not
+  /// decrease along the order.
+  /// \param graph The input graph. The graph must be indirected and the underlying data structure
+  /// must support random access.
+  /// \param order Vector in which the vertices will be stored in degeneracy order.
+  /// \param workspace If not null, the memory used by the computation is taken from the
+  /// workspace.
+  /// \returns The degeneracy of the graph, i.e. the maximum core number.
+  // 计算顶点的简并序（反复移除度最小的顶点的顺序），返回图的简并度
+  template<typename Graph>
+  static size_t computeDegeneracyOrder(
+      const Graph& graph, std::vector<typename boost::graph_traits<Graph>::vertex_descriptor>& order,
+      CliqueSearchWorkspace* workspace = nullptr) {
+    CliqueSearchWorkspace local_workspace;
+    CliqueSearchWorkspace& ws = workspace != nullptr ? *workspace : local_workspace;
+    const size_t degeneracy = computeDegeneracyOrdering(graph, ws);
+    order.assign(ws.sorted_vertices_.begin(), ws.sorted_vertices_.end());
+    return degeneracy;
+  }
+
+  /// \brief Computes the core number of every vertex of a graph in parallel.
+  /// Vertices are peeled level by level: at level k all the remaining vertices of degree k are
+  /// removed in parallel, and the neighbors whose degree drops to k are removed in the next round
+  /// of the same level. The result is the same of computeCoreNumbers(), but the work is
+  /// distributed on a thread pool, which pays off on large graphs.
+  /// \param graph The input graph. The graph must be indirected and the underlying data structure
+  /// must support random access.
+  /// \param core_numbers Vector in which the core numbers of the vertices will be stored.
+  /// \param thread_pool The thread pool used for the decomposition.
+  /// \returns The degeneracy of the graph, i.e. the maximum core number.
+  // computeCoreNumbers() 的并行版本：逐层并行剥离度为k的顶点
+  template<typename Graph>
+  static size_t computeCoreNumbersParallel(const Graph& graph, std::vector<size_t>& core_numbers,
+                                           WorkStealingThreadPool& thread_pool) {
+    // Ensure that the graph type is supported and define type shortcuts.
+    assertIsUndirectedAndRandomAccessGraph(graph);
+    typedef boost::graph_traits<Graph> GraphTraits;
+    typedef typename GraphTraits::vertex_descriptor Vertex;
+
+    const size_t n_vertices = boost::num_vertices(graph);
+    core_numbers.assign(n_vertices, 0u);
+    if (n_vertices == 0u) return 0u;
+
+    // Vertices are processed in chunks, so that the tasks are not too small.
+    const size_t n_threads = thread_pool.getNumThreads();
+    const size_t chunk_size = std::max(size_t(256u), n_vertices / (8u * n_threads) + 1u);
+    const size_t n_chunks = (n_vertices + chunk_size - 1u) / chunk_size;
+
+    // Remaining degree of each vertex. A vertex is removed when its degree is the current level,
+    // after that its degree does not change.
+    std::unique_ptr<std::atomic<size_t>[]> degrees(new std::atomic<size_t>[n_vertices]);
+    std::vector<char> removed(n_vertices, 0);
+    std::vector<std::vector<Vertex>> worker_frontiers(n_threads);
+    std::vector<Vertex> frontier;
+
+    thread_pool.parallelFor(0u, n_chunks, [&](const size_t chunk, const size_t) {
+      const size_t end = std::min(n_vertices, (chunk + 1u) * chunk_size);
+      for (size_t v = chunk * chunk_size; v < end; ++v) {
+        degrees[v].store(boost::out_degree(v, graph), std::memory_order_relaxed);
+      }
+    });
+
+    // The vertices not removed yet. Every level only scans these vertices, and a vertex is
+    // scanned at most once per level not greater than its core number, so the scans cost
+    // O(n_vertices + n_edges) in total. Every chunk of the scan keeps its remaining vertices, its
+    // minimum degree and its vertices of that degree.
+    // 尚未移除的顶点。每层只扫描这些顶点，扫描总代价为O(顶点数+边数)
+    std::vector<Vertex> live_vertices(n_vertices);
+    for (size_t v = 0u; v < n_vertices; ++v) live_vertices[v] = v;
+    std::vector<std::vector<Vertex>> chunk_live_vertices(n_chunks);
+    std::vector<std::vector<Vertex>> chunk_min_degree_vertices(n_chunks);
+    std::vector<size_t> chunk_min_degrees(n_chunks);
+
+    size_t n_removed = 0u;
+    size_t level = 0u;
+    while (n_removed < n_vertices) {
+      // Drop the removed vertices and find the minimum degree of the remaining vertices. This is
+      // the next level. All the remaining vertices have a degree greater than the previous level.
+      const size_t n_live_chunks = (live_vertices.size() + chunk_size - 1u) / chunk_size;
+      thread_pool.parallelFor(0u, n_live_chunks, [&](const size_t chunk, const size_t) {
+        const size_t end = std::min(live_vertices.size(), (chunk + 1u) * chunk_size);
+        std::vector<Vertex>& chunk_live = chunk_live_vertices[chunk];
+        std::vector<Vertex>& chunk_min_degree = chunk_min_degree_vertices[chunk];
+        chunk_live.clear();
+        chunk_min_degree.clear();
+        size_t min_degree = std::numeric_limits<size_t>::max();
+        for (size_t i = chunk * chunk_size; i < end; ++i) {
+          const Vertex v = live_vertices[i];
+          if (removed[v]) continue;
+          chunk_live.push_back(v);
+          const size_t degree = degrees[v].load(std::memory_order_relaxed);
+          if (degree < min_degree) {
+            min_degree = degree;
+            chunk_min_degree.clear();
+          }
+          if (degree == min_degree) chunk_min_degree.push_back(v);
+        }
+        chunk_min_degrees[chunk] = min_degree;
+      });
+      level = *std::min_element(chunk_min_degrees.begin(),
+                                chunk_min_degrees.begin() + n_live_chunks);
+
+      // Collect the vertices of the level.
+      live_vertices.clear();
+      for (size_t chunk = 0u; chunk < n_live_chunks; ++chunk) {
+        live_vertices.insert(live_vertices.end(), chunk_live_vertices[chunk].begin(),
+                             chunk_live_vertices[chunk].end());
+        if (chunk_min_degrees[chunk] == level) {
+          worker_frontiers[0].insert(worker_frontiers[0].end(),
+                                     chunk_min_degree_vertices[chunk].begin(),
+                                     chunk_min_degree_vertices[chunk].end());
+        }
+      }
+
+      while (true) {
+        frontier.clear();
+        for (auto& worker_frontier : worker_frontiers) {
+          frontier.insert(frontier.end(), worker_frontier.begin(), worker_frontier.end());
+          worker_frontier.clear();
+        }
+        if (frontier.empty()) break;
+        for (const Vertex vertex : frontier) {
+          removed[vertex] = 1;
+          core_numbers[vertex] = level;
+        }
+        n_removed += frontier.size();
+
+        // Remove the frontier vertices. Neighbors whose degree drops to the level are removed in
+        // the next round. The decrement is undone if concurrent removals already brought the
+        // degree to the level.
+        const size_t n_frontier_chunks = (frontier.size() + chunk_size - 1u) / chunk_size;
+        thread_pool.parallelFor(0u, n_frontier_chunks,
+                                [&](const size_t chunk, const size_t worker_index) {
+          const size_t end = std::min(frontier.size(), (chunk + 1u) * chunk_size);
+          for (size_t i = chunk * chunk_size; i < end; ++i) {
+            typename GraphTraits::out_edge_iterator e_it, e_end;
+            for (boost::tie(e_it, e_end) = boost::out_edges(frontier[i], graph);
+                 e_it != e_end; ++e_it) {
+              const Vertex neighbor = boost::target(*e_it, graph);
+              if (degrees[neighbor].load(std::memory_order_relaxed) <= level) continue;
+              const size_t old_degree = degrees[neighbor].fetch_sub(1u);
+              if (old_degree == level + 1u) {
+                worker_frontiers[worker_index].push_back(neighbor);
+              } else if (old_degree <= level) {
+                degrees[neighbor].fetch_add(1u);
+              }
+            }
+          }
+        });
+      }
+    }
+    return level;
+  }
+
+  /// \brief Finds the vertices of the k-core of a graph, i.e. the vertices with core number
+  /// greater or equal k.
+  /// \param core_numbers The core numbers of the vertices of the graph, as computed by
+  /// computeCoreNumbers().
+  /// \param k The order of the core.
+  /// \returns Vector containing the vertices of the k-core, in increasing order.
+  // 返回k核的顶点，即核数不小于k的顶点
+  static std::vector<size_t> findKCore(const std::vector<size_t>& core_numbers, const size_t k) {
+    std::vector<size_t> k_core;
+    findKCore(core_numbers, k, k_core);
+    return k_core;
+  }
+
+  /// \brief Finds the vertices of the k-core of a graph, reusing the memory of the output vector.
+  /// \param core_numbers The core numbers of the vertices of the graph, as computed by
+  /// computeCoreNumbers().
+  /// \param k The order of the core.
+  /// \param k_core Vector in which the vertices of the k-core are stored, in increasing order.
+  static void findKCore(const std::vector<size_t>& core_numbers, const size_t k,
+                        std::vector<size_t>& k_core) {
+    k_core.clear();
+    for (size_t v = 0u; v < core_numbers.size(); ++v) {
+      if (core_numbers[v] >= k) k_core.push_back(v);
+    }
+  }
+
+  /// \brief Finds the vertices of the maximum k-core of a graph, i.e. the k-core with the largest
+  /// k that is not empty. A clique of size s is contained in the (s-1)-core, so the maximum
+  /// k-core bounds the size of the maximum clique to k + 1.
+  /// \param graph The input graph. The graph must be indirected and the underlying data structure
+  /// must support random access.
+  /// \param k If not null, the order of the maximum k-core (the degeneracy of the graph) is stored
+  /// here.
+  /// \returns Vector containing the vertices of the maximum k-core, in increasing order.
+  // 找到图的最大k核（k最大的非空k核）的顶点
+  template<typename Graph>
+  static std::vector<typename boost::graph_traits<Graph>::vertex_descriptor> findMaximumKCore(
+      const Graph& graph, size_t* k = nullptr) {
+    std::vector<size_t> core_numbers;
+    const size_t degeneracy = computeCoreNumbers(graph, core_numbers);
+    if (k != nullptr) *k = degeneracy;
+    return findKCore(core_numbers, degeneracy);
+  }
+
+  /// \brief Builds the subgraph induced by a subset of the vertices of a graph.
+  /// \param graph The input graph.
+  /// \param vertices The vertices of the subset, in any order. Vertex \c vertices[i] of the graph
+  /// is vertex \c i of the subgraph, so passing all the vertices relabels the graph.
+  /// \param subgraph The graph in which the induced subgraph is stored. The graph type can differ
+  /// from the type of the input graph and must be constructible from a range of edges and a
+  /// number of vertices. The memory of a CompressedSparseRowGraph is reused.
+  /// \param workspace If not null, the temporary buffers are taken from the workspace, so that
+  /// building subgraphs of similar sizes repeatedly does not allocate memory.
+  // 构建由顶点子集导出的子图，子图的顶点 i 对应原图的顶点 vertices[i]
+  template<typename Graph, typename Subgraph>
+  static void buildInducedSubgraph(
+      const Graph& graph,
+      const std::vector<typename boost::graph_traits<Graph>::vertex_descriptor>& vertices,
+      Subgraph& subgraph, CliqueSearchWorkspace* workspace = nullptr) {
+    // Ensure that the graph type is supported and define type shortcuts.
+    assertIsUndirectedAndRandomAccessGraph(graph);
+    typedef boost::graph_traits<Graph> GraphTraits;
+    const size_t kNotInSubset = std::numeric_limits<size_t>::max();
+
+    CliqueSearchWorkspace local_workspace;
+    CliqueSearchWorkspace& ws = workspace != nullptr ? *workspace : local_workspace;
+    std::vector<size_t>& subgraph_vertices = ws.subgraph_vertices_;
+    subgraph_vertices.assign(boost::num_vertices(graph), kNotInSubset);
+    for (size_t i = 0u; i < vertices.size(); ++i) subgraph_vertices[vertices[i]] = i;
+
+    // Collect the edges first, so that graphs that cannot be modified after construction can be
+    // built as well.
+    std::vector<std::pair<size_t, size_t>>& subgraph_edges = ws.subgraph_edges_;
+    subgraph_edges.clear();
+    for (size_t i = 0u; i < vertices.size(); ++i) {
+      typename GraphTraits::out_edge_iterator e_it, e_end;
+      for (boost::tie(e_it, e_end) = boost::out_edges(vertices[i], graph); e_it != e_end; ++e_it) {
+        const size_t neighbor = subgraph_vertices[boost::target(*e_it, graph)];
+        if (neighbor != kNotInSubset && neighbor > i) subgraph_edges.emplace_back(i, neighbor);
+      }
+    }
+    assignGraph(subgraph_edges.begin(), subgraph_edges.end(), vertices.size(), subgraph);
+  }
+
   /// \brief Finds the vertex degrees and the maximum vertex degree in the graph.
   /// \param graph The input graph. The graph must be indirected and the underlying data structure
   /// must support random access.
@@ -171,6 +1204,87 @@ class GraphUtilities {
   }
 
  private:
+  // Replaces a graph with the graph defined by a list of edges. The memory of a
+  // CompressedSparseRowGraph is reused, other graph types are constructed again.
+  template<typename EdgeIterator, typename Graph>
+  static void assignGraph(const EdgeIterator first, const EdgeIterator last,
+                          const size_t num_vertices, Graph& graph) {
+    graph = Graph(first, last, num_vertices);
+  }
+  template<typename EdgeIterator>
+  static void assignGraph(const EdgeIterator first, const EdgeIterator last,
+                          const size_t num_vertices, CompressedSparseRowGraph& graph) {
+    graph.assign(first, last, num_vertices);
+  }
+
+  // Keeps track of the nodes expanded by a search and decides when the search must stop because
+  // its budget is exhausted. Multiple monitors can share a node counter and a stop flag, e.g. when
+  // the search is distributed on multiple threads.
+  // 记录搜索扩展的节点数，并在预算耗尽时决定停止搜索
+  class SearchMonitor {
+   public:
+    explicit SearchMonitor(const CliqueSearchBudget* budget,
+                           std::atomic<size_t>* shared_expanded_nodes = nullptr,
+                           std::atomic<bool>* shared_stop_flag = nullptr)
+      : budget_(budget), shared_expanded_nodes_(shared_expanded_nodes),
+        shared_stop_flag_(shared_stop_flag) {
+    }
+
+    // Registers the expansion of a node. Returns false if the search must stop.
+    inline bool expandNode() {
+      ++num_expanded_nodes_;
+      if (stopped_) return false;
+      if (++nodes_since_check_ >= kNodesBetweenChecks || num_expanded_nodes_ == 1u) {
+        checkBudget();
+      }
+      return !stopped_;
+    }
+
+    // Returns true if the search must stop.
+    inline bool isStopped() const { return stopped_; }
+
+    // Adds the nodes expanded since the last check to the shared counter.
+    inline void flush() {
+      if (shared_expanded_nodes_ != nullptr) *shared_expanded_nodes_ += nodes_since_check_;
+      nodes_since_check_ = 0u;
+    }
+
+    // Stores the statistics of the search.
+    inline void getStatistics(CliqueSearchStatistics* statistics) const {
+      if (statistics == nullptr) return;
+      statistics->num_expanded_nodes = num_expanded_nodes_;
+      statistics->optimality_proven = !stopped_;
+    }
+
+   private:
+    static constexpr size_t kNodesBetweenChecks = 32u;
+
+    void checkBudget() {
+      size_t total_expanded_nodes = num_expanded_nodes_;
+      if (shared_expanded_nodes_ != nullptr) {
+        total_expanded_nodes = (*shared_expanded_nodes_ += nodes_since_check_);
+      }
+      nodes_since_check_ = 0u;
+      if (shared_stop_flag_ != nullptr && shared_stop_flag_->load(std::memory_order_relaxed)) {
+        stopped_ = true;
+      } else if (budget_ != nullptr &&
+          (total_expanded_nodes > budget_->max_expanded_nodes ||
+           (budget_->cancellation_flag != nullptr &&
+            budget_->cancellation_flag->load(std::memory_order_relaxed)) ||
+           CliqueSearchBudget::Clock::now() >= budget_->deadline)) {
+        stopped_ = true;
+        if (shared_stop_flag_ != nullptr) *shared_stop_flag_ = true;
+      }
+    }
+
+    const CliqueSearchBudget* budget_;
+    std::atomic<size_t>* shared_expanded_nodes_;
+    std::atomic<bool>* shared_stop_flag_;
+    size_t num_expanded_nodes_ = 0u;
+    size_t nodes_since_check_ = 0u;
+    bool stopped_ = false;
+  };
+
   // Statically verify that a graph is undirected and based on data structures that allow random
   // access.
   // 静态验证 图时无向的且数据结构允许随机访问
@@ -188,17 +1302,20 @@ class GraphUtilities {
                   "of type size_t (usually graphs based on random access containers).");
   }
 
-  // Sort the vertices of a graph in increasing vertex degree order using bin-sorting.
-  // 按顶点度递增的顺序，用bin-sort对顶点排序
+  // Sort the vertices of a graph in increasing vertex degree order using bin-sorting. The bins,
+  // the sorted vertices, the vertex positions and the vertex degrees are stored in the workspace.
+  // Returns the maximum vertex degree.
+  // 按顶点度递增的顺序，用bin-sort对顶点排序，结果存储在工作空间中
   template<typename Graph>
-  static size_t binSortVerticesByDegree(
-      const Graph& graph, std::vector<size_t>& bin_starts,
-      std::vector<typename boost::graph_traits<Graph>::vertex_descriptor>& sorted_vertices,
-      std::vector<size_t>& vertex_positions, std::vector<size_t>& vertex_degrees) {
+  static size_t binSortVerticesByDegree(const Graph& graph, CliqueSearchWorkspace& workspace) {
 
     // Ensure that the graph type is supported.
     assertIsUndirectedAndRandomAccessGraph(graph);
-    typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
+    std::vector<size_t>& bin_sizes = workspace.bin_sizes_;
+    std::vector<size_t>& bin_starts = workspace.bin_starts_;
+    std::vector<size_t>& sorted_vertices = workspace.sorted_vertices_;
+    std::vector<size_t>& vertex_positions = workspace.vertex_positions_;
+    std::vector<size_t>& vertex_degrees = workspace.vertex_degrees_;
 
     // Get and store the vertex degrees.
     size_t maximum_degree = getVertexDegreesAndGraphMaxDegree(graph, vertex_degrees);
@@ -206,7 +1323,7 @@ class GraphUtilities {
     // Use bin-sort to sort the vertex indices in increasing degree order.
     // 1) Find the size of each bin.
 	// 每个出入度对应的个数
-    std::vector<size_t> bin_sizes(maximum_degree + 1u);
+    bin_sizes.assign(maximum_degree + 1u, 0u);
     for (const auto degree : vertex_degrees) ++bin_sizes[degree];
 
     // 2) Find the starting index of each bin.
@@ -218,8 +1335,9 @@ class GraphUtilities {
       next_bin_start += bin_sizes[i];
     }
 
-    // 3) Sort vertex indices
-    std::vector<size_t> bin_offsets(bin_starts);
+    // 3) Sort vertex indices. The bin sizes are reused as insertion offsets of the bins.
+    std::vector<size_t>& bin_offsets = bin_sizes;
+    std::copy(bin_starts.begin(), bin_starts.end(), bin_offsets.begin());
     sorted_vertices.resize(boost::num_vertices(graph));
     vertex_positions.resize(boost::num_vertices(graph));
     typename boost::graph_traits<Graph>::vertex_iterator v_it, v_end;
@@ -227,68 +1345,885 @@ class GraphUtilities {
       vertex_positions[*v_it] = bin_offsets[vertex_degrees[*v_it]]++;
       sorted_vertices[vertex_positions[*v_it]] = *v_it;
     }
+    return maximum_degree;
+  }
+
+  // Sort the vertices of a graph in degeneracy order, i.e. repeatedly remove a vertex of minimum
+  // degree from the graph (Batagelj and Zaversnik, "An O(m) Algorithm for Cores Decomposition of
+  // Networks"). The order is stored in the workspace, and after the call the vertex degrees of
+  // the workspace contain the core number of each vertex. Returns the degeneracy of the graph
+  // (the maximum core number).
+  // 按简并序排序顶点：反复移除度最小的顶点。调用后工作空间中的顶点度为每个顶点的核数，返回图的简并度
+  template<typename Graph>
+  static size_t computeDegeneracyOrdering(const Graph& graph, CliqueSearchWorkspace& workspace) {
+    // Ensure that the graph type is supported and define type shortcuts.
+    assertIsUndirectedAndRandomAccessGraph(graph);
+    typedef boost::graph_traits<Graph> GraphTraits;
+    typedef typename GraphTraits::vertex_descriptor Vertex;
+
+    binSortVerticesByDegree(graph, workspace);
+    std::vector<size_t>& bin_starts = workspace.bin_starts_;
+    std::vector<Vertex>& sorted_vertices = workspace.sorted_vertices_;
+    std::vector<size_t>& vertex_positions = workspace.vertex_positions_;
+    std::vector<size_t>& vertex_degrees = workspace.vertex_degrees_;
+
+    size_t degeneracy = 0u;
+    for (size_t i = 0u; i < sorted_vertices.size(); ++i) {
+      const size_t vertex_degree = vertex_degrees[sorted_vertices[i]];
+      degeneracy = std::max(degeneracy, vertex_degree);
+
+      // Remove the vertex by decreasing the degree of its neighbors of higher degree.
+      typename GraphTraits::out_edge_iterator e_it, e_end;
+      for (boost::tie(e_it, e_end) = boost::out_edges(sorted_vertices[i], graph);
+           e_it != e_end; ++e_it) {
+        const Vertex neighbor = boost::target(*e_it, graph);
+        const size_t neighbor_degree = vertex_degrees[neighbor];
+        if (neighbor_degree > vertex_degree) {
+          const size_t neighbor_position = vertex_positions[neighbor];
+          const size_t swapped_neighbor_position = bin_starts[neighbor_degree];
+          const Vertex swapped_neighbor = sorted_vertices[swapped_neighbor_position];
+          if (neighbor != swapped_neighbor) {
+            vertex_positions[neighbor] = swapped_neighbor_position;
+            vertex_positions[swapped_neighbor] = neighbor_position;
+            sorted_vertices[neighbor_position] = swapped_neighbor;
+            sorted_vertices[swapped_neighbor_position] = neighbor;
+          }
+          ++bin_starts[neighbor_degree];
+          --vertex_degrees[neighbor];
+        }
+      }
+    }
+    return degeneracy;
+  }
+
+  // Helper recursive function for the findMaximumCliqueBitset() function. Expands the current
+  // clique with the candidates at level \c depth of \c candidate_sets. Only the first
+  // \c n_active_words words of the candidate set can contain bits.
+  // findMaximumCliqueBitset() 的辅助递归函数
+  static void expandCliqueBitset(const BitsetAdjacencyMatrix& adjacency_matrix,
+                                 std::vector<BitsetAdjacencyMatrix::Word>& candidate_sets,
+                                 const size_t depth, size_t n_candidates,
+                                 const size_t n_active_words, std::vector<size_t>& clique,
+                                 size_t& max_found_size, std::vector<size_t>& maximum_clique,
+                                 SearchMonitor& monitor) {
+    typedef BitsetAdjacencyMatrix::Word Word;
+    const bool can_expand = monitor.expandNode();
+
+    // Final step of the recursion: if there are no more candidates, the clique is maximal.
+    if (n_candidates == 0u) {
+      if (clique.size() > max_found_size) {
+        max_found_size = clique.size();
+        maximum_clique = clique;
+      }
+      return;
+    }
+    if (!can_expand) return;
+
+    const size_t n_words = adjacency_matrix.getWordsPerRow();
+    Word* candidates = &candidate_sets[depth * n_words];
+    Word* next_candidates = candidates + n_words;
+
+    // Process the candidates in decreasing vertex order.
+    for (size_t w = n_active_words; w-- > 0u;) {
+      while (candidates[w] != Word(0u)) {
+        // Continue the search only if there are enough remaining candidates.
+        if (clique.size() + n_candidates <= max_found_size) return;
+        const size_t bit = BitsetAdjacencyMatrix::highestBit(candidates[w]);
+        candidates[w] &= ~(Word(1u) << bit);
+        --n_candidates;
+        const size_t vertex = w * BitsetAdjacencyMatrix::kBitsPerWord + bit;
+
+        // The remaining candidates are all stored in the first w + 1 words.
+        const size_t n_next_candidates = BitsetAdjacencyMatrix::intersect(
+            candidates, adjacency_matrix.getRow(vertex), next_candidates, w + 1u);
+        clique.push_back(vertex);
+        expandCliqueBitset(adjacency_matrix, candidate_sets, depth + 1u, n_next_candidates,
+                           w + 1u, clique, max_found_size, maximum_clique, monitor);
+        clique.pop_back();
+        if (monitor.isStopped()) return;
+      }
+    }
+  }
+
+  // Helper recursive function for the findMaximumCliqueParallel() function. Expands \c clique
+  // with the vertices in the range [subset_begin, subset_end) of \c candidate_stack, pruning
+  // against the lower bound shared by all the workers. Bigger cliques are stored in
+  // \c maximum_clique while holding \c maximum_clique_mutex.
+  // findMaximumCliqueParallel() 的辅助递归函数，使用所有线程共享的下界剪枝
+  template<typename Graph>
+  static void findMaximumCliqueSubsetShared(
+      const Graph& graph,
+      std::vector<typename boost::graph_traits<Graph>::vertex_descriptor>& candidate_stack,
+      const size_t subset_begin, size_t subset_end, const std::vector<size_t>& core_numbers,
+      std::vector<typename boost::graph_traits<Graph>::vertex_descriptor>& clique,
+      std::atomic<size_t>& shared_max_found_size, std::mutex& maximum_clique_mutex,
+      std::vector<typename boost::graph_traits<Graph>::vertex_descriptor>& maximum_clique,
+      SearchMonitor& monitor) {
+    typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
+    const bool can_expand = monitor.expandNode();
+
+    // Final step of the recursion: if there are no more vertices to process, the clique is
+    // maximal.
+    if (subset_begin == subset_end) {
+      size_t max_found_size = shared_max_found_size.load(std::memory_order_relaxed);
+      while (clique.size() > max_found_size) {
+        if (shared_max_found_size.compare_exchange_weak(max_found_size, clique.size())) {
+          std::lock_guard<std::mutex> lock(maximum_clique_mutex);
+          if (clique.size() > maximum_clique.size()) maximum_clique = clique;
+          break;
+        }
+      }
+      return;
+    }
+    if (!can_expand) return;
+
+    // The subsets of the nested calls are stored after the current subset.
+    const size_t neighbors_begin = subset_end;
+    if (candidate_stack.size() < neighbors_begin + subset_end - subset_begin) {
+      candidate_stack.resize(neighbors_begin + subset_end - subset_begin);
+    }
+    while (subset_end > subset_begin && !monitor.isStopped()) {
+      // Continue the search only if there are enough remaining candidates.
+      const size_t max_found_size = shared_max_found_size.load(std::memory_order_relaxed);
+      if (clique.size() + subset_end - subset_begin <= max_found_size) break;
+      const Vertex vertex = candidate_stack[--subset_end];
+
+      // Collect the vertices that can be part of a bigger clique and are connected to the
+      // current vertex.
+      size_t neighbors_end = neighbors_begin;
+      for (size_t i = subset_begin; i < subset_end; ++i) {
+        const Vertex candidate = candidate_stack[i];
+        if (core_numbers[candidate] >= max_found_size &&
+            boost::edge(vertex, candidate, graph).second)
+          candidate_stack[neighbors_end++] = candidate;
+      }
+
+      clique.push_back(vertex);
+      findMaximumCliqueSubsetShared(graph, candidate_stack, neighbors_begin, neighbors_end,
+                                    core_numbers, clique, shared_max_found_size,
+                                    maximum_clique_mutex, maximum_clique, monitor);
+      clique.pop_back();
+    }
+  }
+
+  // State of the enumeration performed by findLargestMaximalCliques().
+  struct CliqueEnumerationState {
+    // The buffers of the state are taken from the workspace, which must contain the adjacency
+    // matrix of the graph.
+    CliqueEnumerationState(CliqueSearchWorkspace& workspace, const size_t degeneracy,
+                           const size_t min_clique_size, const size_t max_num_cliques,
+                           const CliqueSearchBudget* budget)
+      : adjacency_matrix(workspace.adjacency_matrix_),
+        n_words(adjacency_matrix.getWordsPerRow()),
+        sets(workspace.bitset_stack_),
+        min_clique_size(min_clique_size),
+        max_num_cliques(max_num_cliques),
+        clique(workspace.clique_),
+        monitor(budget) {
+      sets.resize(2u * (degeneracy + 2u) * n_words);
+      clique.clear();
+      clique.reserve(degeneracy + 1u);
+    }
+
+    // Candidate and excluded vertices at the specified level of the recursion.
+    inline BitsetAdjacencyMatrix::Word* getCandidates(const size_t depth) {
+      return &sets[2u * depth * n_words];
+    }
+    inline BitsetAdjacencyMatrix::Word* getExcluded(const size_t depth) {
+      return &sets[(2u * depth + 1u) * n_words];
+    }
+
+    // Minimum size that a clique must have in order to be stored. When the maximum number of
+    // cliques has been collected, only cliques bigger than the smallest one are accepted.
+    inline size_t getMinReportedSize() const {
+      if (max_num_cliques != 0u && cliques.size() == max_num_cliques)
+        return cliques.front().size() + 1u;
+      return min_clique_size;
+    }
+
+    // Stores a maximal clique. The collected cliques are organized as a min-heap on their size.
+    void reportClique() {
+      if (clique.size() < getMinReportedSize()) return;
+      const auto compare_sizes = [](const std::vector<size_t>& a, const std::vector<size_t>& b) {
+        return a.size() > b.size();
+      };
+      if (max_num_cliques != 0u && cliques.size() == max_num_cliques) {
+        std::pop_heap(cliques.begin(), cliques.end(), compare_sizes);
+        cliques.back() = clique;
+      } else {
+        cliques.push_back(clique);
+      }
+      std::push_heap(cliques.begin(), cliques.end(), compare_sizes);
+    }
+
+    const BitsetAdjacencyMatrix& adjacency_matrix;
+    const size_t n_words;
+    std::vector<BitsetAdjacencyMatrix::Word>& sets;
+    const size_t min_clique_size;
+    const size_t max_num_cliques;
+    std::vector<size_t>& clique;
+    std::vector<std::vector<size_t>> cliques;
+    SearchMonitor monitor;
+  };
+
+  // Helper recursive function for the findLargestMaximalCliques() function.
+  // findLargestMaximalCliques() 的辅助递归函数
+  static void enumerateMaximalCliques(CliqueEnumerationState& state, const size_t depth) {
+    typedef BitsetAdjacencyMatrix::Word Word;
+    const bool can_expand = state.monitor.expandNode();
+    const size_t n_words = state.n_words;
+    Word* candidates = state.getCandidates(depth);
+    Word* excluded = state.getExcluded(depth);
+
+    size_t n_candidates = BitsetAdjacencyMatrix::count(candidates, n_words);
+    if (n_candidates == 0u) {
+      // The clique is maximal only if it cannot be extended with excluded vertices.
+      if (BitsetAdjacencyMatrix::count(excluded, n_words) == 0u) state.reportClique();
+      return;
+    }
+    if (!can_expand) return;
+    if (state.clique.size() + n_candidates < state.getMinReportedSize()) return;
+
+    // Choose the pivot among candidates and excluded vertices, maximizing the number of
+    // candidates adjacent to it.
+    size_t pivot = 0u;
+    size_t max_pivot_neighbors = 0u;
+    bool pivot_found = false;
+    for (size_t w = 0u; w < n_words; ++w) {
+      Word union_word = candidates[w] | excluded[w];
+      while (union_word != Word(0u)) {
+        const size_t bit = BitsetAdjacencyMatrix::lowestBit(union_word);
+        union_word &= union_word - 1u;
+        const size_t vertex = w * BitsetAdjacencyMatrix::kBitsPerWord + bit;
+        const Word* neighbors = state.adjacency_matrix.getRow(vertex);
+        size_t n_pivot_neighbors = 0u;
+        for (size_t k = 0u; k < n_words; ++k) {
+          n_pivot_neighbors += BitsetAdjacencyMatrix::popCount(candidates[k] & neighbors[k]);
+        }
+        if (!pivot_found || n_pivot_neighbors > max_pivot_neighbors) {
+          pivot = vertex;
+          max_pivot_neighbors = n_pivot_neighbors;
+          pivot_found = true;
+        }
+      }
+    }
+
+    // Branch on the candidates that are not neighbors of the pivot.
+    const Word* pivot_neighbors = state.adjacency_matrix.getRow(pivot);
+    Word* next_candidates = state.getCandidates(depth + 1u);
+    Word* next_excluded = state.getExcluded(depth + 1u);
+    for (size_t w = 0u; w < n_words; ++w) {
+      Word branch_word = candidates[w] & ~pivot_neighbors[w];
+      while (branch_word != Word(0u)) {
+        // Continue only if the remaining candidates can form a big enough clique. The bound can
+        // increase while the enumeration proceeds.
+        if (state.clique.size() + n_candidates < state.getMinReportedSize()) return;
+        const size_t bit = BitsetAdjacencyMatrix::lowestBit(branch_word);
+        branch_word &= branch_word - 1u;
+        const size_t vertex = w * BitsetAdjacencyMatrix::kBitsPerWord + bit;
+
+        const Word* neighbors = state.adjacency_matrix.getRow(vertex);
+        BitsetAdjacencyMatrix::intersect(candidates, neighbors, next_candidates, n_words);
+        BitsetAdjacencyMatrix::intersect(excluded, neighbors, next_excluded, n_words);
+        state.clique.push_back(vertex);
+        enumerateMaximalCliques(state, depth + 1u);
+        state.clique.pop_back();
+        if (state.monitor.isStopped()) return;
+
+        // Move the vertex from the candidates to the excluded vertices.
+        BitsetAdjacencyMatrix::clearBit(candidates, vertex);
+        BitsetAdjacencyMatrix::setBit(excluded, vertex);
+        --n_candidates;
+      }
+    }
+  }
+
+  // State of the search performed by findMaximumCliqueColoring().
+  struct ColoringSearchState {
+    // The buffers of the state are taken from the workspace, which must contain the adjacency
+    // matrix of the graph.
+    ColoringSearchState(CliqueSearchWorkspace& workspace, const size_t degeneracy,
+                        const size_t max_found_size, const CliqueSearchBudget* budget)
+      : adjacency_matrix(workspace.adjacency_matrix_),
+        n_words(adjacency_matrix.getWordsPerRow()),
+        candidate_sets(workspace.bitset_stack_),
+        uncolored(workspace.uncolored_),
+        color_class(workspace.color_class_),
+        colored_vertices(workspace.colored_vertices_),
+        vertex_colors(workspace.vertex_colors_),
+        clique(workspace.clique_),
+        max_found_size(max_found_size),
+        monitor(budget) {
+      candidate_sets.resize((degeneracy + 2u) * n_words);
+      uncolored.resize(n_words);
+      color_class.resize(n_words);
+      colored_vertices.clear();
+      vertex_colors.clear();
+      clique.clear();
+      clique.reserve(degeneracy + 1u);
+    }
+
+    const BitsetAdjacencyMatrix& adjacency_matrix;
+    const size_t n_words;
+    // One candidate set for each level of the recursion.
+    std::vector<BitsetAdjacencyMatrix::Word>& candidate_sets;
+    // Scratch bitsets used by the coloring.
+    std::vector<BitsetAdjacencyMatrix::Word>& uncolored;
+    std::vector<BitsetAdjacencyMatrix::Word>& color_class;
+    // Stack of the colored candidates (vertex and color) of all the levels of the recursion.
+    std::vector<size_t>& colored_vertices;
+    std::vector<size_t>& vertex_colors;
+    std::vector<size_t>& clique;
+    std::vector<size_t> maximum_clique;
+    size_t max_found_size;
+    SearchMonitor monitor;
+  };
+
+  // Greedily colors the candidates at level \c depth and pushes the candidates that could
+  // improve the maximum clique on the colored vertices stack, in non-decreasing color order.
+  // Candidates whose color is smaller than \c min_color are not pushed: they can be skipped as
+  // branching vertices since their color is a bound on the clique size they can contribute to.
+  // 对候选集合贪心着色，只把颜色不小于 min_color 的顶点按颜色非降序压栈
+  static void colorCandidates(ColoringSearchState& state, const size_t depth,
+                              const size_t min_color) {
+    typedef BitsetAdjacencyMatrix::Word Word;
+    const size_t n_words = state.n_words;
+    const Word* candidates = &state.candidate_sets[depth * n_words];
+    Word* uncolored = state.uncolored.data();
+    Word* color_class = state.color_class.data();
+    std::copy(candidates, candidates + n_words, uncolored);
+
+    size_t color = 1u;
+    size_t first_word = 0u;
+    while (true) {
+      while (first_word < n_words && uncolored[first_word] == Word(0u)) ++first_word;
+      if (first_word == n_words) break;
+
+      // Build a color class, i.e. an independent set, from the uncolored candidates.
+      std::copy(uncolored + first_word, uncolored + n_words, color_class + first_word);
+      for (size_t w = first_word; w < n_words; ++w) {
+        while (color_class[w] != Word(0u)) {
+          const size_t bit = BitsetAdjacencyMatrix::lowestBit(color_class[w]);
+          const size_t vertex = w * BitsetAdjacencyMatrix::kBitsPerWord + bit;
+          uncolored[w] &= ~(Word(1u) << bit);
+          color_class[w] &= ~(Word(1u) << bit);
+
+          // Remove the neighbors of the vertex from the color class.
+          const Word* neighbors = state.adjacency_matrix.getRow(vertex);
+          for (size_t k = w; k < n_words; ++k) color_class[k] &= ~neighbors[k];
+
+          if (color >= min_color) {
+            state.colored_vertices.push_back(vertex);
+            state.vertex_colors.push_back(color);
+          }
+        }
+      }
+      ++color;
+    }
+  }
+
+  // Helper recursive function for the findMaximumCliqueColoring() function.
+  // findMaximumCliqueColoring() 的辅助递归函数
+  static void expandCliqueColoring(ColoringSearchState& state, const size_t depth) {
+    typedef BitsetAdjacencyMatrix::Word Word;
+    if (!state.monitor.expandNode()) return;
+    const size_t n_words = state.n_words;
+
+    // Only vertices with color greater than this threshold can lead to a bigger clique.
+    const size_t clique_size = state.clique.size();
+    const size_t min_color = state.max_found_size >= clique_size ?
+        state.max_found_size - clique_size + 1u : 1u;
+    const size_t stack_begin = state.colored_vertices.size();
+    colorCandidates(state, depth, min_color);
+
+    // Branch on the candidates in decreasing color order.
+    for (size_t i = state.colored_vertices.size(); i-- > stack_begin;) {
+      // The color of the candidate bounds the size of the cliques that can be found.
+      if (state.clique.size() + state.vertex_colors[i] <= state.max_found_size) break;
+      const size_t vertex = state.colored_vertices[i];
+
+      Word* candidates = &state.candidate_sets[depth * n_words];
+      Word* next_candidates = candidates + n_words;
+      const size_t n_next_candidates = BitsetAdjacencyMatrix::intersect(
+          candidates, state.adjacency_matrix.getRow(vertex), next_candidates, n_words);
+
+      state.clique.push_back(vertex);
+      if (n_next_candidates == 0u) {
+        // The clique is maximal: check if it is bigger than the current maximum.
+        if (state.clique.size() > state.max_found_size) {
+          state.max_found_size = state.clique.size();
+          state.maximum_clique = state.clique;
+        }
+      } else {
+        expandCliqueColoring(state, depth + 1u);
+      }
+      state.clique.pop_back();
+      if (state.monitor.isStopped()) break;
+
+      // Remove the vertex from the candidates.
+      BitsetAdjacencyMatrix::clearBit(candidates, vertex);
+    }
+
+    state.colored_vertices.resize(stack_begin);
+    state.vertex_colors.resize(stack_begin);
   }
 
-  // Helper recursive function for the findMaximumClique() function.
+  // Search performed by findMaximumCliqueFixedWidth() on graphs with at most kNumWords * 64
+  // vertices. The set operations work on bitsets of kNumWords words, so that they are fully
+  // unrolled. As in ColoringSearchState, the candidate sets of the levels of the recursion and the
+  // colored candidates are stored in the workspace, so that the recursion only uses a few words
+  // of stack per level.
+  // findMaximumCliqueFixedWidth() 使用的定长位集搜索，各层的候选集合与着色结果存放在工作空间中
+  template<size_t kNumWords>
+  struct FixedWidthColoringSearch {
+    typedef BitsetAdjacencyMatrix::Word Word;
+    typedef std::array<Word, kNumWords> Bitset;
+    static constexpr size_t kMaxNumVertices = kNumWords * BitsetAdjacencyMatrix::kBitsPerWord;
+
+    FixedWidthColoringSearch(CliqueSearchWorkspace& workspace, const size_t degeneracy,
+                             const size_t max_found_size, const CliqueSearchBudget* budget)
+      : candidate_sets(workspace.bitset_stack_),
+        colored_vertices(workspace.colored_vertices_),
+        vertex_colors(workspace.vertex_colors_),
+        max_found_size(max_found_size),
+        monitor(budget) {
+      for (auto& row : adjacency) row.fill(Word(0u));
+      candidate_sets.assign((degeneracy + 2u) * kNumWords, Word(0u));
+      colored_vertices.clear();
+      vertex_colors.clear();
+    }
+
+    inline void addEdge(const size_t u, const size_t v) {
+      BitsetAdjacencyMatrix::setBit(adjacency[u].data(), v);
+      BitsetAdjacencyMatrix::setBit(adjacency[v].data(), u);
+    }
+
+    // The candidate set of level depth of the recursion.
+    inline Word* getCandidates(const size_t depth) {
+      return &candidate_sets[depth * kNumWords];
+    }
+
+    // Expands the current clique with the candidates of level depth.
+    void expand(const size_t depth) {
+      if (!monitor.expandNode()) return;
+
+      // Greedily color the candidates. Only the candidates whose color can lead to a bigger
+      // clique are pushed, in non-decreasing color order.
+      const size_t min_color = max_found_size >= clique_size ?
+          max_found_size - clique_size + 1u : 1u;
+      const size_t stack_begin = colored_vertices.size();
+      Word* candidates = getCandidates(depth);
+      std::copy(candidates, candidates + kNumWords, uncolored.begin());
+      size_t color = 1u;
+      for (size_t first_word = 0u; first_word < kNumWords;) {
+        if (uncolored[first_word] == Word(0u)) {
+          ++first_word;
+          continue;
+        }
+        color_class = uncolored;
+        for (size_t w = first_word; w < kNumWords; ++w) {
+          while (color_class[w] != Word(0u)) {
+            const size_t bit = BitsetAdjacencyMatrix::lowestBit(color_class[w]);
+            const size_t vertex = w * BitsetAdjacencyMatrix::kBitsPerWord + bit;
+            uncolored[w] &= ~(Word(1u) << bit);
+            color_class[w] &= ~(Word(1u) << bit);
+            for (size_t k = 0u; k < kNumWords; ++k) color_class[k] &= ~adjacency[vertex][k];
+            if (color >= min_color) {
+              colored_vertices.push_back(vertex);
+              vertex_colors.push_back(color);
+            }
+          }
+        }
+        ++color;
+      }
+
+      // Branch on the candidates in decreasing color order.
+      for (size_t i = colored_vertices.size(); i-- > stack_begin;) {
+        if (clique_size + vertex_colors[i] <= max_found_size) break;
+        const size_t vertex = colored_vertices[i];
+        Word* next_candidates = getCandidates(depth + 1u);
+        Word any_candidate = Word(0u);
+        for (size_t k = 0u; k < kNumWords; ++k) {
+          next_candidates[k] = candidates[k] & adjacency[vertex][k];
+          any_candidate |= next_candidates[k];
+        }
+
+        clique[clique_size++] = static_cast<uint16_t>(vertex);
+        if (any_candidate == Word(0u)) {
+          // The clique is maximal: check if it is bigger than the current maximum.
+          if (clique_size > max_found_size) {
+            max_found_size = clique_size;
+            maximum_clique = clique;
+            maximum_clique_size = clique_size;
+          }
+        } else {
+          expand(depth + 1u);
+        }
+        --clique_size;
+        if (monitor.isStopped()) break;
+
+        // Remove the vertex from the candidates.
+        BitsetAdjacencyMatrix::clearBit(candidates, vertex);
+      }
+
+      colored_vertices.resize(stack_begin);
+      vertex_colors.resize(stack_begin);
+    }
+
+    std::array<Bitset, kMaxNumVertices> adjacency;
+    std::array<uint16_t, kMaxNumVertices> clique;
+    std::array<uint16_t, kMaxNumVertices> maximum_clique;
+    // One candidate set for each level of the recursion, and scratch bitsets of the coloring.
+    std::vector<Word>& candidate_sets;
+    Bitset uncolored;
+    Bitset color_class;
+    // Stack of the colored candidates (vertex and color) of all the levels of the recursion.
+    std::vector<size_t>& colored_vertices;
+    std::vector<size_t>& vertex_colors;
+    size_t clique_size = 0u;
+    size_t maximum_clique_size = 0u;
+    size_t max_found_size;
+    SearchMonitor monitor;
+  };
+
+  // Seed of the random generator of the local search, fixed so that results are reproducible.
+  static constexpr unsigned int kLocalSearchRandomSeed = 5489u;
+  // Number of steps during which a vertex removed from the clique by a swap cannot be swapped
+  // back in.
+  static constexpr size_t kLocalSearchTabuTenure = 7u;
+
+  // State of the local search of findCliqueHeuristic(). The number of clique vertices adjacent to
+  // every vertex is updated incrementally, so that the vertices that can be added to the clique
+  // or swapped into it are found by scanning the neighbors of two clique vertices only: a vertex
+  // not adjacent to at most one clique vertex is adjacent to one of them.
+  // findCliqueHeuristic() 局部搜索的状态，增量维护每个顶点与团中多少顶点相邻
+  template<typename Graph>
+  struct LocalSearchState {
+    typedef boost::graph_traits<Graph> GraphTraits;
+    typedef typename GraphTraits::vertex_descriptor Vertex;
+    static constexpr size_t kNotInClique = std::numeric_limits<size_t>::max();
+
+    // The buffers of the state are taken from the workspace, which must contain the core numbers
+    // of the vertices.
+    LocalSearchState(const Graph& graph, CliqueSearchWorkspace& workspace, size_t& mark)
+      : graph(graph),
+        core_numbers(workspace.vertex_degrees_),
+        vertex_marks(workspace.vertex_marks_),
+        mark(mark),
+        clique(workspace.clique_),
+        clique_positions(workspace.clique_positions_),
+        adjacent_clique_vertices(workspace.adjacent_clique_vertices_),
+        tabu_expirations(workspace.tabu_expirations_),
+        add_candidates(workspace.add_candidates_),
+        swap_candidates(workspace.swap_candidates_) {
+      const size_t n_vertices = boost::num_vertices(graph);
+      clique.clear();
+      clique_positions.assign(n_vertices, kNotInClique);
+      adjacent_clique_vertices.assign(n_vertices, 0u);
+      tabu_expirations.assign(n_vertices, 0u);
+    }
+
+    void addVertex(const Vertex vertex) {
+      clique_positions[vertex] = clique.size();
+      clique.push_back(vertex);
+      typename GraphTraits::out_edge_iterator e_it, e_end;
+      for (boost::tie(e_it, e_end) = boost::out_edges(vertex, graph); e_it != e_end; ++e_it) {
+        ++adjacent_clique_vertices[boost::target(*e_it, graph)];
+      }
+    }
+
+    void removeVertex(const Vertex vertex) {
+      const size_t position = clique_positions[vertex];
+      clique[position] = clique.back();
+      clique_positions[clique[position]] = position;
+      clique.pop_back();
+      clique_positions[vertex] = kNotInClique;
+      typename GraphTraits::out_edge_iterator e_it, e_end;
+      for (boost::tie(e_it, e_end) = boost::out_edges(vertex, graph); e_it != e_end; ++e_it) {
+        --adjacent_clique_vertices[boost::target(*e_it, graph)];
+      }
+    }
+
+    void clear() {
+      while (!clique.empty()) removeVertex(clique.back());
+    }
+
+    // Removes the clique vertices that are not adjacent to \c vertex. Returns the last removed
+    // vertex.
+    Vertex removeNonNeighbors(const Vertex vertex) {
+      ++mark;
+      typename GraphTraits::out_edge_iterator e_it, e_end;
+      for (boost::tie(e_it, e_end) = boost::out_edges(vertex, graph); e_it != e_end; ++e_it) {
+        vertex_marks[boost::target(*e_it, graph)] = mark;
+      }
+      Vertex removed_vertex = vertex;
+      for (size_t i = clique.size(); i-- > 0u;) {
+        if (vertex_marks[clique[i]] != mark) {
+          removed_vertex = clique[i];
+          removeVertex(removed_vertex);
+        }
+      }
+      return removed_vertex;
+    }
+
+    // Collects the vertices with core number at least \c min_core_number that are adjacent to
+    // all the clique vertices (add moves) or to all but one (swap moves, excluding tabu
+    // vertices).
+    void collectMoves(const size_t min_core_number, const size_t step) {
+      add_candidates.clear();
+      swap_candidates.clear();
+      ++mark;
+      const size_t n_scanned_vertices = std::min<size_t>(clique.size(), 2u);
+      for (size_t i = 0u; i < n_scanned_vertices; ++i) {
+        typename GraphTraits::out_edge_iterator e_it, e_end;
+        for (boost::tie(e_it, e_end) = boost::out_edges(clique[i], graph); e_it != e_end;
+             ++e_it) {
+          const Vertex neighbor = boost::target(*e_it, graph);
+          if (vertex_marks[neighbor] == mark) continue;
+          vertex_marks[neighbor] = mark;
+          if (clique_positions[neighbor] != kNotInClique ||
+              core_numbers[neighbor] < min_core_number) continue;
+          if (adjacent_clique_vertices[neighbor] == clique.size()) {
+            add_candidates.push_back(neighbor);
+          } else if (adjacent_clique_vertices[neighbor] + 1u == clique.size() &&
+                     tabu_expirations[neighbor] <= step) {
+            swap_candidates.push_back(neighbor);
+          }
+        }
+      }
+    }
+
+    const Graph& graph;
+    const std::vector<size_t>& core_numbers;
+    // Marks used for testing adjacency to a vertex in constant time.
+    std::vector<size_t>& vertex_marks;
+    size_t& mark;
+    std::vector<Vertex>& clique;
+    std::vector<size_t>& clique_positions;
+    std::vector<size_t>& adjacent_clique_vertices;
+    std::vector<size_t>& tabu_expirations;
+    std::vector<Vertex>& add_candidates;
+    std::vector<Vertex>& swap_candidates;
+  };
+
+  // State of the search performed by findMaximumWeightClique().
+  struct WeightedColoringSearchState {
+    // The buffers of the state are taken from the workspace, which must contain the adjacency
+    // matrix of the graph.
+    WeightedColoringSearchState(CliqueSearchWorkspace& workspace, const size_t degeneracy,
+                                const size_t min_clique_size, const CliqueSearchBudget* budget)
+      : adjacency_matrix(workspace.adjacency_matrix_),
+        n_words(adjacency_matrix.getWordsPerRow()),
+        vertex_weights(workspace.vertex_weights_),
+        candidate_sets(workspace.bitset_stack_),
+        uncolored(workspace.uncolored_),
+        color_class(workspace.color_class_),
+        colored_vertices(workspace.colored_vertices_),
+        vertex_colors(workspace.vertex_colors_),
+        vertex_bounds(workspace.vertex_bounds_),
+        clique(workspace.clique_),
+        min_clique_size(min_clique_size),
+        monitor(budget) {
+      vertex_weights.resize(adjacency_matrix.getNumVertices());
+      candidate_sets.resize((degeneracy + 2u) * n_words);
+      uncolored.resize(n_words);
+      color_class.resize(n_words);
+      colored_vertices.clear();
+      vertex_colors.clear();
+      vertex_bounds.clear();
+      clique.clear();
+      clique.reserve(degeneracy + 1u);
+    }
+
+    const BitsetAdjacencyMatrix& adjacency_matrix;
+    const size_t n_words;
+    // Weights of the vertices, indexed by the position of the vertices in the matrix.
+    std::vector<double>& vertex_weights;
+    // One candidate set for each level of the recursion.
+    std::vector<BitsetAdjacencyMatrix::Word>& candidate_sets;
+    // Scratch bitsets used by the coloring.
+    std::vector<BitsetAdjacencyMatrix::Word>& uncolored;
+    std::vector<BitsetAdjacencyMatrix::Word>& color_class;
+    // Stack of the colored candidates (vertex, color and weight bound) of all the levels of the
+    // recursion.
+    std::vector<size_t>& colored_vertices;
+    std::vector<size_t>& vertex_colors;
+    std::vector<double>& vertex_bounds;
+    std::vector<size_t>& clique;
+    std::vector<size_t> maximum_clique;
+    double max_found_weight = -std::numeric_limits<double>::infinity();
+    const size_t min_clique_size;
+    SearchMonitor monitor;
+  };
+
+  // Greedily colors the candidates at level \c depth and pushes them on the colored vertices
+  // stack with their color and the weight bound of the cliques they can contribute to. The bound
+  // of a candidate is the sum of the maximum weights of the previous color classes plus the
+  // maximum weight of its own class among the candidates pushed so far, so bounds never decrease
+  // along the stack. Candidates that cannot lead to a heavier clique of the minimum size are not
+  // pushed.
+  // 对候选集合贪心着色，计算每个顶点的加权着色上界，只压入可能得到更重团的顶点
+  static void colorCandidatesWeighted(WeightedColoringSearchState& state, const size_t depth,
+                                      const double clique_weight) {
+    typedef BitsetAdjacencyMatrix::Word Word;
+    const size_t n_words = state.n_words;
+    const Word* candidates = &state.candidate_sets[depth * n_words];
+    Word* uncolored = state.uncolored.data();
+    Word* color_class = state.color_class.data();
+    std::copy(candidates, candidates + n_words, uncolored);
+
+    size_t color = 1u;
+    size_t first_word = 0u;
+    double previous_classes_weight = 0.0;
+    while (true) {
+      while (first_word < n_words && uncolored[first_word] == Word(0u)) ++first_word;
+      if (first_word == n_words) break;
+
+      // Build a color class, i.e. an independent set, from the uncolored candidates.
+      double class_weight = 0.0;
+      std::copy(uncolored + first_word, uncolored + n_words, color_class + first_word);
+      for (size_t w = first_word; w < n_words; ++w) {
+        while (color_class[w] != Word(0u)) {
+          const size_t bit = BitsetAdjacencyMatrix::lowestBit(color_class[w]);
+          const size_t vertex = w * BitsetAdjacencyMatrix::kBitsPerWord + bit;
+          uncolored[w] &= ~(Word(1u) << bit);
+          color_class[w] &= ~(Word(1u) << bit);
+
+          // Remove the neighbors of the vertex from the color class.
+          const Word* neighbors = state.adjacency_matrix.getRow(vertex);
+          for (size_t k = w; k < n_words; ++k) color_class[k] &= ~neighbors[k];
+
+          class_weight = std::max(class_weight, state.vertex_weights[vertex]);
+          const double bound = previous_classes_weight + class_weight;
+          if (clique_weight + bound > state.max_found_weight &&
+              state.clique.size() + color >= state.min_clique_size) {
+            state.colored_vertices.push_back(vertex);
+            state.vertex_colors.push_back(color);
+            state.vertex_bounds.push_back(bound);
+          }
+        }
+      }
+      previous_classes_weight += class_weight;
+      ++color;
+    }
+  }
+
+  // Helper recursive function for the findMaximumWeightClique() function.
+  // findMaximumWeightClique() 的辅助递归函数
+  static void expandCliqueWeighted(WeightedColoringSearchState& state, const size_t depth,
+                                   const double clique_weight) {
+    typedef BitsetAdjacencyMatrix::Word Word;
+    if (!state.monitor.expandNode()) return;
+    const size_t n_words = state.n_words;
+
+    const size_t stack_begin = state.colored_vertices.size();
+    colorCandidatesWeighted(state, depth, clique_weight);
+
+    // Branch on the candidates in decreasing bound order.
+    for (size_t i = state.colored_vertices.size(); i-- > stack_begin;) {
+      // Stop when the remaining candidates cannot lead to a heavier clique of the minimum size.
+      if (clique_weight + state.vertex_bounds[i] <= state.max_found_weight ||
+          state.clique.size() + state.vertex_colors[i] < state.min_clique_size) break;
+      const size_t vertex = state.colored_vertices[i];
+      const double next_clique_weight = clique_weight + state.vertex_weights[vertex];
+
+      Word* candidates = &state.candidate_sets[depth * n_words];
+      Word* next_candidates = candidates + n_words;
+      const size_t n_next_candidates = BitsetAdjacencyMatrix::intersect(
+          candidates, state.adjacency_matrix.getRow(vertex), next_candidates, n_words);
+
+      state.clique.push_back(vertex);
+      if (n_next_candidates == 0u) {
+        // The clique is maximal: check if it is heavier than the current maximum.
+        if (state.clique.size() >= state.min_clique_size &&
+            next_clique_weight > state.max_found_weight) {
+          state.max_found_weight = next_clique_weight;
+          state.maximum_clique = state.clique;
+        }
+      } else {
+        expandCliqueWeighted(state, depth + 1u, next_clique_weight);
+      }
+      state.clique.pop_back();
+      if (state.monitor.isStopped()) break;
+
+      // Remove the vertex from the candidates.
+      BitsetAdjacencyMatrix::clearBit(candidates, vertex);
+    }
+
+    state.colored_vertices.resize(stack_begin);
+    state.vertex_colors.resize(stack_begin);
+    state.vertex_bounds.resize(stack_begin);
+  }
+
+  // Helper recursive function for the findMaximumClique() function. The subset of vertices to
+  // process is the range [subset_begin, subset_end) of the candidate stack of the workspace. The
+  // subsets of the nested calls are stored on the stack after the current subset, so that the
+  // recursion does not allocate memory once the stack is big enough. The vertices of the biggest
+  // clique found are stored in the clique buffer of the workspace.
   // findMaximumClique() 的辅助递归函数
-  // 参数：图  相邻点（子集）  度  团尺寸  找到的最大规模（初值为最小集团规模）  ~~
+  // 参数：图  工作空间  子集在候选栈中的范围  团尺寸  找到的最大规模（初值为最小集团规模）  ~~
   // 返回：
   template<typename Graph>
   static size_t findMaximumCliqueSubset(
-      const Graph& graph,
-      std::vector<typename boost::graph_traits<Graph>::vertex_descriptor>& subset,
-      const std::vector<size_t>& vertex_degrees,
-      const size_t clique_size, size_t max_found_size,
-      std::vector<typename boost::graph_traits<Graph>::vertex_descriptor>& maximum_clique_tmp) {
+      const Graph& graph, CliqueSearchWorkspace& workspace, const size_t subset_begin,
+      size_t subset_end, const size_t clique_size, size_t max_found_size,
+      SearchMonitor& monitor) {
     // Ensure that the graph type is supported and define type shortcuts.
     assertIsUndirectedAndRandomAccessGraph(graph);
+    const bool can_expand = monitor.expandNode();
     typedef boost::graph_traits<Graph> GraphTraits;
     typedef typename GraphTraits::vertex_descriptor Vertex;
 
-    const size_t n_vertices = boost::num_vertices(graph);
-    std::vector<Vertex> neighbors;
-    neighbors.reserve(n_vertices);
-
     // Final step of the recursion: if there are no more vertices to process, the search is
     // complete.
-	// 
-    if(subset.empty()) {
+	//
+    if(subset_begin == subset_end) {
       if(clique_size > max_found_size) {
-        maximum_clique_tmp.clear();
+        workspace.clique_.clear();
         return clique_size;
       }
       return max_found_size;
     }
+    if (!can_expand) return max_found_size;
+
+    // The neighbors of a vertex of the subset are a subset of it, so the stack needs at most as
+    // much space as the current subset after it.
+    std::vector<Vertex>& stack = workspace.candidate_stack_;
+    const std::vector<size_t>& vertex_degrees = workspace.vertex_degrees_;
+    const size_t neighbors_begin = subset_end;
+    if (stack.size() < neighbors_begin + subset_end - subset_begin) {
+      stack.resize(neighbors_begin + subset_end - subset_begin);
+    }
 
     // Process the given subset of vertices.
 	// 处理顶点子集
-    while(!subset.empty()) {
+    while(subset_end > subset_begin && !monitor.isStopped()) {
       // Continue the search only if there are enough remaining candidates.
-      if(clique_size + subset.size() <= max_found_size) break;
-      Vertex vertex = subset.back();
-      subset.pop_back();
+      if(clique_size + subset_end - subset_begin <= max_found_size) break;
+      const Vertex vertex = stack[--subset_end];
 
       // Collect the vertices that have enough neighbors and are connected to the current vertex.
 	  // 与当前顶点关联且具有足够相邻点的顶点
-      for (const Vertex candidate : subset) {
+      size_t neighbors_end = neighbors_begin;
+      for (size_t i = subset_begin; i < subset_end; ++i) {
+        const Vertex candidate = stack[i];
         if (vertex_degrees[candidate] >= max_found_size &&
             boost::edge(vertex, candidate, graph).second)
-            neighbors.push_back(candidate);
+            stack[neighbors_end++] = candidate;
       }
 
       // Get the size of the maximum clique contained in the subgraph defined by the current vertex
       // and its neighbors.
 	  // 获取由当前顶点及其相邻点定义的子图中的最大团
-      const size_t new_found_size = findMaximumCliqueSubset(graph, neighbors, vertex_degrees,
-                                                            clique_size + 1u, max_found_size,
-                                                            maximum_clique_tmp);
+      const size_t new_found_size = findMaximumCliqueSubset(graph, workspace, neighbors_begin,
+                                                            neighbors_end, clique_size + 1u,
+                                                            max_found_size, monitor);
 
       // If a bigger clique is found, use the current vertex.
       if(new_found_size > max_found_size) {
         max_found_size = new_found_size;
-        maximum_clique_tmp.push_back(vertex);
+        workspace.clique_.push_back(vertex);
       }
-      neighbors.clear();
     }
 
     return max_found_size;
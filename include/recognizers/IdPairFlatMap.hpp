@@ -0,0 +1,136 @@
+#ifndef ID_PAIR_FLAT_MAP_HPP_
+#define ID_PAIR_FLAT_MAP_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "RecognizerData.h"
+
+namespace bron_kerbosch {
+
+/// \brief Hash map from pairs of segment IDs to indices, using open addressing with linear
+/// probing. The entries are stored in a single array whose size is a power of two, so that an
+/// insertion does not allocate memory and a lookup reads consecutive entries. Clearing the map
+/// keeps its storage, which makes the map cheap to rebuild in every recognition.
+/// Entries cannot be removed individually.
+// 从分割块ID对到索引的开放寻址（线性探测）哈希表，所有条目存储在一个数组中，清空时保留内存
+class IdPairFlatMap {
+ public:
+  /// \brief Value returned by find() when the key is not in the map. It cannot be used as value.
+  static constexpr size_t kNotFound = std::numeric_limits<size_t>::max();
+
+  /// \brief Initializes a new instance of the IdPairFlatMap class.
+  /// \param expected_size Number of entries that can be inserted without growing the storage.
+  explicit IdPairFlatMap(const size_t expected_size = 0u) { reserve(expected_size); }
+
+  /// \brief Gets the number of entries.
+  inline size_t size() const { return size_; }
+
+  /// \brief Checks if the map is empty.
+  inline bool empty() const { return size_ == 0u; }
+
+  /// \brief Gets the number of entries of the storage, used or not.
+  inline size_t capacity() const { return entries_.size(); }
+
+  /// \brief Removes all the entries. The storage is kept.
+  void clear() {
+    if (size_ == 0u) return;
+    for (Entry& entry : entries_) entry.value = kNotFound;
+    size_ = 0u;
+  }
+
+  /// \brief Grows the storage so that \c expected_size entries can be inserted without growing it
+  /// again. The entries are kept.
+  void reserve(const size_t expected_size) {
+    size_t capacity = kMinCapacity;
+    while (capacity * kMaxLoadNumerator < expected_size * kMaxLoadDenominator) capacity *= 2u;
+    if (capacity > entries_.size()) rehash(capacity);
+  }
+
+  /// \brief Inserts an entry if the key is not in the map yet.
+  /// \param key The key.
+  /// \param value The value. Must be different from \c kNotFound.
+  /// \returns True if the entry was inserted, false if the key was already in the map.
+  bool emplace(const IdPair& key, const size_t value) {
+    DCHECK_NE(value, kNotFound);
+    if ((size_ + 1u) * kMaxLoadDenominator > entries_.size() * kMaxLoadNumerator) {
+      rehash(std::max(kMinCapacity, entries_.size() * 2u));
+    }
+    for (size_t position = getHomePosition(key); ; position = (position + 1u) & mask_) {
+      Entry& entry = entries_[position];
+      if (entry.value == kNotFound) {
+        entry.key = key;
+        entry.value = value;
+        ++size_;
+        return true;
+      }
+      if (entry.key == key) return false;
+    }
+  }
+
+  /// \brief Finds the value associated with a key.
+  /// \returns The value, or \c kNotFound if the key is not in the map.
+  inline size_t find(const IdPair& key) const {
+    if (entries_.empty()) return kNotFound;
+    for (size_t position = getHomePosition(key); ; position = (position + 1u) & mask_) {
+      const Entry& entry = entries_[position];
+      if (entry.value == kNotFound || entry.key == key) return entry.value;
+    }
+  }
+
+  /// \brief Calls function(key, value) for every entry, in storage order.
+  template <typename Function>
+  void forEach(Function function) const {
+    for (const Entry& entry : entries_) {
+      if (entry.value != kNotFound) function(entry.key, entry.value);
+    }
+  }
+
+  /// \brief Exchanges the entries and the storage of two maps.
+  void swap(IdPairFlatMap& other) {
+    entries_.swap(other.entries_);
+    std::swap(mask_, other.mask_);
+    std::swap(size_, other.size_);
+  }
+
+ private:
+  // Entry of the table. Empty entries have the value kNotFound.
+  struct Entry {
+    IdPair key;
+    size_t value = kNotFound;
+  };
+
+  // The table is kept at most half full, so that the probe sequences of missing keys, which are
+  // frequent when looking up new matches, stay short.
+  static constexpr size_t kMinCapacity = 16u;
+  static constexpr size_t kMaxLoadNumerator = 1u;
+  static constexpr size_t kMaxLoadDenominator = 2u;
+
+  inline size_t getHomePosition(const IdPair& key) const {
+    return static_cast<size_t>(hashIdPair(key)) & mask_;
+  }
+
+  // Moves the entries to a table with the given capacity, which must be a power of two.
+  void rehash(const size_t capacity) {
+    DCHECK_EQ(capacity & (capacity - 1u), 0u);
+    std::vector<Entry> old_entries(capacity);
+    old_entries.swap(entries_);
+    mask_ = capacity - 1u;
+    size_ = 0u;
+    for (const Entry& entry : old_entries) {
+      if (entry.value != kNotFound) emplace(entry.key, entry.value);
+    }
+  }
+
+  std::vector<Entry> entries_;
+  size_t mask_ = 0u;
+  size_t size_ = 0u;
+}; // class IdPairFlatMap
+
+} // namespace bron_kerbosch
+
+#endif // ID_PAIR_FLAT_MAP_HPP_
@@ -1,13 +1,19 @@
 #ifndef INCREMENTAL_GEOMETRIC_CONSISTENCY_RECOGNIZER_HPP_
 #define INCREMENTAL_GEOMETRIC_CONSISTENCY_RECOGNIZER_HPP_
 
-#include <unordered_map>
-
-#include <boost/graph/adjacency_list.hpp>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
 
 #include "parameter.h"
+#include "recognizers/CandidateListPool.hpp"
 #include "recognizers/GraphBasedGeometricConsistencyRecognizer.hpp"
+#include "recognizers/IdPairFlatMap.hpp"
+#include "recognizers/MatchCentroids.hpp"
+#include "recognizers/MatchesPartitioner.hpp"
 #include "RecognizerData.h"
+#include "WorkStealingThreadPool.h"
 
 namespace bron_kerbosch {
 
@@ -19,11 +25,63 @@ namespace bron_kerbosch {
 // 在这个增量式的方法中，缓存候选一致性匹配对的信息，在连续的识别步骤中复用
 class IncrementalGeometricConsistencyRecognizer : public GraphBasedGeometricConsistencyRecognizer {
  public:
+  /// \brief Statistics about the reuse of the cache in a recognition.
+  // 一次识别中缓存复用情况的统计
+  struct CacheStatistics {
+    /// \brief Number of predicted matches.
+    size_t num_matches = 0u;
+    /// \brief Number of matches whose cached candidates were reused.
+    size_t num_cached_matches = 0u;
+    /// \brief Number of cached matches that moved too much and were tested again as new matches.
+    size_t num_invalidated_matches = 0u;
+    /// \brief Number of cached matches whose candidates had been evicted for limiting the memory.
+    size_t num_evicted_matches = 0u;
+    /// \brief Number of cached matches whose candidates were not tested again, because the
+    /// matches moved too little for any of their consistencies to change.
+    size_t num_unchanged_matches = 0u;
+    /// \brief Number of consistency tests of the cached pairs.
+    size_t num_cached_pair_tests = 0u;
+    /// \brief Number of consistency tests of the new matches.
+    size_t num_new_pair_tests = 0u;
+    /// \brief Memory allocated for the cached candidates at the end of the recognition, in
+    /// bytes.
+    size_t candidates_memory_bytes = 0u;
+
+    /// \brief Gets the fraction of the matches whose cached candidates were reused.
+    double getHitRate() const {
+      return num_matches == 0u ? 0.0 : double(num_cached_matches) / double(num_matches);
+    }
+    /// \brief Gets the fraction of the matches found in the cache that were invalidated.
+    double getInvalidationRate() const {
+      const size_t num_found_matches = getNumFoundMatches();
+      return num_found_matches == 0u ? 0.0 :
+          double(num_invalidated_matches) / double(num_found_matches);
+    }
+    /// \brief Gets the number of matches found in the cache.
+    size_t getNumFoundMatches() const {
+      return num_cached_matches + num_invalidated_matches + num_evicted_matches;
+    }
+  };
+
   /// \brief Initializes a new instance of the IncrementalGeometricConsistencyRecognizer class.
   /// \param params The parameters of the geometry consistency grouping.
   /// \param max_model_radius Radius of the bounding cylinder of the model.
   IncrementalGeometricConsistencyRecognizer(const GeometricConsistencyParams& params,
-                                            float max_model_radius) noexcept;
+                                            float max_model_radius);
+
+  /// \brief Performs the second stage of a recognition and records the maximum clique found for
+  /// the warm start of the next clique search.
+  /// \param prepared The state of the recognition, filled by prepareRecognition().
+  void completeRecognition(const PreparedRecognition& prepared) override;
+
+  /// \brief Gets the statistics about the reuse of the cache in the last recognition.
+  const CacheStatistics& getCacheStatistics() const { return cache_statistics_; }
+
+  /// \brief Forgets the cached matches, so that the next recognition does not depend on the
+  /// previous ones, e.g. when the recognizer is reused for unrelated scenes. The memory of the
+  /// cache is kept.
+  // 清除缓存的匹配，使下一次识别与之前的识别无关，缓存的内存保留
+  void clearCache();
 
  protected:
   /// \brief Builds a consistency graph of the provided matches.
@@ -36,15 +94,50 @@ class IncrementalGeometricConsistencyRecognizer : public GraphBasedGeometricCons
   // 返回：图编码的成对一致性
   ConsistencyGraph buildConsistencyGraph(const PairwiseMatches& predicted_matches) override;
 
+  /// \brief Updates the consistency graph kept across recognitions, if enabled by the
+  /// parameters. The vertices of the graph are the cache slots, so a match keeps its vertex as
+  /// long as it stays in the cache.
+  /// \param predicted_matches Vector of possible correspondences between model and scene.
+  /// \param vertex_match_indices Vector in which the index of the match represented by every
+  /// vertex of the graph will be stored.
+  /// \returns Pointer to the updated graph, or null if the persistent graph is disabled.
+  // 更新跨帧保留的一致性图，图的顶点为缓存槽
+  const PersistentConsistencyGraph* updatePersistentConsistencyGraph(
+      const PairwiseMatches& predicted_matches,
+      std::vector<size_t>& vertex_match_indices) override;
+
+  /// \brief Gets the matches of the maximum clique of the previous recognition that are still
+  /// present and still pairwise consistent.
+  /// \param predicted_matches Vector of possible correspondences between model and scene.
+  /// \param are_consistent Function checking if two matches are connected in the consistency
+  /// graph.
+  /// \returns Vector containing the indices of the matches forming the clique.
+  // 获取上一次识别的最大团中仍然存在且两两一致的匹配
+  std::vector<size_t> getWarmStartClique(const PairwiseMatches& predicted_matches,
+                                         const ConsistencyTest& are_consistent) override;
+
  private:
   // Per-partition data.
   struct PartitionData { };
 
-  // Structure containing cached information for a match.
-  // 一个匹配的缓存数据
+  // Edges of the consistency graph, collected before the graph is built.
+  typedef std::vector<std::pair<size_t, size_t>> ConsistencyGraphEdges;
+
+  // Structure containing cached information for a match. The candidate consistent matches of the
+  // slot are stored in candidate_lists_. A slot whose candidates were evicted for limiting the
+  // memory is invalidated in the next recognition. The centroids and the cumulative drift at the
+  // last test of the candidates, and the smallest difference between their consistency distances
+  // and the resolution, tell if the candidates must be tested again.
+  // 一个匹配的缓存数据，候选一致匹配存储在 candidate_lists_ 中。候选项上次测试时的质心、
+  // 累计漂移以及一致性距离与分辨率的最小差值，用于判断候选项是否需要重新测试
   struct MatchCacheSlot {
-    std::vector<size_t> candidate_consistent_matches;
     PointPair centroids_at_caching;
+    size_t caching_recognition = 0u;
+    bool evicted = false;
+    PointPair centroids_at_test;
+    PointPair previous_centroids;
+    double cumulative_drift_at_test = 0.0;
+    float consistency_slack = 0.0f;
   };
 
   // Keeps track of the positions of a match in the vector of predicted matches and in the cache.
@@ -56,49 +149,175 @@ class IncrementalGeometricConsistencyRecognizer : public GraphBasedGeometricCons
     size_t cache_slot_index;
   };
 
-  // Computes the consistency distance between two matches, i.e. the difference between the
-  // centroids distances in the scene and in the model.
-  // 计算两个匹配间的一致性距离，即在场景中和模型中质心距离之差
-  float computeConsistencyDistance(const PairwiseMatch& first_match,
-                                   const PairwiseMatch& second_match,
-                                   float max_target_distance) const;
+  // Edges and statistics collected by a stripe of the consistency graph construction. Stripes are
+  // merged in order, so the result does not depend on how the stripes are scheduled.
+  // 一致性图构建中一个条带收集的边和统计，条带按顺序合并，结果与调度无关
+  // New matches store their candidates in the stripe, together with their cache slot and the end
+  // of their candidates, and the lists are moved to candidate_lists_ after the stripes are merged.
+  struct GraphConstructionStripe {
+    ConsistencyGraphEdges edges;
+    ConsistencyGraphEdges removed_edges;
+    std::vector<CandidateListPool::Candidate> candidates;
+    std::vector<std::pair<size_t, size_t>> candidate_list_ends;
+    size_t num_consistency_tests = 0u;
+    size_t num_unchanged_matches = 0u;
+  };
+
+  // Buffers for the batched computation of consistency distances, one per worker.
+  struct ConsistencyDistanceBuffers {
+    std::vector<size_t> candidate_slots;
+    std::vector<float> consistency_distances;
+  };
+
+  // Gets the number of stripes in which the processing of n_items items is divided.
+  size_t getNumGraphConstructionStripes(size_t n_items) const;
+
+  // Executes function(stripe, worker_index) for the first n_stripes stripes, on the thread pool if
+  // available, appends the edges and the removed edges of the stripes in stripe order and adds
+  // their numbers of consistency tests to num_consistency_tests.
+  // 执行各条带的处理（有线程池时并行），按条带顺序合并边
+  void processStripes(size_t n_stripes,
+                      const std::function<void(size_t stripe, size_t worker_index)>& function,
+                      ConsistencyGraphEdges& consistency_graph_edges,
+                      size_t& num_consistency_tests);
+
+  // Updates the cache with the predicted matches and finds the edges of the consistency graph.
+  // The edges are stored in consistency_graph_edges_. With the persistent graph, only the edges
+  // that appeared are stored there, the edges that disappeared are stored in
+  // removed_consistency_graph_edges_ and the cache slots that were released are stored in
+  // released_cache_slot_indices_.
+  // 用预测匹配更新缓存并找到一致性图的边
+  void updateCache(const PairwiseMatches& predicted_matches,
+                   std::vector<size_t>& match_index_to_cache_slot_index);
+
+  // Partitionings available for restricting the consistency tests to nearby matches.
+  enum class MatchesPartitionerType { kGrid, kVoxel };
+
+  // Copies the centroids of the matches in partition order, so that the matches of a partition
+  // occupy a contiguous range of slots, and collects the neighbors of every partition.
+  // 按分区顺序复制匹配的质心，使同一分区的匹配占据连续的槽，并收集每个分区的相邻分区
+  void copyCentroidsInPartitionOrder(const PairwiseMatches& predicted_matches,
+                                     const MatchesFlatGridPartitioning& partitioning);
+  void copyCentroidsInPartitionOrder(const PairwiseMatches& predicted_matches,
+                                     const MatchesVoxelPartitioning<PartitionData>& partitioning);
+
+  // Assigns the slots of the matches once slot_match_indices_ is filled and copies the centroids.
+  void assignMatchSlots(const PairwiseMatches& predicted_matches);
 
   // Processes the predicted matches that are already present in the cache. Cleans up old entries,
-  // finds consistencies and adds them to the consistency graph.
+  // finds consistencies and adds them to the edges of the consistency graph.
   // 处理缓存中已存在的预测匹配，清理旧条目，找到一致性并添加到一致性图
   void processCachedMatches(
       const PairwiseMatches& predicted_matches,
       const std::vector<MatchLocations>& cached_matches_locations,
       const std::vector<size_t>& cache_slot_index_to_match_index,
-      std::unordered_map<IdPair, size_t, IdPairHash>& new_cache_slot_indices,
-      ConsistencyGraph& consistency_graph);
+      IdPairFlatMap& new_cache_slot_indices,
+      ConsistencyGraphEdges& consistency_graph_edges);
 
   // Process the predicted matches that were not present in the cache. Finds consistencies and adds
-  // them to the consistency graph.
+  // them to the edges of the consistency graph.
   // 处理缓存中不存在的预测匹配，找到一致性并添加到一致性图
   void processNewMatches(
       const PairwiseMatches& predicted_matches,
       const std::vector<size_t>& free_cache_slot_indices,
       std::vector<size_t>& match_index_to_cache_slot_index,
-      std::unordered_map<IdPair, size_t, IdPairHash>& new_cache_slot_indices,
-      ConsistencyGraph& consistency_graph);
+      IdPairFlatMap& new_cache_slot_indices,
+      ConsistencyGraphEdges& consistency_graph_edges);
+
+  // Records the IDs of the matches of the maximum clique found, if the warm start is enabled.
+  // 记录找到的最大团中匹配的ID（如果启用热启动）
+  void rememberWarmStartClique();
 
-  // Decide if the match must be invalidated.
-  // 决定匹配是否无效化
+  // Decide if the match must be invalidated. The whole match is invalidated: the pairs that were
+  // not cached with it can only be found again with a neighbor search, which is what testing it as
+  // a new match does. Its cached candidates are skipped by the consistency slack until then.
+  // 决定匹配是否无效化。整个匹配被无效化：未与其一起缓存的匹配对只能通过邻域搜索重新找到，
+  // 这正是将其作为新匹配测试所做的。在此之前，其缓存的候选项由一致性余量跳过
   bool mustRemoveFromCache(const PairwiseMatch& match, size_t cache_slot_index);
 
+  // Bounds the memory of the cache once the cache slots of the current recognition are known:
+  // removes the unused cache slots at the end of the cache after a burst of matches, evicts the
+  // candidates of the slots cached the longest ago while the candidates exceed the memory limit,
+  // and compacts the candidate lists when they are fragmented.
+  // 限制缓存的内存：移除缓存末尾未使用的缓存槽，超出内存上限时逐出最早缓存的槽的候选项，
+  // 并在候选列表碎片化时进行整理
+  void limitCacheMemory(const std::vector<size_t>& match_index_to_cache_slot_index);
+
   // State of the cache.
   // 缓存状态
   std::vector<MatchCacheSlot> matches_cache_;
-  // IdPairHash是自行定义的哈希函数
-  std::unordered_map<IdPair, size_t, IdPairHash> cache_slot_indices_;
+  CandidateListPool candidate_lists_;
+  size_t num_recognitions_ = 0u;
+  CacheStatistics cache_statistics_;
+  // Sum over the recognitions of the largest displacement of a cached match since the previous
+  // recognition. The displacement of a match that stayed in the cache between two recognitions is
+  // bounded by the increase of the cumulative drift.
+  // 各次识别中缓存匹配自上次识别以来最大位移的累加，界定了持续缓存的匹配在两次识别之间的位移
+  double cumulative_drift_ = 0.0;
+  // Cache slots of the matches, by their IDs, and the buffer in which the mapping is rebuilt in
+  // every recognition.
+  // 按ID索引的匹配缓存槽，以及每次识别中重建映射所用的缓冲
+  IdPairFlatMap cache_slot_indices_;
+  IdPairFlatMap new_cache_slot_indices_;
+
+  // IDs of the matches of the maximum clique found in the previous recognition.
+  // 上一次识别找到的最大团中匹配的ID
+  std::vector<IdPair> previous_clique_ids_;
+
+  // Buffer for the edges of the consistency graph, reused across recognitions.
+  ConsistencyGraphEdges consistency_graph_edges_;
+
+  // The consistency graph kept across recognitions, the edges removed from it and the cache slots
+  // released in the last update.
+  // 跨帧保留的一致性图，以及最近一次更新中移除的边和释放的缓存槽
+  PersistentConsistencyGraph persistent_consistency_graph_;
+  ConsistencyGraphEdges removed_consistency_graph_edges_;
+  std::vector<size_t> released_cache_slot_indices_;
+
+  // Centroids of the predicted matches in partition order, the match stored in every slot, the
+  // slot of every match and the first slot of every partition.
+  // 按分区顺序存储的匹配质心，以及槽与匹配之间的映射
+  MatchCentroids match_centroids_;
+  std::vector<size_t> slot_match_indices_;
+  std::vector<size_t> match_slots_;
+  std::vector<size_t> partition_slot_begins_;
+
+  // Neighbors of every partition, including the partition itself. The neighbors of partition p
+  // are partition_neighbors_[partition_neighbor_begins_[p]] to
+  // partition_neighbors_[partition_neighbor_begins_[p + 1] - 1].
+  // 每个分区的相邻分区（包括分区本身）
+  std::vector<size_t> partition_neighbor_begins_;
+  std::vector<size_t> partition_neighbors_;
+
+  // The partitioning of the matches. The grid partitioning is reused across recognitions.
+  MatchesPartitionerType matches_partitioner_type_;
+  MatchesFlatGridPartitioning grid_partitioning_;
+
+  // Whether the match in every slot is new, i.e. not present in the cache. New matches are
+  // compared to the cached matches and to the new matches in previous slots.
+  std::vector<bool> slot_is_new_;
+
+  // Per-stripe results and per-worker buffers of the consistency graph construction.
+  std::vector<GraphConstructionStripe> graph_construction_stripes_;
+  std::vector<ConsistencyDistanceBuffers> consistency_distance_buffers_;
+
+  // Thread pool used for building the consistency graph. Null if the construction is sequential.
+  std::unique_ptr<WorkStealingThreadPool> graph_construction_thread_pool_;
 
   static constexpr size_t kNoMatchIndex_ = std::numeric_limits<size_t>::max();
   static constexpr size_t kNoCacheSlotIndex_ = std::numeric_limits<size_t>::max();
 
   float max_consistency_distance_;
+  // Distance of the scene centroids beyond which the consistency distance of two matches is at
+  // least the excess of their scene distance. Pairs farther than max_consistency_distance_ in the
+  // scene are inconsistent, and their consistency distance changes continuously when the matches
+  // move, so that the consistency slack of the cached candidates also covers that limit.
+  float max_scene_distance_;
   float max_consistency_distance_for_caching_;
   float half_max_consistency_distance_for_caching_;
+  // Margin added to the change of the consistency distances of cached pairs, covering the
+  // rounding errors of the distances.
+  float consistency_slack_margin_;
 }; // class IncrementalGeometricConsistencyRecognizer
 
 } // namespace bron_kerbosch
@@ -0,0 +1,70 @@
+#ifndef MATCH_CENTROIDS_HPP_
+#define MATCH_CENTROIDS_HPP_
+
+#include <vector>
+
+#include "RecognizerData.h"
+
+namespace bron_kerbosch {
+
+/// \brief Model and scene centroids of a set of matches stored as a structure of arrays, so that
+/// the consistency distances between a match and many other matches can be computed with SIMD
+/// instructions. The kernels use AVX-512, AVX or SSE2 depending on the instruction sets enabled
+/// at compile time, with a scalar fallback. The default x86-64 flags only enable SSE2: the AVX and
+/// AVX-512 kernels are compiled only with -march=native (CMake option ENABLE_NATIVE_ARCH) or
+/// equivalent flags.
+// 以数组结构（SoA）存储一组匹配的模型和场景质心，便于用SIMD指令批量计算一致性距离
+class MatchCentroids {
+ public:
+  /// \brief Copies the centroids of a subset of matches. Previously allocated memory is reused.
+  /// \param matches The matches.
+  /// \param match_indices Indices of the matches to be copied. The centroids of match
+  /// \c matches[match_indices[i]] are stored in slot \c i .
+  // 复制一组匹配的质心，匹配 matches[match_indices[i]] 存储在槽 i 中
+  void assign(const PairwiseMatches& matches, const std::vector<size_t>& match_indices);
+
+  /// \brief Gets the number of slots.
+  inline size_t size() const { return model_x_.size(); }
+
+  /// \brief Computes the consistency distances between a match and the matches in a range of
+  /// slots. The consistency distance is the difference between the distances of the centroids in
+  /// the scene and in the model, or the excess of the scene distance over \c max_scene_distance
+  /// if that is larger. It changes by at most the displacements of the centroids of the two
+  /// matches, also for matches whose scene centroids are too far from each other to be consistent.
+  /// \param slot Slot of the match.
+  /// \param begin First slot of the range.
+  /// \param end Slot after the last slot of the range.
+  /// \param max_scene_distance Distance of the centroids in the scene beyond which the excess of
+  /// the scene distance bounds the consistency distance from below. Matches whose scene centroids
+  /// are farther than \c max_scene_distance plus the resolution cannot be consistent.
+  /// \param distances Array in which the \c end - \c begin distances will be stored.
+  // 计算一个匹配与连续槽范围内的匹配之间的一致性距离
+  void computeConsistencyDistances(size_t slot, size_t begin, size_t end,
+                                   float max_scene_distance, float* distances) const;
+
+  /// \brief Computes the consistency distances between a match and the matches in a list of
+  /// slots. The centroids of the listed matches are gathered in blocks before the distances are
+  /// computed.
+  /// \param slot Slot of the match.
+  /// \param candidate_slots Slots of the other matches.
+  /// \param max_scene_distance Distance of the centroids in the scene beyond which the excess of
+  /// the scene distance bounds the consistency distance from below.
+  /// \param distances Array in which the distances will be stored, in the order of
+  /// \c candidate_slots .
+  // 计算一个匹配与槽列表中的匹配之间的一致性距离，先分块收集质心再计算
+  void computeConsistencyDistances(size_t slot, const std::vector<size_t>& candidate_slots,
+                                   float max_scene_distance, float* distances) const;
+
+ private:
+  // Coordinates of the centroids.
+  std::vector<float> model_x_;
+  std::vector<float> model_y_;
+  std::vector<float> model_z_;
+  std::vector<float> scene_x_;
+  std::vector<float> scene_y_;
+  std::vector<float> scene_z_;
+}; // class MatchCentroids
+
+} // namespace bron_kerbosch
+
+#endif // MATCH_CENTROIDS_HPP_
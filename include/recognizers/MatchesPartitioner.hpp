@@ -1,6 +1,15 @@
 #ifndef MATCHES_PARTITIONER_HPP_
 #define MATCHES_PARTITIONER_HPP_
 
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include <Eigen/Core>
+#include <glog/logging.h>
+
 #include "RecognizerData.h"
 
 namespace bron_kerbosch {
@@ -61,6 +70,172 @@ class MatchesGridPartitioning {
   std::vector<Partition> partitions_;
 };
 
+/// \brief Describes the grid partitioning of a set of matches with a flat layout: the indices of
+/// the matches are stored in a single array sorted by partition, and an array of offsets gives
+/// the range of the indices of each partition, similarly to a compressed sparse row matrix.
+/// Partitions are numbered in row-major order. Scanning the matches of neighbor partitions reads
+/// contiguous memory, and the memory is reused when a new set of matches is partitioned.
+// 以扁平布局描述一组匹配的栅格分割：匹配索引按分区排序存储在一个数组中，偏移数组给出每个分区的索引范围
+class MatchesFlatGridPartitioning {
+ public:
+  /// \brief Gets the number of partitions along the x axis.
+  inline size_t getWidth() const { return width_; }
+
+  /// \brief Gets the number of partitions along the y axis.
+  inline size_t getHeight() const { return height_; }
+
+  /// \brief Gets the number of partitions.
+  inline size_t getNumPartitions() const { return width_ * height_; }
+
+  /// \brief Gets the index of partition (i, j).
+  /// \param i Index of the partition on the y axis.
+  /// \param j Index of the partition on the x axis.
+  inline size_t getPartitionIndex(const size_t i, const size_t j) const { return i * width_ + j; }
+
+  /// \brief Gets the indices of the matches, sorted by partition. Within a partition the indices
+  /// are in increasing order.
+  inline const std::vector<size_t>& getMatchIndices() const { return match_indices_; }
+
+  /// \brief Gets the offsets of the partitions. The indices of the matches of partition \c p are
+  /// stored from \c getMatchIndices()[getPartitionOffsets()[p]] to
+  /// \c getMatchIndices()[getPartitionOffsets()[p + 1] - 1].
+  inline const std::vector<size_t>& getPartitionOffsets() const { return partition_offsets_; }
+
+ private:
+  friend class MatchesPartitioner;
+
+  // Properties of the grid.
+  size_t width_ = 0u;
+  size_t height_ = 0u;
+
+  // Indices of the matches sorted by partition and offsets of the partitions.
+  std::vector<size_t> match_indices_;
+  std::vector<size_t> partition_offsets_;
+
+  // Partition of every match, used while partitioning.
+  std::vector<size_t> match_partitions_;
+}; // class MatchesFlatGridPartitioning
+
+/// \brief Integer coordinates of a voxel.
+// 体素的整数坐标
+struct VoxelCoordinates {
+  std::int64_t x;
+  std::int64_t y;
+  std::int64_t z;
+
+  inline bool operator==(const VoxelCoordinates& other) const {
+    return x == other.x && y == other.y && z == other.z;
+  }
+};
+
+/// \brief Hash function for voxel coordinates.
+struct VoxelCoordinatesHash {
+  inline size_t operator()(const VoxelCoordinates& coordinates) const {
+    return static_cast<size_t>(coordinates.x * 73856093) ^
+        static_cast<size_t>(coordinates.y * 19349663) ^
+        static_cast<size_t>(coordinates.z * 83492791);
+  }
+};
+
+/// \brief Describes the partitioning of a set of matches in a sparse set of cubic voxels. Only
+/// the occupied voxels are stored, in a hash table indexed by the voxel coordinates, so the memory
+/// is proportional to the number of occupied voxels independently of the extent of the matches.
+/// Each partition stores the indices of the elements belonging to it, the indices of the occupied
+/// neighbor partitions and custom partition data.
+// 描述一组匹配在稀疏立方体素中的分割，只存储被占据的体素，内存与被占据的体素数量成正比
+template <typename PartitionData>
+class MatchesVoxelPartitioning {
+ public:
+  /// \brief A voxel of the partitioning. Contains indices of the matches, indices of the
+  /// neighbor partitions and custom partition data.
+  // 一个体素分割块，包含匹配索引、相邻分割索引和数据
+  struct Partition {
+    /// \brief Indices of the matches belonging to the partition.
+    std::vector<size_t> match_indices;
+    /// \brief Indices of the occupied partitions among the 3x3x3 voxels centered on this
+    /// partition, including the partition itself, in increasing (z, y, x) order.
+    std::vector<size_t> neighbor_partitions;
+    /// \brief Custom partition data.
+    PartitionData data;
+  };
+
+  /// \brief Value returned by findPartition() when the voxel is not occupied.
+  static constexpr size_t kNoPartition = std::numeric_limits<size_t>::max();
+
+  /// \brief Gets the number of occupied partitions.
+  inline size_t getNumPartitions() const { return partitions_.size(); }
+
+  /// \brief Gets or sets the data of a partition.
+  /// \param index Index of the partition.
+  /// \returns Reference to the partition data.
+  inline Partition& operator[] (const size_t index) { return partitions_[index]; }
+
+  /// \brief Gets the data of a partition.
+  /// \param index Index of the partition.
+  /// \returns Constant reference to the partition data.
+  inline const Partition& operator[] (const size_t index) const { return partitions_[index]; }
+
+  /// \brief Gets the coordinates of the voxel of a partition.
+  /// \param index Index of the partition.
+  /// \returns The voxel coordinates.
+  inline const VoxelCoordinates& getCoordinates(const size_t index) const {
+    return coordinates_[index];
+  }
+
+  /// \brief Finds the partition of a voxel in constant expected time.
+  /// \param coordinates Coordinates of the voxel.
+  /// \returns Index of the partition, or \c kNoPartition if the voxel is not occupied.
+  inline size_t findPartition(const VoxelCoordinates& coordinates) const {
+    const auto it = partition_indices_.find(coordinates);
+    return it == partition_indices_.end() ? kNoPartition : it->second;
+  }
+
+  /// \brief Gets the partition of a voxel, adding an empty partition if the voxel is not
+  /// occupied.
+  /// \param coordinates Coordinates of the voxel.
+  /// \returns Reference to the partition data.
+  // 获取体素的分割，体素未被占据时添加一个空分割
+  Partition& findOrAddPartition(const VoxelCoordinates& coordinates) {
+    const auto inserted = partition_indices_.emplace(coordinates, partitions_.size());
+    if (inserted.second) {
+      partitions_.emplace_back();
+      coordinates_.push_back(coordinates);
+    }
+    return partitions_[inserted.first->second];
+  }
+
+  /// \brief Fills the neighbor partitions of every partition. Must be called after all the
+  /// partitions have been added.
+  // 填充每个分割的相邻分割，需要在添加所有分割后调用
+  void linkNeighborPartitions() {
+    for (size_t index = 0u; index < partitions_.size(); ++index) {
+      const VoxelCoordinates& center = coordinates_[index];
+      std::vector<size_t>& neighbor_partitions = partitions_[index].neighbor_partitions;
+      neighbor_partitions.clear();
+      for (std::int64_t dz = -1; dz <= 1; ++dz) {
+        for (std::int64_t dy = -1; dy <= 1; ++dy) {
+          for (std::int64_t dx = -1; dx <= 1; ++dx) {
+            const size_t neighbor_index =
+                findPartition({ center.x + dx, center.y + dy, center.z + dz });
+            if (neighbor_index != kNoPartition) neighbor_partitions.push_back(neighbor_index);
+          }
+        }
+      }
+    }
+  }
+
+ private:
+  // The partition data and the coordinates of the voxels.
+  std::vector<Partition> partitions_;
+  std::vector<VoxelCoordinates> coordinates_;
+
+  // Index of the partition of every occupied voxel.
+  std::unordered_map<VoxelCoordinates, size_t, VoxelCoordinatesHash> partition_indices_;
+};
+
+template <typename PartitionData>
+constexpr size_t MatchesVoxelPartitioning<PartitionData>::kNoPartition;
+
 /// \brief Provides helper methods for partitioning matches.
 class MatchesPartitioner {
  public:
@@ -78,6 +253,38 @@ class MatchesPartitioner {
   template <typename PartitionData>
   static MatchesGridPartitioning<PartitionData> computeGridPartitioning(
       const PairwiseMatches& matches, float partition_size);
+
+  /// \brief Partition the given set of matches in a grid of squared subdivisions with a flat
+  /// layout. The partitioning is built with a two-pass counting sort: the matches of every
+  /// partition are counted, and the indices are then written at the offsets given by the prefix
+  /// sums of the counts. Memory previously allocated by \c partitioning is reused.
+  /// \param matches The matches that need to be partitioned.
+  /// \param partition_size Size of one partition of the grid.
+  /// \param partitioning The computed partitioning.
+  // 用两遍计数排序将给定的匹配集划分到扁平布局的栅格中，复用已分配的内存
+  static void computeFlatGridPartitioning(const PairwiseMatches& matches, float partition_size,
+                                          MatchesFlatGridPartitioning& partitioning);
+
+  /// \brief Computes the order of the matches along a Z-order (Morton) curve of the scene
+  /// centroids. The centroids are quantized to 21 bits per axis over their bounding box and the
+  /// bits of the three coordinates are interleaved. Matches that are close in the scene are
+  /// mostly close in this order. Ties are broken by the index of the matches.
+  /// \param matches The matches that need to be ordered.
+  /// \param order Vector in which the indices of the matches will be stored, in Morton order.
+  // 计算匹配沿场景质心Z序（Morton）曲线的顺序
+  static void computeMortonOrder(const PairwiseMatches& matches, std::vector<size_t>& order);
+
+  /// \brief Partition the given set of matches in a sparse set of cubic voxels, using the 3D
+  /// positions of the scene centroids. Unlike the grid partitioning, the memory does not depend on
+  /// the extent of the matches and matches at different heights are separated.
+  /// \param matches The matches that need to be partitioned.
+  /// \param partition_size Size of one voxel.
+  /// \return The computed partitioning. Partitions are stored in the order in which their voxels
+  /// are first occupied by the matches.
+  // 使用场景质心的3D位置，将给定的匹配集划分到稀疏的立方体素中
+  template <typename PartitionData>
+  static MatchesVoxelPartitioning<PartitionData> computeVoxelPartitioning(
+      const PairwiseMatches& matches, float partition_size);
 }; // class MatchesPartitioner
 
 //=================================================================================================
@@ -129,6 +336,30 @@ MatchesGridPartitioning<PartitionData> MatchesPartitioner::computeGridPartitioni
   return partitioning;
 }
 
+template <typename PartitionData>
+MatchesVoxelPartitioning<PartitionData> MatchesPartitioner::computeVoxelPartitioning(
+    const PairwiseMatches& matches, const float partition_size) {
+
+  // Validate inputs.
+  CHECK_GT(partition_size, 0.0f);
+
+  // Assign the matches to their voxels.
+  // 将匹配分配到相应体素
+  const float partition_size_inv = 1.0f / partition_size;
+  MatchesVoxelPartitioning<PartitionData> partitioning;
+  for (size_t i = 0; i < matches.size(); ++i) {
+    const PclPoint& scene_centroid = matches[i].centroids_.second;
+    const VoxelCoordinates coordinates = {
+      static_cast<std::int64_t>(std::floor(scene_centroid.x * partition_size_inv)),
+      static_cast<std::int64_t>(std::floor(scene_centroid.y * partition_size_inv)),
+      static_cast<std::int64_t>(std::floor(scene_centroid.z * partition_size_inv)) };
+    partitioning.findOrAddPartition(coordinates).match_indices.push_back(i);
+  }
+  partitioning.linkNeighborPartitions();
+
+  return partitioning;
+}
+
 } // namespace segmatch
 
 #endif // PARTITIONER_HPP_
@@ -0,0 +1,288 @@
+#ifndef SORTED_ADJACENCY_GRAPH_HPP_
+#define SORTED_ADJACENCY_GRAPH_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/property_map/property_map.hpp>
+#include <glog/logging.h>
+
+#include "recognizers/CompressedSparseRowGraph.hpp"
+
+namespace bron_kerbosch {
+
+/// \brief Mutable undirected graph storing the neighbors of every vertex in a sorted vector.
+/// Vertices can be added and edges can be added and removed in place, while iterating the
+/// neighbors and testing whether two vertices are adjacent are as fast as with
+/// CompressedSparseRowGraph: the neighbors are contiguous and adjacency is a binary search.
+/// Adding or removing an edge costs a shift of the neighbors of its two vertices, which is cheap
+/// when few edges change between two updates.
+/// The graph models the same Boost Graph Library concepts as CompressedSparseRowGraph and uses its
+/// edge descriptors and out-edge iterators, so that it can be used with GraphUtilities.
+// 可变无向图：每个顶点的邻居存储在有序数组中，可原地增删边，邻居遍历和邻接测试与CSR图同样快
+class SortedAdjacencyGraph {
+ public:
+  /// \brief Type used for storing the neighbors.
+  typedef CompressedSparseRowGraph::StoredVertex StoredVertex;
+
+  // Types required by boost::graph_traits.
+  typedef size_t vertex_descriptor;
+  typedef size_t vertices_size_type;
+  typedef size_t edges_size_type;
+  typedef size_t degree_size_type;
+  typedef boost::undirected_tag directed_category;
+  typedef boost::disallow_parallel_edge_tag edge_parallel_category;
+  typedef CompressedSparseRowGraph::traversal_category traversal_category;
+  typedef CompressedSparseRowGraph::edge_descriptor edge_descriptor;
+  typedef CompressedSparseRowGraph::vertex_iterator vertex_iterator;
+  typedef CompressedSparseRowGraph::out_edge_iterator out_edge_iterator;
+
+  /// \brief Iterator on the edges of the graph. Every undirected edge is visited once, from its
+  /// vertex with the smaller index.
+  class edge_iterator : public boost::iterator_facade<
+      edge_iterator, edge_descriptor, std::forward_iterator_tag, edge_descriptor> {
+   public:
+    edge_iterator() = default;
+    edge_iterator(const SortedAdjacencyGraph& graph, const size_t source)
+      : graph_(&graph), source_(source) {
+      if (source_ < graph_->getNumVertices()) {
+        position_ = graph_->getUpperNeighborsBegin(source_);
+        skipExhaustedVertices();
+      }
+    }
+
+   private:
+    friend class boost::iterator_core_access;
+    edge_descriptor dereference() const {
+      return edge_descriptor(source_, graph_->neighbors_[source_][position_]);
+    }
+    bool equal(const edge_iterator& other) const {
+      return source_ == other.source_ && (source_ == graph_->getNumVertices() ||
+                                          position_ == other.position_);
+    }
+    void increment() {
+      ++position_;
+      skipExhaustedVertices();
+    }
+
+    // Moves to the first vertex that has neighbors with a bigger index left to visit.
+    void skipExhaustedVertices() {
+      while (position_ == graph_->neighbors_[source_].size()) {
+        if (++source_ == graph_->getNumVertices()) return;
+        position_ = graph_->getUpperNeighborsBegin(source_);
+      }
+    }
+
+    const SortedAdjacencyGraph* graph_ = nullptr;
+    size_t source_ = 0u;
+    size_t position_ = 0u;
+  };
+
+  /// \brief Initializes a new instance of the SortedAdjacencyGraph class.
+  /// \param num_vertices Number of vertices of the graph. The graph is initialized without edges.
+  explicit SortedAdjacencyGraph(const size_t num_vertices = 0u) {
+    resize(num_vertices);
+  }
+
+  /// \brief Changes the number of vertices of the graph. Added vertices have no edges. When the
+  /// graph shrinks, the removed vertices must not have edges.
+  /// \param num_vertices New number of vertices of the graph.
+  void resize(const size_t num_vertices) {
+    CHECK_LE(num_vertices, std::numeric_limits<StoredVertex>::max());
+    for (size_t i = num_vertices; i < neighbors_.size(); ++i) DCHECK(neighbors_[i].empty());
+    neighbors_.resize(num_vertices);
+  }
+
+  /// \brief Adds an edge to the graph.
+  /// \returns True if the edge was added, false if the vertices were already adjacent.
+  bool addEdge(const size_t first_vertex, const size_t second_vertex) {
+    DCHECK_NE(first_vertex, second_vertex);
+    if (!insertNeighbor(first_vertex, second_vertex)) return false;
+    insertNeighbor(second_vertex, first_vertex);
+    ++num_edges_;
+    return true;
+  }
+
+  /// \brief Removes an edge from the graph.
+  /// \returns True if the edge was removed, false if the vertices were not adjacent.
+  bool removeEdge(const size_t first_vertex, const size_t second_vertex) {
+    if (!eraseNeighbor(first_vertex, second_vertex)) return false;
+    eraseNeighbor(second_vertex, first_vertex);
+    --num_edges_;
+    return true;
+  }
+
+  /// \brief Removes all the edges of a vertex.
+  void clearVertex(const size_t vertex) {
+    for (const StoredVertex neighbor : neighbors_[vertex]) eraseNeighbor(neighbor, vertex);
+    num_edges_ -= neighbors_[vertex].size();
+    neighbors_[vertex].clear();
+  }
+
+  /// \brief Gets the number of vertices of the graph.
+  inline size_t getNumVertices() const { return neighbors_.size(); }
+
+  /// \brief Gets the number of edges of the graph.
+  inline size_t getNumEdges() const { return num_edges_; }
+
+  /// \brief Gets the degree of a vertex.
+  inline size_t getDegree(const size_t vertex) const { return neighbors_[vertex].size(); }
+
+  /// \brief Gets the neighbors of a vertex, sorted in increasing order.
+  /// \returns Pair of pointers to the first neighbor and after the last neighbor.
+  inline std::pair<const StoredVertex*, const StoredVertex*> getNeighbors(
+      const size_t vertex) const {
+    const std::vector<StoredVertex>& neighbors = neighbors_[vertex];
+    return std::make_pair(neighbors.data(), neighbors.data() + neighbors.size());
+  }
+
+  /// \brief Checks if two vertices are adjacent. The neighbors of the vertex with the lower degree
+  /// are binary searched.
+  inline bool areAdjacent(const size_t first_vertex, const size_t second_vertex) const {
+    const bool search_first = getDegree(first_vertex) <= getDegree(second_vertex);
+    const std::vector<StoredVertex>& neighbors =
+        neighbors_[search_first ? first_vertex : second_vertex];
+    const StoredVertex value = static_cast<StoredVertex>(search_first ? second_vertex :
+                                                                        first_vertex);
+
+    // Branchless binary search, as in CompressedSparseRowGraph.
+    const StoredVertex* base = neighbors.data();
+    size_t length = neighbors.size();
+    if (length == 0u) return false;
+    while (length > 1u) {
+      const size_t half = length / 2u;
+      base = base[half] <= value ? base + half : base;
+      length -= half;
+    }
+    return *base == value;
+  }
+
+  /// \brief Gets the null vertex, as required by boost::graph_traits.
+  static vertex_descriptor null_vertex() { return std::numeric_limits<size_t>::max(); }
+
+ private:
+  // Inserts a neighbor in the sorted neighbors of a vertex. Returns false if it was present.
+  inline bool insertNeighbor(const size_t vertex, const size_t neighbor) {
+    std::vector<StoredVertex>& neighbors = neighbors_[vertex];
+    const StoredVertex value = static_cast<StoredVertex>(neighbor);
+    const auto position = std::lower_bound(neighbors.begin(), neighbors.end(), value);
+    if (position != neighbors.end() && *position == value) return false;
+    neighbors.insert(position, value);
+    return true;
+  }
+
+  // Erases a neighbor from the sorted neighbors of a vertex. Returns false if it was absent.
+  inline bool eraseNeighbor(const size_t vertex, const size_t neighbor) {
+    std::vector<StoredVertex>& neighbors = neighbors_[vertex];
+    const StoredVertex value = static_cast<StoredVertex>(neighbor);
+    const auto position = std::lower_bound(neighbors.begin(), neighbors.end(), value);
+    if (position == neighbors.end() || *position != value) return false;
+    neighbors.erase(position);
+    return true;
+  }
+
+  // Gets the position of the first neighbor of a vertex with a bigger index.
+  inline size_t getUpperNeighborsBegin(const size_t vertex) const {
+    const std::vector<StoredVertex>& neighbors = neighbors_[vertex];
+    return std::upper_bound(neighbors.begin(), neighbors.end(),
+                            static_cast<StoredVertex>(vertex)) - neighbors.begin();
+  }
+
+  // Sorted neighbors of every vertex.
+  std::vector<std::vector<StoredVertex>> neighbors_;
+  size_t num_edges_ = 0u;
+}; // class SortedAdjacencyGraph
+
+// Boost Graph Library interface, see CompressedSparseRowGraph.
+inline size_t num_vertices(const SortedAdjacencyGraph& graph) {
+  return graph.getNumVertices();
+}
+
+inline size_t num_edges(const SortedAdjacencyGraph& graph) {
+  return graph.getNumEdges();
+}
+
+inline std::pair<SortedAdjacencyGraph::vertex_iterator, SortedAdjacencyGraph::vertex_iterator>
+vertices(const SortedAdjacencyGraph& graph) {
+  typedef SortedAdjacencyGraph::vertex_iterator VertexIterator;
+  return std::make_pair(VertexIterator(0u), VertexIterator(graph.getNumVertices()));
+}
+
+inline std::pair<SortedAdjacencyGraph::out_edge_iterator,
+                 SortedAdjacencyGraph::out_edge_iterator>
+out_edges(const size_t vertex, const SortedAdjacencyGraph& graph) {
+  typedef SortedAdjacencyGraph::out_edge_iterator OutEdgeIterator;
+  const auto neighbors = graph.getNeighbors(vertex);
+  return std::make_pair(OutEdgeIterator(vertex, neighbors.first),
+                        OutEdgeIterator(vertex, neighbors.second));
+}
+
+inline size_t out_degree(const size_t vertex, const SortedAdjacencyGraph& graph) {
+  return graph.getDegree(vertex);
+}
+
+inline size_t degree(const size_t vertex, const SortedAdjacencyGraph& graph) {
+  return graph.getDegree(vertex);
+}
+
+inline std::pair<SortedAdjacencyGraph::edge_iterator, SortedAdjacencyGraph::edge_iterator>
+edges(const SortedAdjacencyGraph& graph) {
+  typedef SortedAdjacencyGraph::edge_iterator EdgeIterator;
+  return std::make_pair(EdgeIterator(graph, 0u), EdgeIterator(graph, graph.getNumVertices()));
+}
+
+inline size_t source(const SortedAdjacencyGraph::edge_descriptor& edge,
+                     const SortedAdjacencyGraph&) {
+  return edge.source;
+}
+
+inline size_t target(const SortedAdjacencyGraph::edge_descriptor& edge,
+                     const SortedAdjacencyGraph&) {
+  return edge.target;
+}
+
+inline std::pair<SortedAdjacencyGraph::edge_descriptor, bool> edge(
+    const size_t first_vertex, const size_t second_vertex, const SortedAdjacencyGraph& graph) {
+  return std::make_pair(SortedAdjacencyGraph::edge_descriptor(first_vertex, second_vertex),
+                        graph.areAdjacent(first_vertex, second_vertex));
+}
+
+} // namespace bron_kerbosch
+
+namespace boost {
+
+template<>
+struct property_map<bron_kerbosch::SortedAdjacencyGraph, vertex_index_t> {
+  typedef typed_identity_property_map<size_t> type;
+  typedef type const_type;
+};
+
+inline typed_identity_property_map<size_t> get(vertex_index_t,
+                                               const bron_kerbosch::SortedAdjacencyGraph&) {
+  return typed_identity_property_map<size_t>();
+}
+
+// The using-declarations only bring the overloads declared before them, so they are repeated
+// after the overloads for SortedAdjacencyGraph.
+using bron_kerbosch::num_vertices;
+using bron_kerbosch::num_edges;
+using bron_kerbosch::vertices;
+using bron_kerbosch::out_edges;
+using bron_kerbosch::out_degree;
+using bron_kerbosch::degree;
+using bron_kerbosch::edges;
+using bron_kerbosch::source;
+using bron_kerbosch::target;
+using bron_kerbosch::edge;
+
+} // namespace boost
+
+#endif // SORTED_ADJACENCY_GRAPH_HPP_
@@ -0,0 +1,128 @@
+#include "WorkStealingThreadPool.h"
+
+#include <glog/logging.h>
+
+namespace bron_kerbosch {
+
+constexpr size_t WorkStealingThreadPool::kNotAWorker;
+
+namespace {
+// Pool and index of the worker running on the current thread.
+thread_local const WorkStealingThreadPool* current_pool = nullptr;
+thread_local size_t current_worker_index = WorkStealingThreadPool::kNotAWorker;
+} // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(const size_t num_threads)
+  : num_queued_tasks_(0u), next_queue_(0u) {
+  CHECK_GT(num_threads, 0u);
+  queues_.reserve(num_threads);
+  for (size_t i = 0u; i < num_threads; ++i) queues_.emplace_back(new WorkerQueue());
+  workers_.reserve(num_threads);
+  for (size_t i = 0u; i < num_threads; ++i) {
+    workers_.emplace_back(&WorkStealingThreadPool::workerLoop, this, i);
+  }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    stop_ = true;
+  }
+  wake_condition_.notify_all();
+  for (auto& worker : workers_) worker.join();
+}
+
+size_t WorkStealingThreadPool::getCurrentWorkerIndex() const {
+  return current_pool == this ? current_worker_index : kNotAWorker;
+}
+
+void WorkStealingThreadPool::parallelFor(
+    const size_t begin, const size_t end,
+    const std::function<void(size_t index, size_t worker_index)>& function) {
+  if (begin >= end) return;
+
+  // Nested loops are executed sequentially, so that the worker is not blocked waiting for tasks
+  // that only it could execute.
+  const size_t worker_index = getCurrentWorkerIndex();
+  if (worker_index != kNotAWorker) {
+    for (size_t i = begin; i < end; ++i) function(i, worker_index);
+    return;
+  }
+
+  std::mutex done_mutex;
+  std::condition_variable done_condition;
+  size_t num_remaining = end - begin;
+  for (size_t i = begin; i < end; ++i) {
+    enqueue([&, i](size_t task_worker_index) {
+      function(i, task_worker_index);
+      std::lock_guard<std::mutex> lock(done_mutex);
+      if (--num_remaining == 0u) done_condition.notify_all();
+    });
+  }
+
+  std::unique_lock<std::mutex> lock(done_mutex);
+  done_condition.wait(lock, [&] { return num_remaining == 0u; });
+}
+
+void WorkStealingThreadPool::enqueue(Task task) {
+  size_t queue_index = getCurrentWorkerIndex();
+  if (queue_index == kNotAWorker) queue_index = next_queue_++ % queues_.size();
+  {
+    std::lock_guard<std::mutex> lock(queues_[queue_index]->mutex);
+    queues_[queue_index]->tasks.push_back(std::move(task));
+  }
+  {
+    // Increment under the wake mutex so that idle workers cannot miss the notification.
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    ++num_queued_tasks_;
+  }
+  wake_condition_.notify_one();
+}
+
+bool WorkStealingThreadPool::tryGetTask(const size_t worker_index, Task& task) {
+  // Take the most recent task from the own queue.
+  {
+    WorkerQueue& queue = *queues_[worker_index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      --num_queued_tasks_;
+      return true;
+    }
+  }
+
+  // Steal the oldest task from the other queues.
+  for (size_t i = 1u; i < queues_.size(); ++i) {
+    WorkerQueue& queue = *queues_[(worker_index + i) % queues_.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      --num_queued_tasks_;
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingThreadPool::workerLoop(const size_t worker_index) {
+  current_pool = this;
+  current_worker_index = worker_index;
+
+  Task task;
+  while (true) {
+    if (tryGetTask(worker_index, task)) {
+      task(worker_index);
+      task = nullptr;
+      continue;
+    }
+
+    // Sleep until new tasks are available or the pool is stopped.
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    wake_condition_.wait(lock, [this] { return stop_ || num_queued_tasks_ > 0u; });
+    if (stop_ && num_queued_tasks_ == 0u) return;
+  }
+}
+
+} // namespace bron_kerbosch
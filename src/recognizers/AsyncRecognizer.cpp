@@ -0,0 +1,128 @@
+#include "recognizers/AsyncRecognizer.hpp"
+
+#include <utility>
+
+#include <glog/logging.h>
+#include "Benchmark.h"
+
+namespace bron_kerbosch {
+
+constexpr size_t AsyncRecognizer::kNumPreparedFrameBuffers;
+
+AsyncRecognizer::AsyncRecognizer(const GeometricConsistencyParams& params,
+                                 const float max_model_radius, const size_t max_queued_frames,
+                                 const QueueFullPolicy queue_full_policy)
+  : recognizer_(params, max_model_radius)
+  , max_queued_frames_(max_queued_frames)
+  , queue_full_policy_(queue_full_policy)
+  , max_prepared_frames_(params.enable_persistent_consistency_graph ?
+                         1u : kNumPreparedFrameBuffers) {
+  CHECK_GT(max_queued_frames, 0u);
+  prepare_thread_ = std::thread(&AsyncRecognizer::prepareLoop, this);
+  complete_thread_ = std::thread(&AsyncRecognizer::completeLoop, this);
+}
+
+AsyncRecognizer::~AsyncRecognizer() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  condition_.notify_all();
+  prepare_thread_.join();
+  complete_thread_.join();
+}
+
+std::future<AsyncRecognizer::Result> AsyncRecognizer::submit(PairwiseMatches predicted_matches) {
+  QueuedFrame frame;
+  frame.predicted_matches = std::move(predicted_matches);
+  std::future<Result> result = frame.result.get_future();
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    CHECK(!stop_);
+    if (queued_frames_.size() >= max_queued_frames_) {
+      if (queue_full_policy_ == QueueFullPolicy::kBlock) {
+        condition_.wait(lock, [&] { return queued_frames_.size() < max_queued_frames_; });
+      } else {
+        Result dropped_result;
+        dropped_result.dropped = true;
+        queued_frames_.front().result.set_value(std::move(dropped_result));
+        queued_frames_.pop_front();
+        ++num_dropped_frames_;
+      }
+    }
+    queued_frames_.push_back(std::move(frame));
+  }
+  condition_.notify_all();
+  return result;
+}
+
+size_t AsyncRecognizer::getNumDroppedFrames() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_dropped_frames_;
+}
+
+void AsyncRecognizer::prepareLoop() {
+  while (true) {
+    // Wait for a frame and for a free buffer.
+    // 等待一帧和一个空闲缓冲
+    QueuedFrame frame;
+    PreparedFrame* prepared_frame;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      condition_.wait(lock, [&] {
+        return (stop_ && queued_frames_.empty()) ||
+            (!queued_frames_.empty() && num_prepared_frames_ < max_prepared_frames_);
+      });
+      if (queued_frames_.empty()) {
+        prepare_stage_done_ = true;
+        break;
+      }
+      frame = std::move(queued_frames_.front());
+      queued_frames_.pop_front();
+      prepared_frame = &prepared_frames_[(first_prepared_frame_ + num_prepared_frames_) %
+                                         kNumPreparedFrameBuffers];
+    }
+    // Wake up the callers blocked on a full queue.
+    condition_.notify_all();
+
+    // The buffer is not used by the other stage until the frame is counted as prepared.
+    prepared_frame->predicted_matches = std::move(frame.predicted_matches);
+    recognizer_.prepareRecognition(prepared_frame->predicted_matches, prepared_frame->prepared);
+    prepared_frame->result = std::move(frame.result);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++num_prepared_frames_;
+    }
+    condition_.notify_all();
+  }
+  condition_.notify_all();
+}
+
+void AsyncRecognizer::completeLoop() {
+  while (true) {
+    // Wait for a prepared frame.
+    // 等待一帧准备好的识别
+    PreparedFrame* prepared_frame;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      condition_.wait(lock, [&] { return num_prepared_frames_ > 0u || prepare_stage_done_; });
+      if (num_prepared_frames_ == 0u) break;
+      prepared_frame = &prepared_frames_[first_prepared_frame_];
+    }
+
+    BENCHMARK_BLOCK("SM.Worker.AsyncRecognition.Complete");
+    recognizer_.completeRecognition(prepared_frame->prepared);
+    Result result;
+    result.candidate_transformations = recognizer_.getCandidateTransformations();
+    result.candidate_clusters = recognizer_.getCandidateClusters();
+    prepared_frame->result.set_value(std::move(result));
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      first_prepared_frame_ = (first_prepared_frame_ + 1u) % kNumPreparedFrameBuffers;
+      --num_prepared_frames_;
+    }
+    condition_.notify_all();
+  }
+}
+
+} // namespace bron_kerbosch
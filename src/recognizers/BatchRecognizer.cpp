@@ -0,0 +1,105 @@
+#include "recognizers/BatchRecognizer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+
+#include <glog/logging.h>
+#include "Benchmark.h"
+
+namespace bron_kerbosch {
+
+BatchRecognizer::BatchRecognizer(const GeometricConsistencyParams& params,
+                                 const float max_model_radius, const size_t num_threads)
+  : thread_pool_(num_threads) {
+  // The parallelism is across the sets, so every set is recognized with one thread.
+  // 并行发生在各组之间，因此每组只用一个线程识别
+  GeometricConsistencyParams worker_params = params;
+  worker_params.num_clique_search_threads = 1;
+  worker_params.num_consistency_graph_threads = 1;
+  recognizers_.reserve(num_threads);
+  for (size_t i = 0u; i < num_threads; ++i) {
+    recognizers_.emplace_back(
+        new IncrementalGeometricConsistencyRecognizer(worker_params, max_model_radius));
+  }
+}
+
+void BatchRecognizer::recognize(const std::vector<PairwiseMatches>& match_sets,
+                                std::vector<Result>& results) {
+  recognizeSets(match_sets, match_sets.size(), results);
+}
+
+void BatchRecognizer::recognizeSets(const std::vector<PairwiseMatches>& match_sets,
+                                    const size_t num_sets, std::vector<Result>& results) {
+  CHECK_LE(num_sets, match_sets.size());
+  BENCHMARK_BLOCK("SM.Worker.BatchRecognition");
+  results.resize(num_sets);
+
+  // Start with the biggest sets. The workers take the next set when they are done with the
+  // previous one, so the small sets fill the gaps left by the big ones.
+  // 从最大的组开始，工作线程完成一组后取下一组，小组填补大组留下的空隙
+  set_order_.resize(num_sets);
+  std::iota(set_order_.begin(), set_order_.end(), 0u);
+  std::stable_sort(set_order_.begin(), set_order_.end(), [&](const size_t a, const size_t b) {
+    return match_sets[a].size() > match_sets[b].size();
+  });
+
+  std::atomic<size_t> next_set(0u);
+  thread_pool_.parallelFor(0u, thread_pool_.getNumThreads(),
+                           [&](const size_t, const size_t worker_index) {
+    IncrementalGeometricConsistencyRecognizer& recognizer = *recognizers_[worker_index];
+    for (size_t i = next_set++; i < set_order_.size(); i = next_set++) {
+      const size_t set_index = set_order_[i];
+      recognizer.clearCache();
+      recognizer.recognize(match_sets[set_index]);
+      Result& result = results[set_index];
+      result.candidate_transformations = recognizer.getCandidateTransformations();
+      result.candidate_clusters = recognizer.getCandidateClusters();
+    }
+  });
+}
+
+void BatchRecognizer::recognizeModelGroups(const PairwiseMatches& predicted_matches,
+                                           const ModelGroupFunction& get_model_group,
+                                           std::vector<GroupResult>& group_results) {
+  CHECK(get_model_group);
+  BENCHMARK_BLOCK("SM.Worker.ModelGroupsRecognition");
+
+  // Sort the matches by group key. Within a group, the matches keep their order.
+  // 按组键对匹配排序，组内保持原有顺序
+  match_group_keys_.resize(predicted_matches.size());
+  for (size_t i = 0u; i < predicted_matches.size(); ++i) {
+    match_group_keys_[i] = get_model_group(predicted_matches[i].ids_.first);
+  }
+  match_group_order_.resize(predicted_matches.size());
+  std::iota(match_group_order_.begin(), match_group_order_.end(), 0u);
+  std::stable_sort(match_group_order_.begin(), match_group_order_.end(),
+                   [&](const size_t a, const size_t b) {
+    return match_group_keys_[a] < match_group_keys_[b];
+  });
+
+  // Copy the matches of every group to a set. The sets of the previous call are reused.
+  group_results.clear();
+  size_t num_groups = 0u;
+  for (size_t i = 0u; i < match_group_order_.size(); ++i) {
+    const size_t match_index = match_group_order_[i];
+    if (i == 0u || match_group_keys_[match_index] != group_results.back().group_key) {
+      if (num_groups == group_match_sets_.size()) group_match_sets_.emplace_back();
+      group_match_sets_[num_groups++].clear();
+      group_results.push_back({ match_group_keys_[match_index], 0u, Result() });
+    }
+    group_match_sets_[num_groups - 1u].push_back(predicted_matches[match_index]);
+    ++group_results.back().num_matches;
+  }
+  BENCHMARK_RECORD_VALUE("SM.Worker.ModelGroupsRecognition.NumGroups", num_groups);
+
+  // Recognize the groups as independent sets. The sets after the first num_groups ones are kept
+  // for the next calls.
+  // 将各组作为独立的匹配组识别，多余的匹配组保留给后续调用
+  recognizeSets(group_match_sets_, num_groups, group_set_results_);
+  for (size_t i = 0u; i < num_groups; ++i) {
+    group_results[i].result = std::move(group_set_results_[i]);
+  }
+}
+
+} // namespace bron_kerbosch
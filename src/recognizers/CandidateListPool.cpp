@@ -0,0 +1,54 @@
+#include "recognizers/CandidateListPool.hpp"
+
+#include <algorithm>
+
+namespace bron_kerbosch {
+
+void CandidateListPool::resize(const size_t num_lists) {
+  lists_.resize(num_lists);
+}
+
+void CandidateListPool::assignList(const size_t list, const Candidate* first,
+                                   const Candidate* last) {
+  DCHECK_LE(first, last);
+  ListRange& range = lists_[list];
+  const size_t size = static_cast<size_t>(last - first);
+  // A list that is not bigger than the current one is written in place.
+  if (size <= range.size) {
+    std::copy(first, last, candidates_.begin() + range.offset);
+  } else {
+    range.offset = candidates_.size();
+    candidates_.insert(candidates_.end(), first, last);
+  }
+  range.size = size;
+}
+
+size_t CandidateListPool::getNumLiveCandidates() const {
+  size_t num_live_candidates = 0u;
+  for (const ListRange& range : lists_) num_live_candidates += range.size;
+  return num_live_candidates;
+}
+
+bool CandidateListPool::isFragmented() const {
+  return candidates_.size() >= kMinCandidatesForCompaction &&
+      candidates_.size() > 2u * getNumLiveCandidates();
+}
+
+void CandidateListPool::compact(const size_t num_cache_slots) {
+  // Copy the lists to a new storage with the exact size, so that the old storage is released.
+  std::vector<Candidate> compacted_candidates;
+  compacted_candidates.reserve(getNumLiveCandidates());
+  for (ListRange& range : lists_) {
+    const size_t offset = compacted_candidates.size();
+    for (size_t i = range.offset; i < range.offset + range.size; ++i) {
+      if (getCacheSlot(candidates_[i]) < num_cache_slots)
+        compacted_candidates.push_back(candidates_[i]);
+    }
+    range.offset = offset;
+    range.size = compacted_candidates.size() - offset;
+  }
+  candidates_.swap(compacted_candidates);
+  if (lists_.capacity() > 2u * lists_.size()) lists_.shrink_to_fit();
+}
+
+} // namespace bron_kerbosch
@@ -1,49 +1,426 @@
 #include "recognizers/GraphBasedGeometricConsistencyRecognizer.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <vector>
 
 #include <glog/logging.h>
 #include "Benchmark.h"
+#include "recognizers/MatchesPartitioner.hpp"
 
 namespace bron_kerbosch {
 
+constexpr size_t GraphBasedGeometricConsistencyRecognizer::kNoMatch;
+
 GraphBasedGeometricConsistencyRecognizer::GraphBasedGeometricConsistencyRecognizer(
-    const GeometricConsistencyParams& params) noexcept
-  : params_(params) {
+    const GeometricConsistencyParams& params)
+  : params_(params), clique_search_cancelled_(false) {
+  if (params.clique_search_strategy == "Degeneracy") {
+    clique_search_strategy_ = CliqueSearchStrategy::kDegeneracy;
+  } else if (params.clique_search_strategy == "Bitset") {
+    clique_search_strategy_ = CliqueSearchStrategy::kBitset;
+  } else if (params.clique_search_strategy == "Coloring") {
+    clique_search_strategy_ = CliqueSearchStrategy::kColoring;
+  } else if (params.clique_search_strategy == "MaximumWeight") {
+    clique_search_strategy_ = CliqueSearchStrategy::kMaximumWeight;
+  } else if (params.clique_search_strategy == "Heuristic") {
+    clique_search_strategy_ = CliqueSearchStrategy::kHeuristic;
+  } else {
+    LOG(FATAL) << "Invalid clique search strategy: " << params.clique_search_strategy;
+  }
+
+  CHECK_GE(params.num_clique_search_threads, 1);
+  CHECK_GE(params.max_num_candidate_clusters, 0);
+  CHECK_GE(params.clique_search_time_budget_ms, 0.0);
+  CHECK_GE(params.clique_search_max_expanded_nodes, 0);
+  CHECK_GE(params.clique_search_heuristic_time_ms, 0.0);
+  if (params.clique_search_max_expanded_nodes > 0) {
+    clique_search_budget_.max_expanded_nodes =
+        static_cast<size_t>(params.clique_search_max_expanded_nodes);
+  }
+  clique_search_budget_.cancellation_flag = &clique_search_cancelled_;
+  if (params.num_clique_search_threads > 1) {
+    clique_search_thread_pool_.reset(
+        new WorkStealingThreadPool(static_cast<size_t>(params.num_clique_search_threads)));
+  }
 }
 
 // 识别：构建一致性图-》找到最大团-》得到满足成团条件的匹配-》估计3D变换
 void GraphBasedGeometricConsistencyRecognizer::recognize(
     const PairwiseMatches& predicted_matches) {
-  // Clear the current candidates and check if we got matches.
+  prepareRecognition(predicted_matches, prepared_recognition_);
+  completeRecognition(prepared_recognition_);
+}
+
+void GraphBasedGeometricConsistencyRecognizer::cancelCliqueSearch() {
+  std::lock_guard<std::mutex> lock(cancellation_mutex_);
+  last_cancelled_recognition_ = num_prepared_recognitions_;
+  clique_search_cancelled_ = true;
+}
+
+void GraphBasedGeometricConsistencyRecognizer::startRecognition(
+    const PreparedRecognition& prepared) {
   candidate_transfomations_.clear();
   candidate_matches_.clear();
-  if (predicted_matches.empty()) return;
+  {
+    // A cancellation issued while the graph was built stops the search of this recognition.
+    // 建图期间发出的取消同样停止本次识别的团搜索
+    std::lock_guard<std::mutex> lock(cancellation_mutex_);
+    clique_search_cancelled_ = prepared.recognition_number <= last_cancelled_recognition_;
+  }
+  last_clique_search_optimal_ = true;
+}
+
+void GraphBasedGeometricConsistencyRecognizer::prepareRecognition(
+    const PairwiseMatches& caller_matches, PreparedRecognition& prepared) {
+  {
+    std::lock_guard<std::mutex> lock(cancellation_mutex_);
+    prepared.recognition_number = ++num_prepared_recognitions_;
+  }
+  prepared.caller_matches = &caller_matches;
+  prepared.persistent_graph = nullptr;
+  prepared.consistency_graph = ConsistencyGraph();
+  if (caller_matches.empty()) return;
 
-  // Build a graph encoding consistencies between the predicted matches.
-  // 构建一个图，用来编码预测匹配间的一致性
-  ConsistencyGraph consistency_graph = buildConsistencyGraph(predicted_matches);
+  // Sort the matches along a Z-order curve of the scene centroids. All the following steps work
+  // on the sorted matches, and the cliques are mapped back to the matches of the caller.
+  // 将匹配沿场景质心的Z序曲线排序，后续步骤都在排序后的匹配上进行，团最终映射回调用者的匹配
+  if (params_.enable_morton_ordering) {
+    BENCHMARK_BLOCK("SM.Worker.Recognition.MortonOrdering");
+    MatchesPartitioner::computeMortonOrder(caller_matches, prepared.morton_order);
+    prepared.morton_ordered_matches.clear();
+    prepared.morton_ordered_matches.reserve(caller_matches.size());
+    for (const size_t match_index : prepared.morton_order) {
+      prepared.morton_ordered_matches.push_back(caller_matches[match_index]);
+    }
+  }
+  const PairwiseMatches& predicted_matches = params_.enable_morton_ordering ?
+      prepared.morton_ordered_matches : caller_matches;
+
+  // Build a graph encoding consistencies between the predicted matches, or update the graph kept
+  // across recognitions.
+  // 构建一个图，用来编码预测匹配间的一致性，或更新跨帧保留的一致性图
+  prepared.persistent_graph = updatePersistentConsistencyGraph(
+      predicted_matches, prepared.persistent_graph_vertex_matches);
+  if (prepared.persistent_graph == nullptr) {
+    prepared.consistency_graph = buildConsistencyGraph(predicted_matches);
+  }
+}
+
+void GraphBasedGeometricConsistencyRecognizer::completeRecognition(
+    const PreparedRecognition& prepared) {
+  // Clear the current candidates and check if we got matches.
+  startRecognition(prepared);
+  CHECK(prepared.caller_matches != nullptr);
+  const PairwiseMatches& caller_matches = *prepared.caller_matches;
+  if (caller_matches.empty()) return;
+  const PairwiseMatches& predicted_matches = params_.enable_morton_ordering ?
+      prepared.morton_ordered_matches : caller_matches;
+  const std::vector<size_t>* morton_order =
+      params_.enable_morton_ordering ? &prepared.morton_order : nullptr;
+  if (prepared.persistent_graph != nullptr) {
+    recognizeWithGraph(caller_matches, predicted_matches, *prepared.persistent_graph,
+                       &prepared.persistent_graph_vertex_matches, morton_order);
+  } else {
+    recognizeWithGraph(caller_matches, predicted_matches, prepared.consistency_graph, nullptr,
+                       morton_order);
+  }
+}
+
+template <typename Graph>
+void GraphBasedGeometricConsistencyRecognizer::recognizeWithGraph(
+    const PairwiseMatches& caller_matches, const PairwiseMatches& predicted_matches,
+    const Graph& consistency_graph, const std::vector<size_t>* vertex_match_indices,
+    const std::vector<size_t>* morton_order) {
   BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.BuildConsistencyGraph.NumConsistencies",
                          boost::num_edges(consistency_graph));
+  const auto get_caller_match_index = [&](const size_t match_index) {
+    return morton_order != nullptr ? (*morton_order)[match_index] : match_index;
+  };
+
+  // Get a clique that can be used as lower bound of the maximum clique search, so that only
+  // bigger cliques need to be searched.
+  // 获取可作为最大团搜索下界的团，只需搜索更大的团
+  std::vector<size_t> warm_start_clique;
+  if (params_.max_num_candidate_clusters == 1 &&
+      clique_search_strategy_ != CliqueSearchStrategy::kMaximumWeight) {
+    std::vector<size_t> match_vertices;
+    if (vertex_match_indices != nullptr) {
+      match_vertices.resize(predicted_matches.size());
+      for (size_t vertex = 0u; vertex < vertex_match_indices->size(); ++vertex) {
+        if ((*vertex_match_indices)[vertex] != kNoMatch)
+          match_vertices[(*vertex_match_indices)[vertex]] = vertex;
+      }
+    }
+    warm_start_clique = getWarmStartClique(
+        predicted_matches, [&](const size_t match_index_1, const size_t match_index_2) {
+      if (vertex_match_indices == nullptr)
+        return boost::edge(match_index_1, match_index_2, consistency_graph).second;
+      return boost::edge(match_vertices[match_index_1], match_vertices[match_index_2],
+                         consistency_graph).second;
+    });
+    BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.FindClique.WarmStartSize",
+                           warm_start_clique.size());
+  }
+  const size_t min_clique_size = std::max(static_cast<size_t>(params_.min_cluster_size),
+                                          warm_start_clique.size() + 1u);
+
+  // Remove the matches that cannot belong to a big enough cluster.
+  // 移除不可能属于足够大聚类的匹配
+  if (params_.enable_k_core_reduction) {
+    reduceToKCore(consistency_graph, min_clique_size);
+  }
+
+  // Renumber the vertices for improving the memory locality of the clique search.
+  // 按简并序重新编号顶点，提高团搜索的访存局部性
+  if (params_.enable_degeneracy_relabeling) {
+    if (params_.enable_k_core_reduction) {
+      relabelInDegeneracyOrder(reduced_graph_);
+    } else {
+      relabelInDegeneracyOrder(consistency_graph);
+    }
+  }
+  const auto get_match_index = [&](size_t vertex) {
+    if (params_.enable_degeneracy_relabeling) vertex = relabeled_graph_vertices_[vertex];
+    if (params_.enable_k_core_reduction) vertex = reduced_graph_matches_[vertex];
+    return vertex_match_indices != nullptr ? (*vertex_match_indices)[vertex] : vertex;
+  };
+
+  // Search the cliques in the last graph computed. The cliques are expressed as indices of the
+  // matches. If no clique bigger than the warm start clique exists, the warm start clique is the
+  // maximum clique.
+  // 在最后计算的图中搜索团，并将团表示为匹配的索引
+  std::vector<std::vector<size_t>> cliques;
+  if (params_.enable_degeneracy_relabeling) {
+    cliques = findCliquesWithWeights(predicted_matches, relabeled_graph_, min_clique_size,
+                                     get_match_index);
+  } else if (params_.enable_k_core_reduction) {
+    cliques = findCliquesWithWeights(predicted_matches, reduced_graph_, min_clique_size,
+                                     get_match_index);
+  } else {
+    cliques = findCliquesWithWeights(predicted_matches, consistency_graph, min_clique_size,
+                                     get_match_index);
+  }
+  for (auto& clique : cliques) {
+    for (auto& vertex : clique) vertex = get_match_index(vertex);
+  }
+  if (cliques.empty() &&
+      warm_start_clique.size() >= static_cast<size_t>(params_.min_cluster_size)) {
+    cliques.push_back(std::move(warm_start_clique));
+  }
+  BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.FindClique.OptimalityProven",
+                         last_clique_search_optimal_);
+
+  for (const auto& clique : cliques) {
+    // Store the clique of matches found.
+    candidate_matches_.emplace_back();
+    candidate_matches_.back().reserve(clique.size());
+    for (const auto match_index : clique) {
+      candidate_matches_.back().push_back(caller_matches[get_caller_match_index(match_index)]);
+    }
+
+    // Estimate the 3D transformation between model and scene.
+    Eigen::Matrix4f transformation = estimateRigidTransformation(candidate_matches_.back());
+    candidate_transfomations_.push_back(transformation);
+  }
+}
+
+template <typename Graph, typename GetMatchIndex>
+std::vector<std::vector<size_t>> GraphBasedGeometricConsistencyRecognizer::findCliquesWithWeights(
+    const PairwiseMatches& predicted_matches, const Graph& search_graph,
+    const size_t min_clique_size, const GetMatchIndex& get_match_index) {
+  // Compute the weights of the matches for the maximum weight clique search. Vertices that do
+  // not represent any match get a zero weight.
+  // 计算最大权团搜索使用的匹配权重
+  if (clique_search_strategy_ == CliqueSearchStrategy::kMaximumWeight) {
+    match_weights_.resize(boost::num_vertices(search_graph));
+    for (size_t i = 0u; i < match_weights_.size(); ++i) {
+      const size_t match_index = get_match_index(i);
+      if (match_index == kNoMatch) {
+        match_weights_[i] = 0.0;
+        continue;
+      }
+      const PairwiseMatch& match = predicted_matches[match_index];
+      match_weights_[i] = match_weight_function_ ?
+          match_weight_function_(match) : match.confidence_;
+    }
+  }
 
   BENCHMARK_START("SM.Worker.Recognition.FindClique");
-  std::vector<size_t> maximum_clique =  GraphUtilities::findMaximumClique(
-      consistency_graph, params_.min_cluster_size);
+  if (params_.clique_search_time_budget_ms > 0.0) {
+    clique_search_budget_.deadline = CliqueSearchBudget::Clock::now() +
+        std::chrono::duration_cast<CliqueSearchBudget::Clock::duration>(
+            std::chrono::duration<double, std::milli>(params_.clique_search_time_budget_ms));
+  }
+  std::vector<std::vector<size_t>> cliques = findCliques(search_graph, min_clique_size);
   BENCHMARK_STOP("SM.Worker.Recognition.FindClique");
+  return cliques;
+}
+
+// 查找作为候选聚类返回的团，按大小降序排列
+template <typename Graph>
+std::vector<std::vector<size_t>> GraphBasedGeometricConsistencyRecognizer::findCliques(
+    const Graph& consistency_graph, const size_t min_clique_size) {
+  std::vector<std::vector<size_t>> cliques;
+  if (params_.max_num_candidate_clusters == 1) {
+    std::vector<size_t> maximum_clique = findMaximumClique(consistency_graph, min_clique_size);
+    if (!maximum_clique.empty()) cliques.push_back(std::move(maximum_clique));
+  } else {
+    CliqueSearchStatistics statistics;
+    cliques = GraphUtilities::findLargestMaximalCliques(
+        consistency_graph, min_clique_size,
+        static_cast<size_t>(params_.max_num_candidate_clusters), &statistics,
+        &clique_search_budget_, &clique_search_workspace_);
+    last_clique_search_optimal_ = statistics.optimality_proven;
+    BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.FindClique.NumExpandedNodes",
+                           statistics.num_expanded_nodes);
+  }
+  return cliques;
+}
 
-  if (maximum_clique.empty()) return;
+// 根据选择的策略查找一致性图的最大团
+template <typename Graph>
+std::vector<size_t> GraphBasedGeometricConsistencyRecognizer::findMaximumClique(
+    const Graph& consistency_graph, const size_t min_clique_size) {
+  CliqueSearchStatistics statistics;
+  std::vector<size_t> maximum_clique;
+
+  // When the budget is exhausted before any clique is found, e.g. when the search is cancelled
+  // before it starts, the greedy construction of the heuristic gives a clique anyway. It ignores
+  // the budget, and its cost is small compared to the exact search.
+  // 预算在找到任何团之前耗尽时，使用启发式的贪心构造（不受预算限制）得到一个团
+  const auto find_greedy_clique = [&]() {
+    return GraphUtilities::findCliqueHeuristic(
+        consistency_graph, min_clique_size, CliqueSearchBudget::Clock::duration::zero(), nullptr,
+        nullptr, &clique_search_workspace_);
+  };
+
+  // Find a big clique with the heuristic. Unless the clique is proven to be maximum, the exact
+  // search only looks for bigger cliques.
+  // 先用启发式搜索找到一个较大的团，精确搜索只需寻找更大的团
+  std::vector<size_t> heuristic_clique;
+  size_t num_heuristic_expanded_nodes = 0u;
+  size_t search_min_clique_size = min_clique_size;
+  if (clique_search_strategy_ == CliqueSearchStrategy::kHeuristic ||
+      (params_.enable_clique_search_heuristic &&
+       clique_search_strategy_ != CliqueSearchStrategy::kMaximumWeight)) {
+    BENCHMARK_BLOCK("SM.Worker.Recognition.FindClique.Heuristic");
+    heuristic_clique = GraphUtilities::findCliqueHeuristic(
+        consistency_graph, min_clique_size,
+        std::chrono::duration_cast<CliqueSearchBudget::Clock::duration>(
+            std::chrono::duration<double, std::milli>(params_.clique_search_heuristic_time_ms)),
+        &statistics, &clique_search_budget_, &clique_search_workspace_);
+    BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.FindClique.HeuristicSize",
+                           heuristic_clique.size());
+    num_heuristic_expanded_nodes = statistics.num_expanded_nodes;
+    if (clique_search_strategy_ == CliqueSearchStrategy::kHeuristic ||
+        statistics.optimality_proven) {
+      last_clique_search_optimal_ = statistics.optimality_proven;
+      BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.FindClique.NumExpandedNodes",
+                             statistics.num_expanded_nodes);
+      if (heuristic_clique.empty() && !statistics.optimality_proven) return find_greedy_clique();
+      return heuristic_clique;
+    }
+    search_min_clique_size = std::max(min_clique_size, heuristic_clique.size() + 1u);
+  }
 
-  // Store the maximum clique of matches found.
-  candidate_matches_.emplace_back();
-  candidate_matches_.back().reserve(maximum_clique.size());
-  for (const auto match_index : maximum_clique) {
-    candidate_matches_.back().push_back(predicted_matches[match_index]);
+  // Small graphs are searched with kernels specialized for their size. They replace the
+  // sequential bitset searches only, so the strategy and the threads of the other searches are
+  // never overridden.
+  // 小图使用针对其尺寸特化的位集内核搜索（仅替代顺序位集搜索）
+  const size_t n_vertices = boost::num_vertices(consistency_graph);
+  if (params_.enable_fixed_width_clique_kernels &&
+      (clique_search_strategy_ == CliqueSearchStrategy::kBitset ||
+       clique_search_strategy_ == CliqueSearchStrategy::kColoring) && n_vertices <= 256u) {
+    if (n_vertices <= 64u) {
+      maximum_clique = GraphUtilities::findMaximumCliqueFixedWidth<64u>(
+          consistency_graph, search_min_clique_size, &statistics, &clique_search_budget_,
+          &clique_search_workspace_);
+    } else if (n_vertices <= 128u) {
+      maximum_clique = GraphUtilities::findMaximumCliqueFixedWidth<128u>(
+          consistency_graph, search_min_clique_size, &statistics, &clique_search_budget_,
+          &clique_search_workspace_);
+    } else {
+      maximum_clique = GraphUtilities::findMaximumCliqueFixedWidth<256u>(
+          consistency_graph, search_min_clique_size, &statistics, &clique_search_budget_,
+          &clique_search_workspace_);
+    }
+  } else {
+    switch (clique_search_strategy_) {
+      case CliqueSearchStrategy::kBitset:
+        maximum_clique = GraphUtilities::findMaximumCliqueBitset(
+            consistency_graph, search_min_clique_size, &statistics, &clique_search_budget_,
+            &clique_search_workspace_);
+        break;
+      case CliqueSearchStrategy::kColoring:
+        maximum_clique = GraphUtilities::findMaximumCliqueColoring(
+            consistency_graph, search_min_clique_size, &statistics, &clique_search_budget_,
+            &clique_search_workspace_);
+        break;
+      case CliqueSearchStrategy::kMaximumWeight:
+        maximum_clique = GraphUtilities::findMaximumWeightClique(
+            consistency_graph, match_weights_, search_min_clique_size, &statistics,
+            &clique_search_budget_, &clique_search_workspace_);
+        break;
+      case CliqueSearchStrategy::kDegeneracy:
+      default:
+        if (clique_search_thread_pool_) {
+          maximum_clique = GraphUtilities::findMaximumCliqueParallel(
+              consistency_graph, search_min_clique_size, *clique_search_thread_pool_,
+              &statistics, &clique_search_budget_, &clique_search_workspace_);
+        } else {
+          maximum_clique = GraphUtilities::findMaximumClique(
+              consistency_graph, search_min_clique_size, &statistics, &clique_search_budget_,
+              &clique_search_workspace_);
+        }
+        break;
+    }
   }
+  if (maximum_clique.empty()) maximum_clique = std::move(heuristic_clique);
+  if (maximum_clique.empty() && !statistics.optimality_proven) {
+    maximum_clique = find_greedy_clique();
+  }
+  last_clique_search_optimal_ = statistics.optimality_proven;
+  // The nodes expanded by the heuristic are counted with the nodes of the exact search.
+  statistics.num_expanded_nodes += num_heuristic_expanded_nodes;
+  BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.FindClique.NumExpandedNodes",
+                         statistics.num_expanded_nodes);
+  return maximum_clique;
+}
+
+// 将一致性图约简为可能包含最小尺寸聚类的k核
+template <typename Graph>
+void GraphBasedGeometricConsistencyRecognizer::reduceToKCore(
+    const Graph& consistency_graph, const size_t min_clique_size) {
+  BENCHMARK_BLOCK("SM.Worker.Recognition.KCoreReduction");
+  // The parallel peeling pays off only on large graphs.
+  constexpr size_t kMinVerticesForParallelPeeling = 4096u;
+
+  // A clique of size s is contained in the (s-1)-core.
+  if (clique_search_thread_pool_ &&
+      boost::num_vertices(consistency_graph) >= kMinVerticesForParallelPeeling) {
+    GraphUtilities::computeCoreNumbersParallel(consistency_graph, core_numbers_,
+                                               *clique_search_thread_pool_);
+  } else {
+    GraphUtilities::computeCoreNumbers(consistency_graph, core_numbers_,
+                                       &clique_search_workspace_);
+  }
+  GraphUtilities::findKCore(core_numbers_, min_clique_size - 1u, reduced_graph_matches_);
+  GraphUtilities::buildInducedSubgraph(consistency_graph, reduced_graph_matches_, reduced_graph_,
+                                       &clique_search_workspace_);
+  BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.KCoreReduction.NumVertices",
+                         boost::num_vertices(reduced_graph_));
+}
 
-  // Estimate the 3D transformation between model and scene.
-  Eigen::Matrix4f transformation = estimateRigidTransformation(candidate_matches_.back());
-  candidate_transfomations_.push_back(transformation);
+// 按简并序重新编号一致性图的顶点
+template <typename Graph>
+void GraphBasedGeometricConsistencyRecognizer::relabelInDegeneracyOrder(
+    const Graph& consistency_graph) {
+  BENCHMARK_BLOCK("SM.Worker.Recognition.DegeneracyRelabeling");
+  GraphUtilities::computeDegeneracyOrder(consistency_graph, relabeled_graph_vertices_,
+                                         &clique_search_workspace_);
+  GraphUtilities::buildInducedSubgraph(consistency_graph, relabeled_graph_vertices_,
+                                       relabeled_graph_, &clique_search_workspace_);
 }
 
 inline Eigen::Matrix4f GraphBasedGeometricConsistencyRecognizer::estimateRigidTransformation(
@@ -1,4 +1,7 @@
+#include <algorithm>
+#include <cmath>
 #include <limits>
+#include <unordered_set>
 #include <vector>
 
 #include <glog/logging.h>
@@ -10,18 +13,106 @@ namespace bron_kerbosch {
 constexpr size_t IncrementalGeometricConsistencyRecognizer::kNoMatchIndex_;
 constexpr size_t IncrementalGeometricConsistencyRecognizer::kNoCacheSlotIndex_;
 
+namespace {
+
+// Gets the sum of the displacements of the model and scene centroids of a match, which bounds the
+// change of its consistency distance to any other match.
+// 获取匹配的模型和场景质心位移之和，它界定了与任何其他匹配的一致性距离的变化
+inline float computeDisplacement(const PointPair& from, const PointPair& to) {
+  return (to.first.getVector3fMap() - from.first.getVector3fMap()).norm() +
+      (to.second.getVector3fMap() - from.second.getVector3fMap()).norm();
+}
+
+} // namespace
+
 // 初始化
 // 注意初始化列表
 IncrementalGeometricConsistencyRecognizer::IncrementalGeometricConsistencyRecognizer(
-    const GeometricConsistencyParams& params, const float max_model_radius) noexcept
+    const GeometricConsistencyParams& params, const float max_model_radius)
   : GraphBasedGeometricConsistencyRecognizer(params)
   // 此处max_model_radius为50
   // resolution为0.4或0.6
   , max_consistency_distance_(max_model_radius * 2.0 + params.resolution)
+  , max_scene_distance_(max_model_radius * 2.0f)
   // max_consistency_distance_for_caching为3
   , max_consistency_distance_for_caching_(
       params.max_consistency_distance_for_caching + params.resolution)
-  , half_max_consistency_distance_for_caching_(params.max_consistency_distance_for_caching * 0.5f) {
+  , half_max_consistency_distance_for_caching_(params.max_consistency_distance_for_caching * 0.5f)
+  // The centroid distances of the cached pairs are at most about twice max_consistency_distance_,
+  // and their single precision rounding errors a few epsilons of that.
+  , consistency_slack_margin_(8.0f * std::numeric_limits<float>::epsilon() *
+                              max_consistency_distance_) {
+  if (params.matches_partitioner == "Grid") {
+    matches_partitioner_type_ = MatchesPartitionerType::kGrid;
+  } else if (params.matches_partitioner == "Voxel") {
+    matches_partitioner_type_ = MatchesPartitionerType::kVoxel;
+  } else {
+    LOG(FATAL) << "Invalid matches partitioner: " << params.matches_partitioner;
+  }
+
+  CHECK_GE(params.num_consistency_graph_threads, 1);
+  if (params.num_consistency_graph_threads > 1) {
+    graph_construction_thread_pool_.reset(
+        new WorkStealingThreadPool(static_cast<size_t>(params.num_consistency_graph_threads)));
+  }
+}
+
+void IncrementalGeometricConsistencyRecognizer::completeRecognition(
+    const PreparedRecognition& prepared) {
+  GraphBasedGeometricConsistencyRecognizer::completeRecognition(prepared);
+  rememberWarmStartClique();
+}
+
+void IncrementalGeometricConsistencyRecognizer::rememberWarmStartClique() {
+  // Remember the maximum clique for warm starting the next clique search.
+  // 记录最大团，用于下一次团搜索的热启动
+  previous_clique_ids_.clear();
+  if (params_.enable_warm_start && !getCandidateClusters().empty()) {
+    for (const auto& match : getCandidateClusters().front()) {
+      previous_clique_ids_.push_back(match.ids_);
+    }
+  }
+}
+
+void IncrementalGeometricConsistencyRecognizer::clearCache() {
+  // Remove all the cache slots, so that the next recognition assigns them as a new recognizer
+  // would. The edges of the persistent graph are only stored in the vertices of cached matches.
+  // 移除所有缓存槽，使下一次识别像新的识别器一样分配缓存槽
+  if (params_.enable_persistent_consistency_graph) {
+    cache_slot_indices_.forEach([&](const IdPair&, const size_t cache_slot_index) {
+      persistent_consistency_graph_.clearVertex(cache_slot_index);
+    });
+    persistent_consistency_graph_.resize(0u);
+  }
+  cache_slot_indices_.clear();
+  matches_cache_.clear();
+  candidate_lists_.clear();
+  previous_clique_ids_.clear();
+}
+
+std::vector<size_t> IncrementalGeometricConsistencyRecognizer::getWarmStartClique(
+    const PairwiseMatches& predicted_matches, const ConsistencyTest& are_consistent) {
+  std::vector<size_t> clique;
+  if (!params_.enable_warm_start || previous_clique_ids_.empty()) return clique;
+  BENCHMARK_BLOCK("SM.Worker.Recognition.WarmStart");
+
+  // Greedily collect the matches of the previous clique that are still present and consistent
+  // with all the matches collected so far.
+  // 贪心地收集上一个团中仍然存在、且与已收集的匹配都一致的匹配
+  const std::unordered_set<IdPair, IdPairHash> previous_clique_ids(previous_clique_ids_.begin(),
+                                                                   previous_clique_ids_.end());
+  for (size_t i = 0u; i < predicted_matches.size(); ++i) {
+    if (previous_clique_ids.count(predicted_matches[i].ids_) == 0u) continue;
+    bool is_consistent = true;
+    for (const size_t match_index : clique) {
+      if (!are_consistent(i, match_index)) {
+        is_consistent = false;
+        break;
+      }
+    }
+    if (is_consistent) clique.push_back(i);
+  }
+  return clique;
 }
 
 // 处理缓存中已存在的预测匹配，清理旧条目，找到一致性并添加到一致性图
@@ -31,51 +122,132 @@ inline void IncrementalGeometricConsistencyRecognizer::processCachedMatches(
     const PairwiseMatches& predicted_matches,
     const std::vector<MatchLocations>& cached_matches_locations,
     const std::vector<size_t>& cache_slot_index_to_match_index,
-    std::unordered_map<IdPair, size_t, IdPairHash>& new_cache_slot_indices,
-    ConsistencyGraph& consistency_graph) {
+    IdPairFlatMap& new_cache_slot_indices,
+    ConsistencyGraphEdges& consistency_graph_edges) {
   BENCHMARK_BLOCK("SM.Worker.Recognition.BuildConsistencyGraph.CachedMatches");
 
-  // Recompute consistency information of cached elements where necessary.
-  // 必要时重新计算缓存元素的一致性信息。
-  size_t num_consistency_tests = 0u;
+  // new_cache_slot_indices  存储match的ids 和 缓存索引
   for (const auto& cached_match_locations : cached_matches_locations) {
-	// match 匹配对
-	// match_cache 缓存的匹配对
-	// new_cache_slot_indices  存储match的ids 和 缓存索引
-    const PairwiseMatch& match = predicted_matches[cached_match_locations.match_index];
-    MatchCacheSlot& match_cache = matches_cache_[cached_match_locations.cache_slot_index];
-    new_cache_slot_indices.emplace(match.ids_, cached_match_locations.cache_slot_index);
-
-    // For each cached element, get rid of any reference to matches that do not exist anymore and
-    // add consistent pairs to the consistency graph.
-	// 对于每个缓存的元素，删除不再存在的匹配项的所有引用，并向一致性图中添加一致性对。
-    std::vector<size_t> new_candidate_consistent_matches;
-    new_candidate_consistent_matches.reserve(match_cache.candidate_consistent_matches.size());
-    for (const size_t candidate_cache_slot_index : match_cache.candidate_consistent_matches) {
-      const size_t match_2_index = cache_slot_index_to_match_index[candidate_cache_slot_index];
-	  // 不等于kNoMatchIndex_，说明从缓存中移除了
-      if (match_2_index != kNoMatchIndex_) {
-        const PairwiseMatch& match_2 = predicted_matches[match_2_index];
-		// match
-        float consistency_distance = computeConsistencyDistance(match, match_2,
-                                                                max_consistency_distance_);
-        ++num_consistency_tests;
-
-        // If the matches are close enough, cache them as candidate consistent matches.
-		// 如果匹配足够接近，缓存作为候选一致匹配（阈值约为100）
-        if (consistency_distance <= max_consistency_distance_) {
-          new_candidate_consistent_matches.emplace_back(candidate_cache_slot_index);
-
-          // If the matches are consistent, add and edge to the consistency graph
-		  // 如果匹配一致，将边添加到一致性图（阈值为0.4或0.6）
-          if (consistency_distance <= params_.resolution)
-            boost::add_edge(match_2_index, cached_match_locations.match_index,
-                            consistency_graph);
+    new_cache_slot_indices.emplace(predicted_matches[cached_match_locations.match_index].ids_,
+                                   cached_match_locations.cache_slot_index);
+  }
+
+  // Recompute consistency information of cached elements where necessary. Every cached match only
+  // modifies its own cache slot, so stripes of cached matches can be processed concurrently.
+  // 必要时重新计算缓存元素的一致性信息。每个缓存匹配只修改自己的缓存槽，因此可以并行处理。
+  const size_t n_cached_matches = cached_matches_locations.size();
+  const bool persistent_graph = params_.enable_persistent_consistency_graph;
+  // The cache slots of the previous recognition that are not used anymore must be removed from
+  // the candidates, even from those that are not tested again.
+  const bool has_released_cache_slots = cache_slot_indices_.size() > n_cached_matches;
+  const size_t n_stripes = getNumGraphConstructionStripes(n_cached_matches);
+  size_t num_consistency_tests = 0u;
+  size_t num_unchanged_matches = 0u;
+  processStripes(n_stripes, [&](const size_t stripe, const size_t worker_index) {
+    GraphConstructionStripe& stripe_result = graph_construction_stripes_[stripe];
+    ConsistencyDistanceBuffers& buffers = consistency_distance_buffers_[worker_index];
+    const size_t stripe_begin = n_cached_matches * stripe / n_stripes;
+    const size_t stripe_end = n_cached_matches * (stripe + 1u) / n_stripes;
+    for (size_t i = stripe_begin; i < stripe_end; ++i) {
+      const MatchLocations& cached_match_locations = cached_matches_locations[i];
+      MatchCacheSlot& match_cache = matches_cache_[cached_match_locations.cache_slot_index];
+      const PointPair& centroids = predicted_matches[cached_match_locations.match_index].centroids_;
+      CandidateListPool::Candidate* const candidates =
+          candidate_lists_.getList(cached_match_locations.cache_slot_index);
+      const size_t n_candidates =
+          candidate_lists_.getListSize(cached_match_locations.cache_slot_index);
+
+      // Since the last test of the candidates, their consistency distances changed by at most the
+      // displacement of the match plus the increase of the cumulative drift, which bounds the
+      // displacement of the other match. If that is less than the slack of the candidates, no
+      // consistency changed and the candidates are kept without testing them again.
+      // 自上次测试以来，一致性距离的变化不超过匹配的位移加上累计漂移的增量。
+      // 若小于候选项的余量，则一致性不变，无需重新测试
+      const double max_distance_change =
+          computeDisplacement(match_cache.centroids_at_test, centroids) +
+          (cumulative_drift_ - match_cache.cumulative_drift_at_test) + consistency_slack_margin_;
+      if (max_distance_change < match_cache.consistency_slack) {
+        ++stripe_result.num_unchanged_matches;
+        // With the persistent graph the edges are already present.
+        if (persistent_graph && !has_released_cache_slots) continue;
+        size_t n_kept_candidates = 0u;
+        for (size_t k = 0u; k < n_candidates; ++k) {
+          const size_t match_2_index =
+              cache_slot_index_to_match_index[CandidateListPool::getCacheSlot(candidates[k])];
+          if (match_2_index == kNoMatchIndex_) continue;
+          candidates[n_kept_candidates++] = candidates[k];
+          if (!persistent_graph && CandidateListPool::isConsistent(candidates[k]))
+            stripe_result.edges.emplace_back(match_2_index, cached_match_locations.match_index);
+        }
+        candidate_lists_.truncateList(cached_match_locations.cache_slot_index, n_kept_candidates);
+        continue;
+      }
+
+      // Compute the consistency distances to all the candidates that still exist at once.
+      // 一次性计算与所有仍然存在的候选匹配之间的一致性距离
+      buffers.candidate_slots.clear();
+      for (size_t k = 0u; k < n_candidates; ++k) {
+        const size_t candidate_cache_slot_index = CandidateListPool::getCacheSlot(candidates[k]);
+        const size_t match_2_index = cache_slot_index_to_match_index[candidate_cache_slot_index];
+        if (match_2_index != kNoMatchIndex_)
+          buffers.candidate_slots.push_back(match_slots_[match_2_index]);
+      }
+      buffers.consistency_distances.resize(buffers.candidate_slots.size());
+      match_centroids_.computeConsistencyDistances(
+          match_slots_[cached_match_locations.match_index], buffers.candidate_slots,
+          max_scene_distance_, buffers.consistency_distances.data());
+      stripe_result.num_consistency_tests += buffers.candidate_slots.size();
+
+      // For each cached element, get rid of any reference to matches that do not exist anymore
+      // and add consistent pairs to the consistency graph. With the persistent graph, only the
+      // pairs whose consistency changed are collected. The candidates that are kept are moved to
+      // the front of the list, which is then shrunk in place.
+      // 对于每个缓存的元素，删除不再存在的匹配项的所有引用，并向一致性图中添加一致性对。
+      // 使用持久图时，只收集一致性发生变化的匹配对。保留的候选项移到列表前部，列表原地收缩。
+      size_t next_distance_index = 0u;
+      size_t n_kept_candidates = 0u;
+      float consistency_slack = std::numeric_limits<float>::max();
+      for (size_t k = 0u; k < n_candidates; ++k) {
+        const size_t candidate_cache_slot_index = CandidateListPool::getCacheSlot(candidates[k]);
+        const size_t match_2_index = cache_slot_index_to_match_index[candidate_cache_slot_index];
+        // 不等于kNoMatchIndex_，说明从缓存中移除了
+        if (match_2_index != kNoMatchIndex_) {
+          const float consistency_distance =
+              buffers.consistency_distances[next_distance_index++];
+          const bool was_consistent = CandidateListPool::isConsistent(candidates[k]);
+          const bool is_consistent = consistency_distance <= params_.resolution;
+
+          // If the matches are close enough, cache them as candidate consistent matches.
+          // 如果匹配足够接近，缓存作为候选一致匹配（阈值约为100）
+          if (consistency_distance <= max_consistency_distance_) {
+            candidates[n_kept_candidates++] =
+                CandidateListPool::makeCandidate(candidate_cache_slot_index, is_consistent);
+            consistency_slack = std::min(consistency_slack, static_cast<float>(
+                std::fabs(consistency_distance - params_.resolution)));
+
+            // If the matches are consistent, add and edge to the consistency graph
+            // 如果匹配一致，将边添加到一致性图（阈值为0.4或0.6）
+            if (is_consistent && !(persistent_graph && was_consistent))
+              stripe_result.edges.emplace_back(match_2_index, cached_match_locations.match_index);
+          }
+          if (persistent_graph && was_consistent && !is_consistent) {
+            stripe_result.removed_edges.emplace_back(match_2_index,
+                                                     cached_match_locations.match_index);
+          }
         }
       }
+      candidate_lists_.truncateList(cached_match_locations.cache_slot_index, n_kept_candidates);
+      match_cache.centroids_at_test = centroids;
+      match_cache.cumulative_drift_at_test = cumulative_drift_;
+      match_cache.consistency_slack = consistency_slack;
     }
-    match_cache.candidate_consistent_matches = std::move(new_candidate_consistent_matches);
-  }
+  }, consistency_graph_edges, num_consistency_tests);
+  for (size_t stripe = 0u; stripe < n_stripes; ++stripe)
+    num_unchanged_matches += graph_construction_stripes_[stripe].num_unchanged_matches;
+  cache_statistics_.num_cached_pair_tests = num_consistency_tests;
+  cache_statistics_.num_unchanged_matches = num_unchanged_matches;
+  BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.BuildConsistencyGraph.UnchangedMatches",
+                         num_unchanged_matches);
   BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.BuildConsistencyGraph.TestedCachedPairs",
                          num_consistency_tests);
 }
@@ -91,79 +263,164 @@ inline void IncrementalGeometricConsistencyRecognizer::processNewMatches(
     const PairwiseMatches& predicted_matches,
     const std::vector<size_t>& free_cache_slot_indices,
     std::vector<size_t>& match_index_to_cache_slot_index,
-    std::unordered_map<IdPair, size_t, IdPairHash>& new_cache_slot_indices,
-    ConsistencyGraph& consistency_graph) {
+    IdPairFlatMap& new_cache_slot_indices,
+    ConsistencyGraphEdges& consistency_graph_edges) {
   BENCHMARK_BLOCK("SM.Worker.Recognition.BuildConsistencyGraph.NewMatches");
 
-  // Partition the matches in a grid by the position of the scene points. The size of the
-  // partitions is greater or equal the size of the model. This way we can safely assume that, if
-  // the model is actually present in the scene, all matches will be contained in a 2x2 group of
-  // adjacent partitions.
-  
-  // 根据场景点的位置在网格中划分匹配项，分区的尺寸大于等于模型
-  // 这样我们就可以放心地假设，如果这个模型实际上出现在场景中，所有匹配项将包含在一个2x2相邻的分区组中。
-  BENCHMARK_START("SM.Worker.Recognition.BuildConsistencyGraph.Partitioning");
-  MatchesGridPartitioning<PartitionData> partitioning =
-      MatchesPartitioner::computeGridPartitioning<PartitionData>(predicted_matches,
-                                                                 max_consistency_distance_);
-  BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.BuildConsistencyGraph.NumPartitions",
-                         partitioning.getHeight() * partitioning.getWidth());
-  BENCHMARK_STOP("SM.Worker.Recognition.BuildConsistencyGraph.Partitioning");
+  // Insert the new matches in free cache slots in partition order. A new match is compared to the
+  // cached matches and to the new matches that precede it in partition order, so that every pair
+  // is tested once. Assigning the slots beforehand makes the result independent of the order in
+  // which the partitions are processed.
+  // 按分区顺序将新匹配插入空闲缓存槽。新匹配与已缓存的匹配以及分区顺序中在它之前的新匹配比较，
+  // 预先分配缓存槽使结果与分区的处理顺序无关
+  const size_t n_slots = slot_match_indices_.size();
+  slot_is_new_.assign(n_slots, false);
+  size_t next_slot_index_position = 0u;
+  for (size_t slot = 0u; slot < n_slots; ++slot) {
+    const size_t match_index = slot_match_indices_[slot];
+    // Only process new matches.
+    if (match_index_to_cache_slot_index[match_index] != kNoCacheSlotIndex_) continue;
+    const size_t cache_slot_index = free_cache_slot_indices[next_slot_index_position];
+    ++next_slot_index_position;
+    match_index_to_cache_slot_index[match_index] = cache_slot_index;
+    new_cache_slot_indices.emplace(predicted_matches[match_index].ids_, cache_slot_index);
+    slot_is_new_[slot] = true;
+  }
 
-  // Find all possible consistency within a partition and within neighbor partitions.
+  // Find all possible consistency within a partition and within neighbor partitions. The
+  // partitions are divided in stripes of consecutive partitions with similar numbers of matches.
+  // 在分区内和相邻分区之间寻找所有可能的一致性，分区被划分为匹配数量相近的连续分区条带
+  const size_t n_partitions = partition_slot_begins_.size() - 1u;
+  const size_t n_stripes = getNumGraphConstructionStripes(n_partitions);
   size_t num_consistency_tests = 0u;
-  size_t next_slot_index_position = 0u;
-  for (size_t i = 0; i < partitioning.getHeight(); ++i) {
-    for (size_t j = 0; j < partitioning.getWidth(); ++j) {
-      for (const auto match_index : partitioning(i, j).match_indices) {
-        // Only process new matches.
-        if (match_index_to_cache_slot_index[match_index] != kNoCacheSlotIndex_) continue;
+  processStripes(n_stripes, [&](const size_t stripe, const size_t worker_index) {
+    GraphConstructionStripe& stripe_result = graph_construction_stripes_[stripe];
+    ConsistencyDistanceBuffers& buffers = consistency_distance_buffers_[worker_index];
+    const auto partition_at_slot = [&](const size_t slot) {
+      return static_cast<size_t>(std::lower_bound(partition_slot_begins_.begin(),
+                                                  partition_slot_begins_.end() - 1, slot) -
+                                 partition_slot_begins_.begin());
+    };
+    const size_t partitions_begin = partition_at_slot(n_slots * stripe / n_stripes);
+    const size_t partitions_end = partition_at_slot(n_slots * (stripe + 1u) / n_stripes);
+    for (size_t partition = partitions_begin; partition < partitions_end; ++partition) {
+      for (size_t slot = partition_slot_begins_[partition];
+           slot < partition_slot_begins_[partition + 1u]; ++slot) {
+        if (!slot_is_new_[slot]) continue;
+        const size_t match_index = slot_match_indices_[slot];
         const PairwiseMatch& match = predicted_matches[match_index];
 
-        // Get a free cache slot and insert the match.
-        const size_t cache_slot_index = free_cache_slot_indices[next_slot_index_position];
-        ++next_slot_index_position;
+        // Reset the cache slot of the match. Its candidates are collected in the stripe, and the
+        // smallest difference between their consistency distances and the resolution is stored.
+        const size_t cache_slot_index = match_index_to_cache_slot_index[match_index];
         MatchCacheSlot& match_cache = matches_cache_[cache_slot_index];
-        match_cache.candidate_consistent_matches.clear();
-        match_cache.candidate_consistent_matches.reserve(matches_cache_.size() - 1u);
         match_cache.centroids_at_caching = match.centroids_;
-        new_cache_slot_indices.emplace(match.ids_, cache_slot_index);
+        match_cache.caching_recognition = num_recognitions_;
+        match_cache.evicted = false;
+        match_cache.centroids_at_test = match.centroids_;
+        match_cache.previous_centroids = match.centroids_;
+        match_cache.cumulative_drift_at_test = cumulative_drift_;
+        float consistency_slack = std::numeric_limits<float>::max();
 
         // Test consistencies between the current match and the cached matches in the neighbor
-        // partitions.
-        for (size_t k = static_cast<size_t>(std::max(0, static_cast<int>(i) - 1));
-             k <= std::min(partitioning.getHeight() - 1u, i + 1u); ++k) {
-          for (size_t l = static_cast<size_t>(std::max(0, static_cast<int>(j) - 1));
-               l <= std::min(partitioning.getWidth() - 1u, j + 1u); ++l) {
-            for (const auto match_2_index : partitioning(k, l).match_indices) {
-              // Only compare to matches already present in the cache
-              if (match_index_to_cache_slot_index[match_2_index] != kNoCacheSlotIndex_) {
-                const PairwiseMatch& match_2 = predicted_matches[match_2_index];
-                float consistency_distance = computeConsistencyDistance(match, match_2,
-                                                                        max_consistency_distance_);
-                ++num_consistency_tests;
-
-                // If the matches are close enough, cache them as candidate consistent matches.
-                if (consistency_distance <= max_consistency_distance_for_caching_) {
-                  match_cache.candidate_consistent_matches.emplace_back(
-                      match_index_to_cache_slot_index[match_2_index]);
-                  // If the matches are consistent, add an edge to the consistency graph.
-                  if (consistency_distance <= params_.resolution)
-                    boost::add_edge(match_index, match_2_index, consistency_graph);
-                }
-              }
+        // partitions. The distances to all the matches of a partition are computed at once.
+        for (size_t neighbor = partition_neighbor_begins_[partition];
+             neighbor < partition_neighbor_begins_[partition + 1u]; ++neighbor) {
+          const size_t partition_index = partition_neighbors_[neighbor];
+          const size_t slots_begin = partition_slot_begins_[partition_index];
+          const size_t slots_end = partition_slot_begins_[partition_index + 1u];
+          buffers.consistency_distances.resize(slots_end - slots_begin);
+          match_centroids_.computeConsistencyDistances(slot, slots_begin, slots_end,
+                                                       max_scene_distance_,
+                                                       buffers.consistency_distances.data());
+          for (size_t slot_2 = slots_begin; slot_2 < slots_end; ++slot_2) {
+            // Only compare to matches already present in the cache
+            if (slot_is_new_[slot_2] && slot_2 >= slot) continue;
+            const size_t match_2_index = slot_match_indices_[slot_2];
+            const float consistency_distance =
+                buffers.consistency_distances[slot_2 - slots_begin];
+            ++stripe_result.num_consistency_tests;
+
+            // If the matches are close enough, cache them as candidate consistent matches.
+            if (consistency_distance <= max_consistency_distance_for_caching_) {
+              const bool is_consistent = consistency_distance <= params_.resolution;
+              stripe_result.candidates.push_back(CandidateListPool::makeCandidate(
+                  match_index_to_cache_slot_index[match_2_index], is_consistent));
+              consistency_slack = std::min(consistency_slack, static_cast<float>(
+                  std::fabs(consistency_distance - params_.resolution)));
+              // If the matches are consistent, add an edge to the consistency graph.
+              if (is_consistent) stripe_result.edges.emplace_back(match_index, match_2_index);
             }
           }
         }
-
-        match_index_to_cache_slot_index[match_index] = cache_slot_index;
+        match_cache.consistency_slack = consistency_slack;
+        stripe_result.candidate_list_ends.emplace_back(cache_slot_index,
+                                                       stripe_result.candidates.size());
       }
     }
+  }, consistency_graph_edges, num_consistency_tests);
+
+  // Store the candidates of the new matches in the pool.
+  // 将新匹配的候选项存入候选列表池
+  for (size_t stripe = 0u; stripe < n_stripes; ++stripe) {
+    const GraphConstructionStripe& stripe_result = graph_construction_stripes_[stripe];
+    const CandidateListPool::Candidate* const candidates = stripe_result.candidates.data();
+    size_t list_begin = 0u;
+    for (const auto& list_end : stripe_result.candidate_list_ends) {
+      candidate_lists_.assignList(list_end.first, candidates + list_begin,
+                                  candidates + list_end.second);
+      list_begin = list_end.second;
+    }
   }
+  cache_statistics_.num_new_pair_tests = num_consistency_tests;
   BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.BuildConsistencyGraph.TestedNewPairs",
                            num_consistency_tests);
 }
 
+size_t IncrementalGeometricConsistencyRecognizer::getNumGraphConstructionStripes(
+    const size_t n_items) const {
+  if (!graph_construction_thread_pool_) return 1u;
+  // A few stripes per thread balance the load between the workers.
+  return std::max(size_t(1u), std::min(n_items,
+                                       4u * graph_construction_thread_pool_->getNumThreads()));
+}
+
+void IncrementalGeometricConsistencyRecognizer::processStripes(
+    const size_t n_stripes,
+    const std::function<void(size_t stripe, size_t worker_index)>& function,
+    ConsistencyGraphEdges& consistency_graph_edges, size_t& num_consistency_tests) {
+  if (graph_construction_stripes_.size() < n_stripes)
+    graph_construction_stripes_.resize(n_stripes);
+  for (size_t stripe = 0u; stripe < n_stripes; ++stripe) {
+    graph_construction_stripes_[stripe].edges.clear();
+    graph_construction_stripes_[stripe].removed_edges.clear();
+    graph_construction_stripes_[stripe].candidates.clear();
+    graph_construction_stripes_[stripe].candidate_list_ends.clear();
+    graph_construction_stripes_[stripe].num_consistency_tests = 0u;
+    graph_construction_stripes_[stripe].num_unchanged_matches = 0u;
+  }
+
+  if (graph_construction_thread_pool_) {
+    consistency_distance_buffers_.resize(graph_construction_thread_pool_->getNumThreads());
+    graph_construction_thread_pool_->parallelFor(0u, n_stripes, function);
+  } else {
+    consistency_distance_buffers_.resize(1u);
+    for (size_t stripe = 0u; stripe < n_stripes; ++stripe) function(stripe, 0u);
+  }
+
+  // Merge the stripes in order.
+  // 按顺序合并条带
+  for (size_t stripe = 0u; stripe < n_stripes; ++stripe) {
+    const GraphConstructionStripe& stripe_result = graph_construction_stripes_[stripe];
+    consistency_graph_edges.insert(consistency_graph_edges.end(), stripe_result.edges.begin(),
+                                   stripe_result.edges.end());
+    removed_consistency_graph_edges_.insert(removed_consistency_graph_edges_.end(),
+                                            stripe_result.removed_edges.begin(),
+                                            stripe_result.removed_edges.end());
+    num_consistency_tests += stripe_result.num_consistency_tests;
+  }
+}
+
 bool IncrementalGeometricConsistencyRecognizer::mustRemoveFromCache(
     const PairwiseMatch& match, const size_t cache_slot_index) {
   const MatchCacheSlot& match_cache = matches_cache_[cache_slot_index];
@@ -175,53 +432,198 @@ bool IncrementalGeometricConsistencyRecognizer::mustRemoveFromCache(
       match_cache.centroids_at_caching.second.getVector3fMap();
 
   // Since checking the change in consistency distance for every match pair would be too expensive,
-  // we the responsibility of the check on both matches. If the centroids of a match move by half
-  // the maximum distance allowed, then the cached information are invalidated independently of the
-  // changes of the other matches.
-  // 由于检查每个匹配对的一致性距离的变化开销过大，我们只检查两个匹配。
+  // we split the responsibility of the check on both matches. If the centroids of a match move by
+  // half the maximum distance allowed, then the cached information are invalidated independently
+  // of the changes of the other matches. The cached pairs alone do not need this, the consistency
+  // slack bounds their changes, but the pairs beyond the caching distance are not stored and may
+  // become consistent once both matches moved by half of it.
+  // 由于检查每个匹配对的一致性距离的变化开销过大，我们将检查的责任分摊到两个匹配上。
   // 如果匹配的质心移动了允许的最大距离的一半，则高速缓存的信息无效，而与其他匹配的变化无关。
+  // 缓存的匹配对本身不需要这样做，一致性余量限制了它们的变化；但超出缓存距离的匹配对未被存储，
+  // 在两个匹配都移动了该距离的一半后可能变得一致。
   const float model_displacement = (model_centroid - model_centroid_at_caching).norm();
   const float scene_displacement = (scene_centroid - scene_centroid_at_caching).norm();
   // 该参数大概为1.5
   return model_displacement + scene_displacement >= half_max_consistency_distance_for_caching_;
 }
 
+void IncrementalGeometricConsistencyRecognizer::limitCacheMemory(
+    const std::vector<size_t>& match_index_to_cache_slot_index) {
+  BENCHMARK_BLOCK("SM.Worker.Recognition.BuildConsistencyGraph.LimitCacheMemory");
+
+  // Release the candidates of the cache slots that are not used anymore.
+  // 释放不再使用的缓存槽的候选项
+  std::vector<bool> slot_is_used(matches_cache_.size(), false);
+  size_t num_used_slots = 0u;
+  for (const size_t cache_slot_index : match_index_to_cache_slot_index) {
+    slot_is_used[cache_slot_index] = true;
+    num_used_slots = std::max(num_used_slots, cache_slot_index + 1u);
+  }
+  for (size_t i = 0u; i < matches_cache_.size(); ++i) {
+    if (!slot_is_used[i]) candidate_lists_.truncateList(i, 0u);
+  }
+  bool must_compact = candidate_lists_.isFragmented();
+
+  // After a burst of matches, remove the unused cache slots at the end of the cache. Free slots
+  // are reused in increasing order, so the used slots gather at the beginning of the cache. The
+  // candidates referring to removed slots are removed when compacting.
+  // 匹配数量突增之后，移除缓存末尾未使用的缓存槽
+  if (num_used_slots < matches_cache_.size() / 2u) {
+    matches_cache_.resize(num_used_slots);
+    matches_cache_.shrink_to_fit();
+    candidate_lists_.resize(num_used_slots);
+    must_compact = true;
+  }
+
+  // If the memory limit is exceeded, evict the candidates of the slots cached the longest ago,
+  // until the compacted pool, including the positions of its lists, fits in the limit. The slots
+  // cached in this recognition are not evicted.
+  // 超出内存上限时，逐出最早缓存的槽的候选项，直到整理后的候选项（含列表位置）满足上限
+  size_t num_evicted_slots = 0u;
+  if (params_.max_match_cache_memory_mb > 0.0) {
+    const size_t max_memory_bytes =
+        static_cast<size_t>(params_.max_match_cache_memory_mb * 1024.0 * 1024.0);
+    if (candidate_lists_.getMemoryBytes() > max_memory_bytes) {
+      must_compact = true;
+      const size_t lists_memory_bytes = candidate_lists_.getListsMemoryBytes();
+      const size_t max_num_candidates = max_memory_bytes > lists_memory_bytes ?
+          (max_memory_bytes - lists_memory_bytes) / sizeof(CandidateListPool::Candidate) : 0u;
+      size_t num_candidates = candidate_lists_.getNumLiveCandidates();
+      std::vector<size_t> eviction_order;
+      for (size_t i = 0u; i < matches_cache_.size(); ++i) {
+        if (slot_is_used[i] && !matches_cache_[i].evicted &&
+            matches_cache_[i].caching_recognition < num_recognitions_)
+          eviction_order.push_back(i);
+      }
+      std::stable_sort(eviction_order.begin(), eviction_order.end(),
+                       [&](const size_t slot_1, const size_t slot_2) {
+        return matches_cache_[slot_1].caching_recognition <
+            matches_cache_[slot_2].caching_recognition;
+      });
+      for (const size_t cache_slot_index : eviction_order) {
+        if (num_candidates <= max_num_candidates) break;
+        num_candidates -= candidate_lists_.getListSize(cache_slot_index);
+        candidate_lists_.truncateList(cache_slot_index, 0u);
+        matches_cache_[cache_slot_index].evicted = true;
+        ++num_evicted_slots;
+      }
+    }
+  }
+  BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.BuildConsistencyGraph.EvictedCacheSlots",
+                         num_evicted_slots);
+
+  if (must_compact) candidate_lists_.compact(matches_cache_.size());
+  cache_statistics_.candidates_memory_bytes = candidate_lists_.getMemoryBytes();
+  BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.BuildConsistencyGraph.CandidatesMemoryBytes",
+                         cache_statistics_.candidates_memory_bytes);
+}
+
 inline IncrementalGeometricConsistencyRecognizer::ConsistencyGraph
 IncrementalGeometricConsistencyRecognizer::buildConsistencyGraph(
     const PairwiseMatches& predicted_matches) {
   BENCHMARK_BLOCK("SM.Worker.Recognition.BuildConsistencyGraph");
+  std::vector<size_t> match_index_to_cache_slot_index;
+  updateCache(predicted_matches, match_index_to_cache_slot_index);
+
+  // Build the consistency graph.
+  // 构建一致性图
+  BENCHMARK_BLOCK("SM.Worker.Recognition.BuildConsistencyGraph.BuildGraph");
+  return ConsistencyGraph(consistency_graph_edges_.begin(), consistency_graph_edges_.end(),
+                          predicted_matches.size());
+}
+
+const IncrementalGeometricConsistencyRecognizer::PersistentConsistencyGraph*
+IncrementalGeometricConsistencyRecognizer::updatePersistentConsistencyGraph(
+    const PairwiseMatches& predicted_matches, std::vector<size_t>& vertex_match_indices) {
+  if (!params_.enable_persistent_consistency_graph) return nullptr;
+  BENCHMARK_BLOCK("SM.Worker.Recognition.BuildConsistencyGraph");
+  std::vector<size_t> match_index_to_cache_slot_index;
+  updateCache(predicted_matches, match_index_to_cache_slot_index);
+
+  // Apply the changes to the graph. The released cache slots are disconnected first, as they can
+  // be reused by new matches or removed from the cache.
+  // 将变化应用到图上，先断开被释放的缓存槽，因为它们可能被新匹配复用
+  BENCHMARK_BLOCK("SM.Worker.Recognition.BuildConsistencyGraph.UpdateGraph");
+  PersistentConsistencyGraph& graph = persistent_consistency_graph_;
+  for (const size_t cache_slot_index : released_cache_slot_indices_) {
+    graph.clearVertex(cache_slot_index);
+  }
+  // The graph follows the size of the cache, which shrinks after a burst of matches.
+  graph.resize(matches_cache_.size());
+  for (const auto& edge : removed_consistency_graph_edges_) {
+    graph.removeEdge(match_index_to_cache_slot_index[edge.first],
+                     match_index_to_cache_slot_index[edge.second]);
+  }
+  for (const auto& edge : consistency_graph_edges_) {
+    graph.addEdge(match_index_to_cache_slot_index[edge.first],
+                  match_index_to_cache_slot_index[edge.second]);
+  }
+  BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.BuildConsistencyGraph.AddedEdges",
+                         consistency_graph_edges_.size());
+  BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.BuildConsistencyGraph.RemovedEdges",
+                         removed_consistency_graph_edges_.size());
+
+  vertex_match_indices.assign(graph.getNumVertices(), kNoMatch);
+  for (size_t i = 0u; i < predicted_matches.size(); ++i) {
+    vertex_match_indices[match_index_to_cache_slot_index[i]] = i;
+  }
+  return &graph;
+}
 
+void IncrementalGeometricConsistencyRecognizer::updateCache(
+    const PairwiseMatches& predicted_matches,
+    std::vector<size_t>& match_index_to_cache_slot_index) {
   // Resize the cache to fit the new matches.
-  if (predicted_matches.size() > matches_cache_.size())
+  ++num_recognitions_;
+  if (predicted_matches.size() > matches_cache_.size()) {
+    CHECK_LE(predicted_matches.size(), CandidateListPool::kMaxCacheSlot);
     matches_cache_.resize(predicted_matches.size());
+    candidate_lists_.resize(predicted_matches.size());
+  }
   std::vector<size_t> cache_slot_index_to_match_index(matches_cache_.size(), kNoMatchIndex_);
+  cache_statistics_ = CacheStatistics();
+  cache_statistics_.num_matches = predicted_matches.size();
 
   // Identify which matches have cached information.
   // 识别哪些匹配项已经缓存了信息
   size_t invalidated_cached_matches = 0u;
+  size_t evicted_cached_matches = 0u;
+  float max_displacement = 0.0f;
   std::vector<MatchLocations> cached_matches_locations;
   cached_matches_locations.reserve(predicted_matches.size());
-  std::vector<size_t> match_index_to_cache_slot_index(predicted_matches.size(),
-                                                      kNoCacheSlotIndex_);
+  match_index_to_cache_slot_index.assign(predicted_matches.size(), kNoCacheSlotIndex_);
   for (size_t i = 0u; i < predicted_matches.size(); ++i) {
-    const auto cached_info_it = cache_slot_indices_.find(predicted_matches[i].ids_);
-    if (cached_info_it != cache_slot_indices_.end()) {
+    const size_t cache_slot_index = cache_slot_indices_.find(predicted_matches[i].ids_);
+    if (cache_slot_index != IdPairFlatMap::kNotFound) {
       // If a centroid moved by more than the allowed distance, we need to invalidate the cached
-      // information and threat the match as new.
-	  // 如果质心移动超过允许的距离，我们需要使缓存信息失效 和威胁比赛如新。
-      if (mustRemoveFromCache(predicted_matches[i], cached_info_it->second)) {
+      // information and treat the match as new.
+	  // 如果质心移动超过允许的距离，我们需要使缓存信息失效，并将该匹配视为新匹配。
+      if (matches_cache_[cache_slot_index].evicted) {
+        ++evicted_cached_matches;
+      } else if (mustRemoveFromCache(predicted_matches[i], cache_slot_index)) {
         ++invalidated_cached_matches;
       } else {
-        cached_matches_locations.emplace_back(i, cached_info_it->second);
-        cache_slot_index_to_match_index[cached_info_it->second] = i;
-        match_index_to_cache_slot_index[i] = cached_info_it->second;
+        cached_matches_locations.emplace_back(i, cache_slot_index);
+        cache_slot_index_to_match_index[cache_slot_index] = i;
+        match_index_to_cache_slot_index[i] = cache_slot_index;
+        MatchCacheSlot& match_cache = matches_cache_[cache_slot_index];
+        max_displacement = std::max(max_displacement,
+                                    computeDisplacement(match_cache.previous_centroids,
+                                                        predicted_matches[i].centroids_));
+        match_cache.previous_centroids = predicted_matches[i].centroids_;
       }
     }
   }
+  cumulative_drift_ += max_displacement;
   BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.BuildConsistencyGraph.InvalidatedMatches",
                          invalidated_cached_matches);
+  BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.BuildConsistencyGraph.EvictedMatches",
+                         evicted_cached_matches);
   BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.BuildConsistencyGraph.CachedMatches",
                          cached_matches_locations.size());
+  cache_statistics_.num_cached_matches = cached_matches_locations.size();
+  cache_statistics_.num_invalidated_matches = invalidated_cached_matches;
+  cache_statistics_.num_evicted_matches = evicted_cached_matches;
 
   // Collect indices of the cache slots that are not used anymore.
   // 收集不再使用的缓存槽的索引
@@ -233,54 +635,127 @@ IncrementalGeometricConsistencyRecognizer::buildConsistencyGraph(
       free_cache_slot_indices.push_back(i);
   }
 
+  // Collect the cache slots of the previous recognition that are not used anymore, whose
+  // vertices must be disconnected from the persistent graph.
+  // 收集上一次识别中使用、现在不再使用的缓存槽，需要在持久图中断开其顶点
+  released_cache_slot_indices_.clear();
+  if (params_.enable_persistent_consistency_graph) {
+    cache_slot_indices_.forEach([&](const IdPair&, const size_t cache_slot_index) {
+      if (cache_slot_index_to_match_index[cache_slot_index] == kNoMatchIndex_)
+        released_cache_slot_indices_.push_back(cache_slot_index);
+    });
+  }
+
   BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.TotalMatches", predicted_matches.size());
   BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.CachedMatches", cached_matches_locations.size());
 
-  // Build the consistency graph.
-  // 构建一致性图
-  // ConsistencyGraph -> boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS>
-  ConsistencyGraph consistency_graph(predicted_matches.size());
-  std::unordered_map<IdPair, size_t, IdPairHash> new_cache_slot_indices;
-  new_cache_slot_indices.reserve(predicted_matches.size());
+  // Partition the matches in a grid by the position of the scene points. The size of the
+  // partitions is greater or equal the size of the model. This way we can safely assume that, if
+  // the model is actually present in the scene, all matches will be contained in a 2x2 group of
+  // adjacent partitions. The voxel partitioning applies the same reasoning in 3D.
+  
+  // 根据场景点的位置在网格中划分匹配项，分区的尺寸大于等于模型
+  // 这样我们就可以放心地假设，如果这个模型实际上出现在场景中，所有匹配项将包含在一个2x2相邻的分区组中。
+  BENCHMARK_START("SM.Worker.Recognition.BuildConsistencyGraph.Partitioning");
+  if (matches_partitioner_type_ == MatchesPartitionerType::kVoxel) {
+    MatchesVoxelPartitioning<PartitionData> partitioning =
+        MatchesPartitioner::computeVoxelPartitioning<PartitionData>(predicted_matches,
+                                                                    max_consistency_distance_);
+    BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.BuildConsistencyGraph.NumPartitions",
+                           partitioning.getNumPartitions());
+    copyCentroidsInPartitionOrder(predicted_matches, partitioning);
+  } else {
+    MatchesPartitioner::computeFlatGridPartitioning(predicted_matches, max_consistency_distance_,
+                                                    grid_partitioning_);
+    BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.BuildConsistencyGraph.NumPartitions",
+                           grid_partitioning_.getNumPartitions());
+    copyCentroidsInPartitionOrder(predicted_matches, grid_partitioning_);
+  }
+  BENCHMARK_STOP("SM.Worker.Recognition.BuildConsistencyGraph.Partitioning");
+
+  // Find the consistent pairs of matches, which are the edges of the consistency graph.
+  // 找到一致的匹配对，即一致性图的边
+  consistency_graph_edges_.clear();
+  removed_consistency_graph_edges_.clear();
+  new_cache_slot_indices_.clear();
+  new_cache_slot_indices_.reserve(predicted_matches.size());
   // cached_matches_locations  一是candidate_consistent_matches，二是centroids_at_caching
   // cache_slot_index_to_match_index  用kNoMatchIndex_初始化，cache到match的索引映射
   // match_index_to_cache_slot_index  用kNoMatchIndex_初始化，match的索引到cache的映射
   // cache_slot_indices_  一IdPair，二size_t
   processCachedMatches(predicted_matches, cached_matches_locations,
-                       cache_slot_index_to_match_index, new_cache_slot_indices, consistency_graph);
+                       cache_slot_index_to_match_index, new_cache_slot_indices_,
+                       consistency_graph_edges_);
   processNewMatches(predicted_matches, free_cache_slot_indices, match_index_to_cache_slot_index,
-                    new_cache_slot_indices, consistency_graph);
+                    new_cache_slot_indices_, consistency_graph_edges_);
 
-  // Use the new mapping between match IDs and cache slots.
-  cache_slot_indices_ = std::move(new_cache_slot_indices);
-  return consistency_graph;
+  // Use the new mapping between match IDs and cache slots. The storage of the old mapping is
+  // reused in the next recognition.
+  cache_slot_indices_.swap(new_cache_slot_indices_);
+  limitCacheMemory(match_index_to_cache_slot_index);
 }
 
-// 计算一致性距离（scene_dis与model_dis差值）
-// 参数： max_target_distance=50*2
-// 这样是否就没考虑旋转的问题？？？？？？？？？
-inline float IncrementalGeometricConsistencyRecognizer::computeConsistencyDistance(
-    const PairwiseMatch& first_match, const PairwiseMatch& second_match,
-    const float max_target_distance) const {
-  // Get the centroids of the matched segments.
-  // 获取匹配分割的质心
-  pcl::Vector3fMapConst model_point_1 = first_match.centroids_.first.getVector3fMap();
-  pcl::Vector3fMapConst scene_point_1 = first_match.centroids_.second.getVector3fMap();
-  pcl::Vector3fMapConst model_point_2 = second_match.centroids_.first.getVector3fMap();
-  pcl::Vector3fMapConst scene_point_2 = second_match.centroids_.second.getVector3fMap();
-
-  // If the keypoints are so far away in the scene so that they can not fit in the model together,
-  // the matches will not be consistent even if the centroids in the model move.
-  // 如果场景（target）中的关键点离得太远，以至于它们不能一起放入模型中，
-  // 即使模型（source）中的质心移动，匹配也不会是一致的
-  const float scene_distance = (scene_point_1 - scene_point_2).norm();
-  if (scene_distance > max_target_distance)
-    return std::numeric_limits<float>::max();
-
-  // Return the difference between the distances.
-  // 返回距离间的差值
-  const float model_distance = (model_point_1 - model_point_2).norm();
-  return fabs(scene_distance - model_distance);
+// 按分区顺序复制匹配的质心
+void IncrementalGeometricConsistencyRecognizer::copyCentroidsInPartitionOrder(
+    const PairwiseMatches& predicted_matches, const MatchesFlatGridPartitioning& partitioning) {
+  // The flat partitioning already stores the matches in partition order.
+  slot_match_indices_ = partitioning.getMatchIndices();
+  partition_slot_begins_ = partitioning.getPartitionOffsets();
+
+  // The neighbors are the partitions of the 3x3 block centered on the partition.
+  const size_t height = partitioning.getHeight();
+  const size_t width = partitioning.getWidth();
+  partition_neighbor_begins_.clear();
+  partition_neighbor_begins_.reserve(height * width + 1u);
+  partition_neighbors_.clear();
+  for (size_t i = 0; i < height; ++i) {
+    for (size_t j = 0; j < width; ++j) {
+      partition_neighbor_begins_.push_back(partition_neighbors_.size());
+      for (size_t k = static_cast<size_t>(std::max(0, static_cast<int>(i) - 1));
+           k <= std::min(height - 1u, i + 1u); ++k) {
+        for (size_t l = static_cast<size_t>(std::max(0, static_cast<int>(j) - 1));
+             l <= std::min(width - 1u, j + 1u); ++l) {
+          partition_neighbors_.push_back(partitioning.getPartitionIndex(k, l));
+        }
+      }
+    }
+  }
+  partition_neighbor_begins_.push_back(partition_neighbors_.size());
+  assignMatchSlots(predicted_matches);
+}
+
+void IncrementalGeometricConsistencyRecognizer::copyCentroidsInPartitionOrder(
+    const PairwiseMatches& predicted_matches,
+    const MatchesVoxelPartitioning<PartitionData>& partitioning) {
+  const size_t n_partitions = partitioning.getNumPartitions();
+  slot_match_indices_.clear();
+  slot_match_indices_.reserve(predicted_matches.size());
+  partition_slot_begins_.clear();
+  partition_slot_begins_.reserve(n_partitions + 1u);
+  partition_neighbor_begins_.clear();
+  partition_neighbor_begins_.reserve(n_partitions + 1u);
+  partition_neighbors_.clear();
+  for (size_t i = 0u; i < n_partitions; ++i) {
+    partition_slot_begins_.push_back(slot_match_indices_.size());
+    slot_match_indices_.insert(slot_match_indices_.end(), partitioning[i].match_indices.begin(),
+                               partitioning[i].match_indices.end());
+    partition_neighbor_begins_.push_back(partition_neighbors_.size());
+    partition_neighbors_.insert(partition_neighbors_.end(),
+                                partitioning[i].neighbor_partitions.begin(),
+                                partitioning[i].neighbor_partitions.end());
+  }
+  partition_slot_begins_.push_back(slot_match_indices_.size());
+  partition_neighbor_begins_.push_back(partition_neighbors_.size());
+  assignMatchSlots(predicted_matches);
+}
+
+void IncrementalGeometricConsistencyRecognizer::assignMatchSlots(
+    const PairwiseMatches& predicted_matches) {
+  match_slots_.resize(predicted_matches.size());
+  for (size_t slot = 0u; slot < slot_match_indices_.size(); ++slot) {
+    match_slots_[slot_match_indices_[slot]] = slot;
+  }
+  match_centroids_.assign(predicted_matches, slot_match_indices_);
 }
 
 } // namespace bron_kerbosch
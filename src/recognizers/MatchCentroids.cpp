@@ -0,0 +1,194 @@
+#include "recognizers/MatchCentroids.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX512F__) || defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include <glog/logging.h>
+
+namespace bron_kerbosch {
+
+namespace {
+// Centroids of the match compared to the candidates.
+struct QueryCentroids {
+  float model_x, model_y, model_z;
+  float scene_x, scene_y, scene_z;
+};
+
+// Number of candidates gathered at once by the gathering kernel.
+constexpr size_t kGatherBlockSize = 64u;
+
+// Computes the consistency distances between the query and \c n candidates whose coordinates are
+// stored in contiguous arrays. All the code paths compute the same expression: the larger of the
+// difference of the scene and model distances and of the excess of the scene distance over the
+// maximum scene distance.
+void computeDistances(const QueryCentroids& query, const float* model_x, const float* model_y,
+                      const float* model_z, const float* scene_x, const float* scene_y,
+                      const float* scene_z, const size_t n, const float max_scene_distance,
+                      float* distances) {
+  size_t i = 0u;
+
+#if defined(__AVX512F__)
+  const __m512 query_model_x = _mm512_set1_ps(query.model_x);
+  const __m512 query_model_y = _mm512_set1_ps(query.model_y);
+  const __m512 query_model_z = _mm512_set1_ps(query.model_z);
+  const __m512 query_scene_x = _mm512_set1_ps(query.scene_x);
+  const __m512 query_scene_y = _mm512_set1_ps(query.scene_y);
+  const __m512 query_scene_z = _mm512_set1_ps(query.scene_z);
+  const __m512 max_scene = _mm512_set1_ps(max_scene_distance);
+  for (; i + 16u <= n; i += 16u) {
+    const __m512 scene_dx = _mm512_sub_ps(_mm512_loadu_ps(scene_x + i), query_scene_x);
+    const __m512 scene_dy = _mm512_sub_ps(_mm512_loadu_ps(scene_y + i), query_scene_y);
+    const __m512 scene_dz = _mm512_sub_ps(_mm512_loadu_ps(scene_z + i), query_scene_z);
+    const __m512 model_dx = _mm512_sub_ps(_mm512_loadu_ps(model_x + i), query_model_x);
+    const __m512 model_dy = _mm512_sub_ps(_mm512_loadu_ps(model_y + i), query_model_y);
+    const __m512 model_dz = _mm512_sub_ps(_mm512_loadu_ps(model_z + i), query_model_z);
+    const __m512 scene_squared = _mm512_add_ps(_mm512_add_ps(
+        _mm512_mul_ps(scene_dx, scene_dx), _mm512_mul_ps(scene_dy, scene_dy)),
+        _mm512_mul_ps(scene_dz, scene_dz));
+    const __m512 model_squared = _mm512_add_ps(_mm512_add_ps(
+        _mm512_mul_ps(model_dx, model_dx), _mm512_mul_ps(model_dy, model_dy)),
+        _mm512_mul_ps(model_dz, model_dz));
+    const __m512 scene_distance = _mm512_sqrt_ps(scene_squared);
+    const __m512 difference = _mm512_abs_ps(
+        _mm512_sub_ps(scene_distance, _mm512_sqrt_ps(model_squared)));
+    _mm512_storeu_ps(distances + i, _mm512_max_ps(difference,
+                                                  _mm512_sub_ps(scene_distance, max_scene)));
+  }
+#elif defined(__AVX__)
+  const __m256 query_model_x = _mm256_set1_ps(query.model_x);
+  const __m256 query_model_y = _mm256_set1_ps(query.model_y);
+  const __m256 query_model_z = _mm256_set1_ps(query.model_z);
+  const __m256 query_scene_x = _mm256_set1_ps(query.scene_x);
+  const __m256 query_scene_y = _mm256_set1_ps(query.scene_y);
+  const __m256 query_scene_z = _mm256_set1_ps(query.scene_z);
+  const __m256 max_scene = _mm256_set1_ps(max_scene_distance);
+  const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+  for (; i + 8u <= n; i += 8u) {
+    const __m256 scene_dx = _mm256_sub_ps(_mm256_loadu_ps(scene_x + i), query_scene_x);
+    const __m256 scene_dy = _mm256_sub_ps(_mm256_loadu_ps(scene_y + i), query_scene_y);
+    const __m256 scene_dz = _mm256_sub_ps(_mm256_loadu_ps(scene_z + i), query_scene_z);
+    const __m256 model_dx = _mm256_sub_ps(_mm256_loadu_ps(model_x + i), query_model_x);
+    const __m256 model_dy = _mm256_sub_ps(_mm256_loadu_ps(model_y + i), query_model_y);
+    const __m256 model_dz = _mm256_sub_ps(_mm256_loadu_ps(model_z + i), query_model_z);
+    const __m256 scene_squared = _mm256_add_ps(_mm256_add_ps(
+        _mm256_mul_ps(scene_dx, scene_dx), _mm256_mul_ps(scene_dy, scene_dy)),
+        _mm256_mul_ps(scene_dz, scene_dz));
+    const __m256 model_squared = _mm256_add_ps(_mm256_add_ps(
+        _mm256_mul_ps(model_dx, model_dx), _mm256_mul_ps(model_dy, model_dy)),
+        _mm256_mul_ps(model_dz, model_dz));
+    const __m256 scene_distance = _mm256_sqrt_ps(scene_squared);
+    const __m256 difference = _mm256_andnot_ps(
+        sign_mask, _mm256_sub_ps(scene_distance, _mm256_sqrt_ps(model_squared)));
+    _mm256_storeu_ps(distances + i, _mm256_max_ps(difference,
+                                                  _mm256_sub_ps(scene_distance, max_scene)));
+  }
+#elif defined(__SSE2__)
+  const __m128 query_model_x = _mm_set1_ps(query.model_x);
+  const __m128 query_model_y = _mm_set1_ps(query.model_y);
+  const __m128 query_model_z = _mm_set1_ps(query.model_z);
+  const __m128 query_scene_x = _mm_set1_ps(query.scene_x);
+  const __m128 query_scene_y = _mm_set1_ps(query.scene_y);
+  const __m128 query_scene_z = _mm_set1_ps(query.scene_z);
+  const __m128 max_scene = _mm_set1_ps(max_scene_distance);
+  const __m128 sign_mask = _mm_set1_ps(-0.0f);
+  for (; i + 4u <= n; i += 4u) {
+    const __m128 scene_dx = _mm_sub_ps(_mm_loadu_ps(scene_x + i), query_scene_x);
+    const __m128 scene_dy = _mm_sub_ps(_mm_loadu_ps(scene_y + i), query_scene_y);
+    const __m128 scene_dz = _mm_sub_ps(_mm_loadu_ps(scene_z + i), query_scene_z);
+    const __m128 model_dx = _mm_sub_ps(_mm_loadu_ps(model_x + i), query_model_x);
+    const __m128 model_dy = _mm_sub_ps(_mm_loadu_ps(model_y + i), query_model_y);
+    const __m128 model_dz = _mm_sub_ps(_mm_loadu_ps(model_z + i), query_model_z);
+    const __m128 scene_squared = _mm_add_ps(_mm_add_ps(
+        _mm_mul_ps(scene_dx, scene_dx), _mm_mul_ps(scene_dy, scene_dy)),
+        _mm_mul_ps(scene_dz, scene_dz));
+    const __m128 model_squared = _mm_add_ps(_mm_add_ps(
+        _mm_mul_ps(model_dx, model_dx), _mm_mul_ps(model_dy, model_dy)),
+        _mm_mul_ps(model_dz, model_dz));
+    const __m128 scene_distance = _mm_sqrt_ps(scene_squared);
+    const __m128 difference = _mm_andnot_ps(
+        sign_mask, _mm_sub_ps(scene_distance, _mm_sqrt_ps(model_squared)));
+    _mm_storeu_ps(distances + i, _mm_max_ps(difference, _mm_sub_ps(scene_distance, max_scene)));
+  }
+#endif
+
+  // Scalar fallback and remainder.
+  for (; i < n; ++i) {
+    const float scene_dx = scene_x[i] - query.scene_x;
+    const float scene_dy = scene_y[i] - query.scene_y;
+    const float scene_dz = scene_z[i] - query.scene_z;
+    const float model_dx = model_x[i] - query.model_x;
+    const float model_dy = model_y[i] - query.model_y;
+    const float model_dz = model_z[i] - query.model_z;
+    const float scene_squared = scene_dx * scene_dx + scene_dy * scene_dy + scene_dz * scene_dz;
+    const float model_squared = model_dx * model_dx + model_dy * model_dy + model_dz * model_dz;
+    const float scene_distance = std::sqrt(scene_squared);
+    distances[i] = std::max(std::fabs(scene_distance - std::sqrt(model_squared)),
+                            scene_distance - max_scene_distance);
+  }
+}
+} // namespace
+
+void MatchCentroids::assign(const PairwiseMatches& matches,
+                            const std::vector<size_t>& match_indices) {
+  const size_t n_slots = match_indices.size();
+  model_x_.resize(n_slots);
+  model_y_.resize(n_slots);
+  model_z_.resize(n_slots);
+  scene_x_.resize(n_slots);
+  scene_y_.resize(n_slots);
+  scene_z_.resize(n_slots);
+  for (size_t i = 0u; i < n_slots; ++i) {
+    const PointPair& centroids = matches[match_indices[i]].centroids_;
+    model_x_[i] = centroids.first.x;
+    model_y_[i] = centroids.first.y;
+    model_z_[i] = centroids.first.z;
+    scene_x_[i] = centroids.second.x;
+    scene_y_[i] = centroids.second.y;
+    scene_z_[i] = centroids.second.z;
+  }
+}
+
+void MatchCentroids::computeConsistencyDistances(const size_t slot, const size_t begin,
+                                                 const size_t end,
+                                                 const float max_scene_distance,
+                                                 float* distances) const {
+  DCHECK_LE(begin, end);
+  DCHECK_LE(end, size());
+  const QueryCentroids query = { model_x_[slot], model_y_[slot], model_z_[slot],
+                                 scene_x_[slot], scene_y_[slot], scene_z_[slot] };
+  computeDistances(query, model_x_.data() + begin, model_y_.data() + begin,
+                   model_z_.data() + begin, scene_x_.data() + begin, scene_y_.data() + begin,
+                   scene_z_.data() + begin, end - begin, max_scene_distance, distances);
+}
+
+void MatchCentroids::computeConsistencyDistances(const size_t slot,
+                                                 const std::vector<size_t>& candidate_slots,
+                                                 const float max_scene_distance,
+                                                 float* distances) const {
+  const QueryCentroids query = { model_x_[slot], model_y_[slot], model_z_[slot],
+                                 scene_x_[slot], scene_y_[slot], scene_z_[slot] };
+  alignas(64) float model_x[kGatherBlockSize], model_y[kGatherBlockSize],
+      model_z[kGatherBlockSize], scene_x[kGatherBlockSize], scene_y[kGatherBlockSize],
+      scene_z[kGatherBlockSize];
+  for (size_t block_begin = 0u; block_begin < candidate_slots.size();
+       block_begin += kGatherBlockSize) {
+    const size_t block_size = std::min(kGatherBlockSize, candidate_slots.size() - block_begin);
+    for (size_t i = 0u; i < block_size; ++i) {
+      const size_t candidate_slot = candidate_slots[block_begin + i];
+      model_x[i] = model_x_[candidate_slot];
+      model_y[i] = model_y_[candidate_slot];
+      model_z[i] = model_z_[candidate_slot];
+      scene_x[i] = scene_x_[candidate_slot];
+      scene_y[i] = scene_y_[candidate_slot];
+      scene_z[i] = scene_z_[candidate_slot];
+    }
+    computeDistances(query, model_x, model_y, model_z, scene_x, scene_y, scene_z, block_size,
+                     max_scene_distance, distances + block_begin);
+  }
+}
+
+} // namespace bron_kerbosch
@@ -0,0 +1,138 @@
+#include "recognizers/MatchesPartitioner.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+namespace bron_kerbosch {
+
+namespace {
+// Number of bits per axis of the quantized coordinates used for the Morton codes.
+constexpr unsigned kMortonBitsPerAxis = 21u;
+
+// Spreads the lower 21 bits of a value so that there are two zero bits between consecutive bits.
+inline std::uint64_t spreadBitsBy3(std::uint64_t value) {
+  value &= 0x1fffffu;
+  value = (value | value << 32) & 0x1f00000000ffffu;
+  value = (value | value << 16) & 0x1f0000ff0000ffu;
+  value = (value | value << 8) & 0x100f00f00f00f00fu;
+  value = (value | value << 4) & 0x10c30c30c30c30c3u;
+  value = (value | value << 2) & 0x1249249249249249u;
+  return value;
+}
+
+// Quantizes a coordinate to kMortonBitsPerAxis bits given the bounds of the coordinates.
+inline std::uint64_t quantizeCoordinate(const float value, const float min_value,
+                                        const float scale) {
+  return std::min(static_cast<std::uint64_t>((value - min_value) * scale),
+                  (std::uint64_t(1u) << kMortonBitsPerAxis) - 1u);
+}
+} // namespace
+
+void MatchesPartitioner::computeFlatGridPartitioning(const PairwiseMatches& matches,
+                                                     const float partition_size,
+                                                     MatchesFlatGridPartitioning& partitioning) {
+  // Validate inputs.
+  CHECK_GT(partition_size, 0.0f);
+  partitioning.match_indices_.clear();
+  partitioning.partition_offsets_.assign(1u, 0u);
+  partitioning.width_ = 0u;
+  partitioning.height_ = 0u;
+  if (matches.empty()) return;
+
+  // Find corners of the partitioning grid.
+  // 找分割栅格的角点
+  float min_x = std::numeric_limits<float>::max();
+  float min_y = std::numeric_limits<float>::max();
+  float max_x = std::numeric_limits<float>::lowest();
+  float max_y = std::numeric_limits<float>::lowest();
+  for (const auto& match : matches) {
+    min_x = std::min(min_x, match.centroids_.second.x);
+    min_y = std::min(min_y, match.centroids_.second.y);
+    max_x = std::max(max_x, match.centroids_.second.x);
+    max_y = std::max(max_y, match.centroids_.second.y);
+  }
+
+  // Compute grid parameters.
+  // 计算栅格参数
+  const float partition_size_inv = 1.0f / partition_size;
+  const size_t width =
+      std::max(static_cast<size_t>(std::ceil((max_x - min_x) * partition_size_inv)), size_t(1u));
+  const size_t height =
+      std::max(static_cast<size_t>(std::ceil((max_y - min_y) * partition_size_inv)), size_t(1u));
+  partitioning.width_ = width;
+  partitioning.height_ = height;
+
+  // 1) Find the partition of every match and count the matches of every partition. Matches on
+  // the upper borders of the grid belong to the last partitions.
+  // 1) 找到每个匹配的分区并统计每个分区的匹配数量
+  partitioning.partition_offsets_.assign(width * height + 1u, 0u);
+  partitioning.match_partitions_.resize(matches.size());
+  for (size_t i = 0u; i < matches.size(); ++i) {
+    const size_t x = std::min(
+        static_cast<size_t>((matches[i].centroids_.second.x - min_x) * partition_size_inv),
+        width - 1u);
+    const size_t y = std::min(
+        static_cast<size_t>((matches[i].centroids_.second.y - min_y) * partition_size_inv),
+        height - 1u);
+    const size_t partition = y * width + x;
+    partitioning.match_partitions_[i] = partition;
+    ++partitioning.partition_offsets_[partition + 1u];
+  }
+  for (size_t p = 0u; p < width * height; ++p) {
+    partitioning.partition_offsets_[p + 1u] += partitioning.partition_offsets_[p];
+  }
+
+  // 2) Write the indices, using the offsets as insertion points. Matches are visited in order, so
+  // the indices of every partition are sorted.
+  // 2) 以偏移作为插入点写入索引
+  partitioning.match_indices_.resize(matches.size());
+  for (size_t i = 0u; i < matches.size(); ++i) {
+    partitioning.match_indices_[partitioning.partition_offsets_[
+        partitioning.match_partitions_[i]]++] = i;
+  }
+
+  // The insertion points are now the offsets of the following partitions. Shift them back.
+  for (size_t p = width * height; p > 0u; --p) {
+    partitioning.partition_offsets_[p] = partitioning.partition_offsets_[p - 1u];
+  }
+  partitioning.partition_offsets_[0] = 0u;
+}
+
+void MatchesPartitioner::computeMortonOrder(const PairwiseMatches& matches,
+                                            std::vector<size_t>& order) {
+  order.resize(matches.size());
+  if (matches.empty()) return;
+
+  // Find the bounding box of the scene centroids.
+  // 找到场景质心的包围盒
+  Eigen::Vector3f min_corner = Eigen::Vector3f::Constant(std::numeric_limits<float>::max());
+  Eigen::Vector3f max_corner = Eigen::Vector3f::Constant(std::numeric_limits<float>::lowest());
+  for (const auto& match : matches) {
+    const Eigen::Vector3f scene_centroid = match.centroids_.second.getVector3fMap();
+    min_corner = min_corner.cwiseMin(scene_centroid);
+    max_corner = max_corner.cwiseMax(scene_centroid);
+  }
+
+  // Compute the Morton codes of the quantized scene centroids. The same scale is used for all the
+  // axes, so that the curve follows the actual distances.
+  // 计算量化后的场景质心的Morton码
+  const float extent = std::max((max_corner - min_corner).maxCoeff(),
+                                std::numeric_limits<float>::min());
+  const float scale = static_cast<float>((1u << kMortonBitsPerAxis) - 1u) / extent;
+  std::vector<std::pair<std::uint64_t, size_t>> codes(matches.size());
+  for (size_t i = 0u; i < matches.size(); ++i) {
+    const PclPoint& scene_centroid = matches[i].centroids_.second;
+    codes[i].first =
+        spreadBitsBy3(quantizeCoordinate(scene_centroid.x, min_corner.x(), scale)) |
+        spreadBitsBy3(quantizeCoordinate(scene_centroid.y, min_corner.y(), scale)) << 1 |
+        spreadBitsBy3(quantizeCoordinate(scene_centroid.z, min_corner.z(), scale)) << 2;
+    codes[i].second = i;
+  }
+  std::sort(codes.begin(), codes.end());
+  for (size_t i = 0u; i < matches.size(); ++i) order[i] = codes[i].second;
+}
+
+} // namespace bron_kerbosch
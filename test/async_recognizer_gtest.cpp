@@ -0,0 +1,108 @@
+#include <future>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "recognizers/AsyncRecognizer.hpp"
+#include "test_helpers.hpp"
+
+namespace bron_kerbosch {
+namespace {
+
+using test::getSortedModelIds;
+using test::makeParams;
+
+// Frames of a stream: the true matches move slightly and the outliers change in every frame.
+std::vector<PairwiseMatches> makeFrames(const size_t num_frames, const size_t num_outliers) {
+  std::vector<PairwiseMatches> frames;
+  for (size_t i = 0u; i < num_frames; ++i) {
+    frames.push_back(test::makeScene(20u, num_outliers, static_cast<unsigned int>(i), 0.05f));
+  }
+  return frames;
+}
+
+// Checks that the results of the asynchronous recognizer are the results of the recognize()
+// calls of a recognizer on the frames that were not dropped, in the same order.
+void expectResultsOfSequentialRecognition(const GeometricConsistencyParams& params,
+                                          const std::vector<PairwiseMatches>& frames,
+                                          const std::vector<AsyncRecognizer::Result>& results) {
+  ASSERT_EQ(frames.size(), results.size());
+  IncrementalGeometricConsistencyRecognizer recognizer(params, test::kMaxModelRadius);
+  for (size_t i = 0u; i < frames.size(); ++i) {
+    SCOPED_TRACE(i);
+    if (results[i].dropped) continue;
+    recognizer.recognize(frames[i]);
+    ASSERT_EQ(recognizer.getCandidateClusters().size(), results[i].candidate_clusters.size());
+    ASSERT_EQ(recognizer.getCandidateTransformations().size(),
+              results[i].candidate_transformations.size());
+    for (size_t j = 0u; j < results[i].candidate_clusters.size(); ++j) {
+      EXPECT_EQ(getSortedModelIds(recognizer.getCandidateClusters()[j]),
+                getSortedModelIds(results[i].candidate_clusters[j]));
+      EXPECT_TRUE(recognizer.getCandidateTransformations()[j].isApprox(
+          results[i].candidate_transformations[j]));
+    }
+  }
+}
+
+TEST(AsyncRecognizerTest, BlockingResultsMatchSequentialRecognition) {
+  const std::vector<PairwiseMatches> frames = makeFrames(12u, 200u);
+  for (const bool persistent_graph : { false, true }) {
+    SCOPED_TRACE(persistent_graph);
+    GeometricConsistencyParams params = makeParams();
+    params.enable_persistent_consistency_graph = persistent_graph;
+
+    std::vector<AsyncRecognizer::Result> results;
+    {
+      AsyncRecognizer async_recognizer(params, test::kMaxModelRadius, 2u,
+                                       AsyncRecognizer::QueueFullPolicy::kBlock);
+      std::vector<std::future<AsyncRecognizer::Result>> futures;
+      for (const PairwiseMatches& frame : frames) futures.push_back(async_recognizer.submit(frame));
+      for (auto& future : futures) results.push_back(future.get());
+      EXPECT_EQ(0u, async_recognizer.getNumDroppedFrames());
+    }
+
+    for (const AsyncRecognizer::Result& result : results) {
+      EXPECT_FALSE(result.dropped);
+      EXPECT_FALSE(result.candidate_clusters.empty());
+    }
+    expectResultsOfSequentialRecognition(params, frames, results);
+  }
+}
+
+TEST(AsyncRecognizerTest, DropOldestMarksDroppedFrames) {
+  // The frames are submitted much faster than they are recognized, so the queue of one frame
+  // overflows.
+  const std::vector<PairwiseMatches> frames = makeFrames(30u, 600u);
+  for (const bool persistent_graph : { false, true }) {
+    SCOPED_TRACE(persistent_graph);
+    GeometricConsistencyParams params = makeParams();
+    params.enable_persistent_consistency_graph = persistent_graph;
+
+    std::vector<AsyncRecognizer::Result> results;
+    size_t num_dropped_frames;
+    {
+      AsyncRecognizer async_recognizer(params, test::kMaxModelRadius, 1u,
+                                       AsyncRecognizer::QueueFullPolicy::kDropOldest);
+      std::vector<std::future<AsyncRecognizer::Result>> futures;
+      for (const PairwiseMatches& frame : frames) futures.push_back(async_recognizer.submit(frame));
+      for (auto& future : futures) results.push_back(future.get());
+      num_dropped_frames = async_recognizer.getNumDroppedFrames();
+    }
+
+    size_t num_dropped_results = 0u;
+    for (const AsyncRecognizer::Result& result : results) {
+      if (!result.dropped) continue;
+      ++num_dropped_results;
+      EXPECT_TRUE(result.candidate_clusters.empty());
+      EXPECT_TRUE(result.candidate_transformations.empty());
+    }
+    EXPECT_GT(num_dropped_frames, 0u);
+    EXPECT_EQ(num_dropped_frames, num_dropped_results);
+    // No frame is submitted after the last one, which is never dropped.
+    EXPECT_FALSE(results.back().dropped);
+    expectResultsOfSequentialRecognition(params, frames, results);
+  }
+}
+
+} // namespace
+} // namespace bron_kerbosch
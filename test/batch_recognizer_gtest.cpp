@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "recognizers/BatchRecognizer.hpp"
+#include "test_helpers.hpp"
+
+namespace bron_kerbosch {
+namespace {
+
+using test::getSortedModelIds;
+using test::makeParams;
+
+constexpr Id kGroupIdOffset = 100000;
+
+// Checks that the result is the result of a new recognizer on the matches.
+void expectResultOfNewRecognizer(const PairwiseMatches& matches,
+                                 const BatchRecognizer::Result& result) {
+  IncrementalGeometricConsistencyRecognizer recognizer(makeParams(), test::kMaxModelRadius);
+  recognizer.recognize(matches);
+  ASSERT_EQ(recognizer.getCandidateClusters().size(), result.candidate_clusters.size());
+  ASSERT_EQ(recognizer.getCandidateTransformations().size(),
+            result.candidate_transformations.size());
+  for (size_t i = 0u; i < result.candidate_clusters.size(); ++i) {
+    EXPECT_EQ(getSortedModelIds(recognizer.getCandidateClusters()[i]),
+              getSortedModelIds(result.candidate_clusters[i]));
+    EXPECT_TRUE(recognizer.getCandidateTransformations()[i].isApprox(
+        result.candidate_transformations[i]));
+  }
+}
+
+// Sets of various sizes, some of which do not contain the model.
+std::vector<PairwiseMatches> makeMatchSets(const size_t num_sets, const unsigned int seed) {
+  std::vector<PairwiseMatches> match_sets;
+  for (size_t i = 0u; i < num_sets; ++i) {
+    const unsigned int set_seed = seed + static_cast<unsigned int>(i);
+    match_sets.push_back(test::makeScene(set_seed % 3u == 0u ? 3u : 15u + i, 50u + 40u * (i % 4u),
+                                         set_seed, 0.05f));
+  }
+  return match_sets;
+}
+
+// Matches of the groups, whose model segment IDs are offset by kGroupIdOffset times the group
+// key. The matches of the groups are interleaved.
+PairwiseMatches makeGroupedMatches(const std::vector<Id>& group_keys, const unsigned int seed) {
+  std::vector<PairwiseMatches> group_matches;
+  for (size_t i = 0u; i < group_keys.size(); ++i) {
+    PairwiseMatches matches = test::makeScene(12u + 4u * i, 80u, seed + i, 0.05f);
+    for (PairwiseMatch& match : matches) match.ids_.first += kGroupIdOffset * group_keys[i];
+    group_matches.push_back(matches);
+  }
+  size_t max_group_size = 0u;
+  for (const PairwiseMatches& matches : group_matches)
+    max_group_size = std::max(max_group_size, matches.size());
+  PairwiseMatches predicted_matches;
+  for (size_t i = 0u; i < max_group_size; ++i) {
+    for (const PairwiseMatches& matches : group_matches) {
+      if (i < matches.size()) predicted_matches.push_back(matches[i]);
+    }
+  }
+  return predicted_matches;
+}
+
+TEST(BatchRecognizerTest, ResultsMatchNewRecognizers) {
+  for (const size_t num_threads : { 1u, 3u }) {
+    SCOPED_TRACE(num_threads);
+    BatchRecognizer batch_recognizer(makeParams(), test::kMaxModelRadius, num_threads);
+    std::vector<BatchRecognizer::Result> results;
+    // The second batch is smaller than the first one and reuses its results.
+    for (const size_t num_sets : { 7u, 4u }) {
+      const std::vector<PairwiseMatches> match_sets = makeMatchSets(num_sets, num_sets);
+      batch_recognizer.recognize(match_sets, results);
+      ASSERT_EQ(match_sets.size(), results.size());
+      for (size_t i = 0u; i < match_sets.size(); ++i) {
+        SCOPED_TRACE(i);
+        expectResultOfNewRecognizer(match_sets[i], results[i]);
+      }
+    }
+  }
+}
+
+TEST(BatchRecognizerTest, ModelGroupsAreRecognizedSeparately) {
+  BatchRecognizer batch_recognizer(makeParams(), test::kMaxModelRadius, 2u);
+  const BatchRecognizer::ModelGroupFunction get_model_group = [](const Id model_segment_id) {
+    return model_segment_id / kGroupIdOffset;
+  };
+  std::vector<BatchRecognizer::GroupResult> group_results;
+  // Fewer groups than in the previous call, then more again.
+  const std::vector<std::vector<Id>> calls = { { 4, 1, 7 }, { 2 }, { 5, 3, 8, 6 } };
+  for (size_t call = 0u; call < calls.size(); ++call) {
+    SCOPED_TRACE(call);
+    const PairwiseMatches predicted_matches =
+        makeGroupedMatches(calls[call], static_cast<unsigned int>(call));
+    batch_recognizer.recognizeModelGroups(predicted_matches, get_model_group, group_results);
+
+    std::vector<Id> expected_keys = calls[call];
+    std::sort(expected_keys.begin(), expected_keys.end());
+    ASSERT_EQ(expected_keys.size(), group_results.size());
+    for (size_t i = 0u; i < group_results.size(); ++i) {
+      SCOPED_TRACE(i);
+      EXPECT_EQ(expected_keys[i], group_results[i].group_key);
+      PairwiseMatches group_matches;
+      for (const PairwiseMatch& match : predicted_matches) {
+        if (get_model_group(match.ids_.first) == group_results[i].group_key)
+          group_matches.push_back(match);
+      }
+      EXPECT_EQ(group_matches.size(), group_results[i].num_matches);
+      EXPECT_FALSE(group_results[i].result.candidate_clusters.empty());
+      expectResultOfNewRecognizer(group_matches, group_results[i].result);
+    }
+  }
+}
+
+} // namespace
+} // namespace bron_kerbosch
@@ -1,286 +1,475 @@
-#include <limits>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
 #include <vector>
 
-#include <glog/logging.h>
-#include "Benchmark.h"
+#include <gtest/gtest.h>
+
 #include "recognizers/IncrementalGeometricConsistencyRecognizer.hpp"
-#include "recognizers/MatchesPartitioner.hpp"
+#include "test_helpers.hpp"
+
 namespace bron_kerbosch {
+namespace {
+
+using test::getSortedModelIds;
+using test::makeParams;
+
+typedef std::set<std::pair<size_t, size_t>> EdgeSet;
+
+// Exposes the consistency graphs built by the recognizer as sets of pairs of match indices.
+class ConsistencyGraphProbe : public IncrementalGeometricConsistencyRecognizer {
+ public:
+  using IncrementalGeometricConsistencyRecognizer::IncrementalGeometricConsistencyRecognizer;
+
+  EdgeSet getRebuiltEdges(const PairwiseMatches& matches) {
+    const ConsistencyGraph graph = buildConsistencyGraph(matches);
+    std::vector<size_t> vertex_match_indices(graph.getNumVertices());
+    for (size_t v = 0u; v < vertex_match_indices.size(); ++v) vertex_match_indices[v] = v;
+    return getEdges(graph, vertex_match_indices);
+  }
+
+  EdgeSet getPersistentEdges(const PairwiseMatches& matches) {
+    std::vector<size_t> vertex_match_indices;
+    const PersistentConsistencyGraph* graph =
+        updatePersistentConsistencyGraph(matches, vertex_match_indices);
+    EXPECT_NE(nullptr, graph);
+    return graph == nullptr ? EdgeSet() : getEdges(*graph, vertex_match_indices);
+  }
 
-constexpr size_t IncrementalGeometricConsistencyRecognizer::kNoMatchIndex_;
-constexpr size_t IncrementalGeometricConsistencyRecognizer::kNoCacheSlotIndex_;
-
-// 初始化
-// 注意初始化列表
-IncrementalGeometricConsistencyRecognizer::IncrementalGeometricConsistencyRecognizer(
-    const GeometricConsistencyParams& params, const float max_model_radius) noexcept
-  : GraphBasedGeometricConsistencyRecognizer(params)
-  // 此处max_model_radius为50
-  // resolution为0.4或0.6
-  , max_consistency_distance_(max_model_radius * 2.0 + params.resolution)
-  // max_consistency_distance_for_caching为3
-  , max_consistency_distance_for_caching_(
-      params.max_consistency_distance_for_caching + params.resolution)
-  , half_max_consistency_distance_for_caching_(params.max_consistency_distance_for_caching * 0.5f) {
+ private:
+  template <typename Graph>
+  static EdgeSet getEdges(const Graph& graph, const std::vector<size_t>& vertex_match_indices) {
+    EdgeSet edges;
+    for (size_t v = 0u; v < graph.getNumVertices(); ++v) {
+      const auto neighbors = graph.getNeighbors(v);
+      for (auto neighbor = neighbors.first; neighbor != neighbors.second; ++neighbor) {
+        const size_t a = vertex_match_indices[v];
+        const size_t b = vertex_match_indices[*neighbor];
+        EXPECT_NE(kNoMatch, a);
+        EXPECT_NE(kNoMatch, b);
+        edges.emplace(std::min(a, b), std::max(a, b));
+      }
+    }
+    return edges;
+  }
+};
+
+// Matches whose scene centroids follow the model centroids up to a noise comparable to the
+// resolution, so that many pairs have consistency distances close to the resolution.
+PairwiseMatches makeDenseScene(const size_t num_matches, const unsigned int seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> position(-15.0f, 15.0f);
+  std::uniform_real_distribution<float> noise(-0.3f, 0.3f);
+  const Eigen::Affine3f transformation = test::getSceneTransformation();
+  PairwiseMatches matches;
+  for (size_t i = 0u; i < num_matches; ++i) {
+    const Eigen::Vector3f model(position(rng), position(rng), position(rng) * 0.1f);
+    const Eigen::Vector3f scene = transformation * model +
+        Eigen::Vector3f(noise(rng), noise(rng), noise(rng));
+    matches.emplace_back(i, i, PclPoint(model.x(), model.y(), model.z()),
+                         PclPoint(scene.x(), scene.y(), scene.z()), 1.0f);
+  }
+  return matches;
 }
 
-// 处理缓存中已存在的预测匹配，清理旧条目，找到一致性并添加到一致性图
-// 参数： cached_matches_locations  match的索引，缓存的索引
-// cache_slot_index_to_match_index  从缓存到match的索引映射
-inline void IncrementalGeometricConsistencyRecognizer::processCachedMatches(
-    const PairwiseMatches& predicted_matches,
-    const std::vector<MatchLocations>& cached_matches_locations,
-    const std::vector<size_t>& cache_slot_index_to_match_index,
-    std::unordered_map<IdPair, size_t, IdPairHash>& new_cache_slot_indices,
-    ConsistencyGraph& consistency_graph) {
-  BENCHMARK_BLOCK("SM.Worker.Recognition.BuildConsistencyGraph.CachedMatches");
-
-  // Recompute consistency information of cached elements where necessary.
-  // 必要时重新计算缓存元素的一致性信息。
-  size_t num_consistency_tests = 0u;
-  for (const auto& cached_match_locations : cached_matches_locations) {
-	// match 匹配对
-	// match_cache 缓存的匹配对
-	// new_cache_slot_indices  存储match的ids 和 缓存索引
-    const PairwiseMatch& match = predicted_matches[cached_match_locations.match_index];
-    MatchCacheSlot& match_cache = matches_cache_[cached_match_locations.cache_slot_index];
-    new_cache_slot_indices.emplace(match.ids_, cached_match_locations.cache_slot_index);
-
-    // For each cached element, get rid of any reference to matches that do not exist anymore and
-    // add consistent pairs to the consistency graph.
-	// 对于每个缓存的元素，删除不再存在的匹配项的所有引用，并向一致性图中添加一致性对。
-    std::vector<size_t> new_candidate_consistent_matches;
-    new_candidate_consistent_matches.reserve(match_cache.candidate_consistent_matches.size());
-    for (const size_t candidate_cache_slot_index : match_cache.candidate_consistent_matches) {
-      const size_t match_2_index = cache_slot_index_to_match_index[candidate_cache_slot_index];
-	  // 不等于kNoMatchIndex_，说明从缓存中移除了
-      if (match_2_index != kNoMatchIndex_) {
-        const PairwiseMatch& match_2 = predicted_matches[match_2_index];
-		// match
-        float consistency_distance = computeConsistencyDistance(match, match_2,
-                                                                max_consistency_distance_);
-        ++num_consistency_tests;
-
-        // If the matches are close enough, cache them as candidate consistent matches.
-		// 如果匹配足够接近，缓存作为候选一致匹配（阈值约为100）
-        if (consistency_distance <= max_consistency_distance_) {
-          new_candidate_consistent_matches.emplace_back(candidate_cache_slot_index);
-
-          // If the matches are consistent, add and edge to the consistency graph
-		  // 如果匹配一致，将边添加到一致性图（阈值为0.4或0.6）
-          if (consistency_distance <= params_.resolution)
-            boost::add_edge(match_2_index, cached_match_locations.match_index,
-                            consistency_graph);
-        }
+// Moves the scene centroids of the matches by random steps of up to max_step along every axis,
+// removes a few matches and adds num_matches_to_add new matches with IDs from first_new_id.
+PairwiseMatches makeNextFrame(const PairwiseMatches& matches, const float max_step,
+                              const size_t num_matches_to_add, const Id first_new_id,
+                              const unsigned int seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> step(-max_step, max_step);
+  std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+  PairwiseMatches next_matches;
+  for (const PairwiseMatch& match : matches) {
+    if (uniform(rng) < 0.03f) continue;
+    PointPair centroids = match.centroids_;
+    centroids.second.x += step(rng);
+    centroids.second.y += step(rng);
+    centroids.second.z += step(rng);
+    next_matches.emplace_back(match.ids_.first, match.ids_.second, centroids.first,
+                              centroids.second, match.confidence_);
+  }
+  for (const PairwiseMatch& match : makeDenseScene(num_matches_to_add, seed)) {
+    const Id id = first_new_id + match.ids_.first;
+    next_matches.emplace_back(id, id, match.centroids_.first, match.centroids_.second,
+                              match.confidence_);
+  }
+  std::shuffle(next_matches.begin(), next_matches.end(), rng);
+  return next_matches;
+}
+
+// Checks that two recognizers find the same clusters in the same frames, e.g. when the options
+// of the second one only speed up the search.
+void expectSameClusters(const GeometricConsistencyParams& expected_params,
+                        const GeometricConsistencyParams& params) {
+  IncrementalGeometricConsistencyRecognizer expected_recognizer(expected_params,
+                                                                test::kMaxModelRadius);
+  IncrementalGeometricConsistencyRecognizer recognizer(params, test::kMaxModelRadius);
+  for (unsigned int frame = 0u; frame < 4u; ++frame) {
+    SCOPED_TRACE(frame);
+    const PairwiseMatches matches = test::makeScene(20u - 2u * frame, 300u, frame, 0.05f);
+    expected_recognizer.recognize(matches);
+    recognizer.recognize(matches);
+    const std::vector<PairwiseMatches>& expected_clusters =
+        expected_recognizer.getCandidateClusters();
+    ASSERT_FALSE(expected_clusters.empty());
+    ASSERT_EQ(expected_clusters.size(), recognizer.getCandidateClusters().size());
+    for (size_t i = 0u; i < expected_clusters.size(); ++i) {
+      EXPECT_EQ(getSortedModelIds(expected_clusters[i]),
+                getSortedModelIds(recognizer.getCandidateClusters()[i]));
+    }
+  }
+}
+
+TEST(IncrementalGeometricConsistencyRecognizerTest, RecognizesTheTrueMatches) {
+  constexpr size_t kNumInliers = 20u;
+  for (const std::string strategy : { "Degeneracy", "Bitset", "Coloring", "MaximumWeight" }) {
+    SCOPED_TRACE(strategy);
+    GeometricConsistencyParams params = makeParams();
+    params.clique_search_strategy = strategy;
+    IncrementalGeometricConsistencyRecognizer recognizer(params, test::kMaxModelRadius);
+    recognizer.recognize(test::makeScene(kNumInliers, 300u, 1u, 0.05f));
+
+    ASSERT_EQ(1u, recognizer.getCandidateClusters().size());
+    ASSERT_EQ(1u, recognizer.getCandidateTransformations().size());
+    const std::vector<Id> ids = getSortedModelIds(recognizer.getCandidateClusters()[0]);
+    ASSERT_EQ(kNumInliers, ids.size());
+    for (size_t i = 0u; i < kNumInliers; ++i) EXPECT_EQ(static_cast<Id>(i), ids[i]);
+
+    const Eigen::Matrix4f expected = test::getSceneTransformation().matrix();
+    EXPECT_TRUE(recognizer.getCandidateTransformations()[0].isApprox(expected, 1e-2f));
+  }
+}
+
+TEST(IncrementalGeometricConsistencyRecognizerTest, DoesNotRecognizeSmallClusters) {
+  GeometricConsistencyParams params = makeParams();
+  params.min_cluster_size = 10;
+  IncrementalGeometricConsistencyRecognizer recognizer(params, test::kMaxModelRadius);
+  recognizer.recognize(test::makeScene(5u, 300u, 1u, 0.05f));
+  EXPECT_TRUE(recognizer.getCandidateClusters().empty());
+  EXPECT_TRUE(recognizer.getCandidateTransformations().empty());
+}
+
+// Checks that the matches of every candidate cluster are pairwise consistent.
+void expectConsistentClusters(const GeometricConsistencyParams& params,
+                              const std::vector<PairwiseMatches>& clusters) {
+  for (const PairwiseMatches& cluster : clusters) {
+    EXPECT_GE(cluster.size(), static_cast<size_t>(params.min_cluster_size));
+    for (size_t i = 0u; i < cluster.size(); ++i) {
+      for (size_t j = i + 1u; j < cluster.size(); ++j) {
+        const float model_distance = (cluster[i].centroids_.first.getVector3fMap() -
+                                      cluster[j].centroids_.first.getVector3fMap()).norm();
+        const float scene_distance = (cluster[i].centroids_.second.getVector3fMap() -
+                                      cluster[j].centroids_.second.getVector3fMap()).norm();
+        EXPECT_LE(std::fabs(scene_distance - model_distance), params.resolution + 1e-4f);
       }
     }
-    match_cache.candidate_consistent_matches = std::move(new_candidate_consistent_matches);
   }
-  BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.BuildConsistencyGraph.TestedCachedPairs",
-                         num_consistency_tests);
 }
 
-// 处理缓存中不存在的预测匹配，找到一致性并添加到一致性图
-// 参数：
-// predicted_matches  预测匹配
-// free_cache_slot_indices  被释放掉不再使用的缓存槽的索引
-// match_index_to_cache_slot_index  match索引到cache的映射
-// new_cache_slot_indices  新的缓存索引
-// consistency_graph  一致性图
-inline void IncrementalGeometricConsistencyRecognizer::processNewMatches(
-    const PairwiseMatches& predicted_matches,
-    const std::vector<size_t>& free_cache_slot_indices,
-    std::vector<size_t>& match_index_to_cache_slot_index,
-    std::unordered_map<IdPair, size_t, IdPairHash>& new_cache_slot_indices,
-    ConsistencyGraph& consistency_graph) {
-  BENCHMARK_BLOCK("SM.Worker.Recognition.BuildConsistencyGraph.NewMatches");
-
-  // Partition the matches in a grid by the position of the scene points. The size of the
-  // partitions is greater or equal the size of the model. This way we can safely assume that, if
-  // the model is actually present in the scene, all matches will be contained in a 2x2 group of
-  // adjacent partitions.
-  
-  // 根据场景点的位置在网格中划分匹配项，分区的尺寸大于等于模型
-  // 这样我们就可以放心地假设，如果这个模型实际上出现在场景中，所有匹配项将包含在一个2x2相邻的分区组中。
-  BENCHMARK_START("SM.Worker.Recognition.BuildConsistencyGraph.Partitioning");
-  MatchesGridPartitioning<PartitionData> partitioning =
-      MatchesPartitioner::computeGridPartitioning<PartitionData>(predicted_matches,
-                                                                 max_consistency_distance_);
-  BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.BuildConsistencyGraph.NumPartitions",
-                         partitioning.getHeight() * partitioning.getWidth());
-  BENCHMARK_STOP("SM.Worker.Recognition.BuildConsistencyGraph.Partitioning");
-
-  // Find all possible consistency within a partition and within neighbor partitions.
-  size_t num_consistency_tests = 0u;
-  size_t next_slot_index_position = 0u;
-  for (size_t i = 0; i < partitioning.getHeight(); ++i) {
-    for (size_t j = 0; j < partitioning.getWidth(); ++j) {
-      for (const auto match_index : partitioning(i, j).match_indices) {
-        // Only process new matches.
-        if (match_index_to_cache_slot_index[match_index] != kNoCacheSlotIndex_) continue;
-        const PairwiseMatch& match = predicted_matches[match_index];
-
-        // Get a free cache slot and insert the match.
-        const size_t cache_slot_index = free_cache_slot_indices[next_slot_index_position];
-        ++next_slot_index_position;
-        MatchCacheSlot& match_cache = matches_cache_[cache_slot_index];
-        match_cache.candidate_consistent_matches.clear();
-        match_cache.candidate_consistent_matches.reserve(matches_cache_.size() - 1u);
-        match_cache.centroids_at_caching = match.centroids_;
-        new_cache_slot_indices.emplace(match.ids_, cache_slot_index);
-
-        // Test consistencies between the current match and the cached matches in the neighbor
-        // partitions.
-        for (size_t k = static_cast<size_t>(std::max(0, static_cast<int>(i) - 1));
-             k <= std::min(partitioning.getHeight() - 1u, i + 1u); ++k) {
-          for (size_t l = static_cast<size_t>(std::max(0, static_cast<int>(j) - 1));
-               l <= std::min(partitioning.getWidth() - 1u, j + 1u); ++l) {
-            for (const auto match_2_index : partitioning(k, l).match_indices) {
-              // Only compare to matches already present in the cache
-              if (match_index_to_cache_slot_index[match_2_index] != kNoCacheSlotIndex_) {
-                const PairwiseMatch& match_2 = predicted_matches[match_2_index];
-                float consistency_distance = computeConsistencyDistance(match, match_2,
-                                                                        max_consistency_distance_);
-                ++num_consistency_tests;
-
-                // If the matches are close enough, cache them as candidate consistent matches.
-                if (consistency_distance <= max_consistency_distance_for_caching_) {
-                  match_cache.candidate_consistent_matches.emplace_back(
-                      match_index_to_cache_slot_index[match_2_index]);
-                  // If the matches are consistent, add an edge to the consistency graph.
-                  if (consistency_distance <= params_.resolution)
-                    boost::add_edge(match_index, match_2_index, consistency_graph);
-                }
-              }
-            }
-          }
-        }
-
-        match_index_to_cache_slot_index[match_index] = cache_slot_index;
+// A clique search stopped by its time budget, by its node budget or by a cancellation issued
+// while the graph is built still gives a consistent cluster, which is not proven to be optimal.
+// The heuristic strategy only proves the optimality of cliques reaching the degeneracy bound.
+TEST(IncrementalGeometricConsistencyRecognizerTest, ExhaustedBudgetsGiveConsistentClusters) {
+  const PairwiseMatches matches = makeDenseScene(40u, 0u);
+  for (const std::string strategy : { "Degeneracy", "Bitset", "Coloring", "Heuristic" }) {
+    for (const std::string budget : { "None", "Time", "Nodes", "Cancellation" }) {
+      SCOPED_TRACE(strategy + " " + budget);
+      GeometricConsistencyParams params = makeParams();
+      params.clique_search_strategy = strategy;
+      if (budget == "Time") params.clique_search_time_budget_ms = 1e-6;
+      if (budget == "Nodes") params.clique_search_max_expanded_nodes = 1;
+      IncrementalGeometricConsistencyRecognizer recognizer(params, test::kMaxModelRadius);
+      GraphBasedGeometricConsistencyRecognizer::PreparedRecognition prepared;
+      recognizer.prepareRecognition(matches, prepared);
+      if (budget == "Cancellation") recognizer.cancelCliqueSearch();
+      recognizer.completeRecognition(prepared);
+
+      if (budget != "None") {
+        EXPECT_FALSE(recognizer.isLastCliqueSearchOptimal());
+      } else if (strategy != "Heuristic") {
+        EXPECT_TRUE(recognizer.isLastCliqueSearchOptimal());
       }
+      ASSERT_EQ(1u, recognizer.getCandidateClusters().size());
+      expectConsistentClusters(params, recognizer.getCandidateClusters());
     }
   }
-  BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.BuildConsistencyGraph.TestedNewPairs",
-                           num_consistency_tests);
 }
 
-bool IncrementalGeometricConsistencyRecognizer::mustRemoveFromCache(
-    const PairwiseMatch& match, const size_t cache_slot_index) {
-  const MatchCacheSlot& match_cache = matches_cache_[cache_slot_index];
-  pcl::Vector3fMapConst model_centroid = match.centroids_.first.getVector3fMap();
-  pcl::Vector3fMapConst scene_centroid = match.centroids_.second.getVector3fMap();
-  pcl::Vector3fMapConst model_centroid_at_caching =
-      match_cache.centroids_at_caching.first.getVector3fMap();
-  pcl::Vector3fMapConst scene_centroid_at_caching =
-      match_cache.centroids_at_caching.second.getVector3fMap();
-
-  // Since checking the change in consistency distance for every match pair would be too expensive,
-  // we the responsibility of the check on both matches. If the centroids of a match move by half
-  // the maximum distance allowed, then the cached information are invalidated independently of the
-  // changes of the other matches.
-  // 由于检查每个匹配对的一致性距离的变化开销过大，我们只检查两个匹配。
-  // 如果匹配的质心移动了允许的最大距离的一半，则高速缓存的信息无效，而与其他匹配的变化无关。
-  const float model_displacement = (model_centroid - model_centroid_at_caching).norm();
-  const float scene_displacement = (scene_centroid - scene_centroid_at_caching).norm();
-  // 该参数大概为1.5
-  return model_displacement + scene_displacement >= half_max_consistency_distance_for_caching_;
+// A cancellation stops the recognitions prepared before it, even if their clique search has not
+// started yet, and not the recognitions prepared after it.
+TEST(IncrementalGeometricConsistencyRecognizerTest, CancellationStopsPreparedRecognitions) {
+  const PairwiseMatches matches = makeDenseScene(40u, 0u);
+  IncrementalGeometricConsistencyRecognizer recognizer(makeParams(), test::kMaxModelRadius);
+  recognizer.recognize(matches);
+  ASSERT_TRUE(recognizer.isLastCliqueSearchOptimal());
+  ASSERT_EQ(1u, recognizer.getCandidateClusters().size());
+  const std::vector<Id> ids = getSortedModelIds(recognizer.getCandidateClusters()[0]);
+
+  // The recognitions are pipelined as in the asynchronous recognizer.
+  GraphBasedGeometricConsistencyRecognizer::PreparedRecognition cancelled_recognition;
+  GraphBasedGeometricConsistencyRecognizer::PreparedRecognition next_recognition;
+  recognizer.prepareRecognition(matches, cancelled_recognition);
+  recognizer.cancelCliqueSearch();
+  recognizer.prepareRecognition(matches, next_recognition);
+  recognizer.completeRecognition(cancelled_recognition);
+  EXPECT_FALSE(recognizer.isLastCliqueSearchOptimal());
+  expectConsistentClusters(makeParams(), recognizer.getCandidateClusters());
+
+  recognizer.completeRecognition(next_recognition);
+  EXPECT_TRUE(recognizer.isLastCliqueSearchOptimal());
+  ASSERT_EQ(1u, recognizer.getCandidateClusters().size());
+  EXPECT_EQ(ids, getSortedModelIds(recognizer.getCandidateClusters()[0]));
 }
 
-inline IncrementalGeometricConsistencyRecognizer::ConsistencyGraph
-IncrementalGeometricConsistencyRecognizer::buildConsistencyGraph(
-    const PairwiseMatches& predicted_matches) {
-  BENCHMARK_BLOCK("SM.Worker.Recognition.BuildConsistencyGraph");
-
-  // Resize the cache to fit the new matches.
-  if (predicted_matches.size() > matches_cache_.size())
-    matches_cache_.resize(predicted_matches.size());
-  std::vector<size_t> cache_slot_index_to_match_index(matches_cache_.size(), kNoMatchIndex_);
-
-  // Identify which matches have cached information.
-  // 识别哪些匹配项已经缓存了信息
-  size_t invalidated_cached_matches = 0u;
-  std::vector<MatchLocations> cached_matches_locations;
-  cached_matches_locations.reserve(predicted_matches.size());
-  std::vector<size_t> match_index_to_cache_slot_index(predicted_matches.size(),
-                                                      kNoCacheSlotIndex_);
-  for (size_t i = 0u; i < predicted_matches.size(); ++i) {
-    const auto cached_info_it = cache_slot_indices_.find(predicted_matches[i].ids_);
-    if (cached_info_it != cache_slot_indices_.end()) {
-      // If a centroid moved by more than the allowed distance, we need to invalidate the cached
-      // information and threat the match as new.
-	  // 如果质心移动超过允许的距离，我们需要使缓存信息失效 和威胁比赛如新。
-      if (mustRemoveFromCache(predicted_matches[i], cached_info_it->second)) {
-        ++invalidated_cached_matches;
-      } else {
-        cached_matches_locations.emplace_back(i, cached_info_it->second);
-        cache_slot_index_to_match_index[cached_info_it->second] = i;
-        match_index_to_cache_slot_index[i] = cached_info_it->second;
-      }
+// Reducing the consistency graph to the k-core that can contain the clusters does not change the
+// clusters.
+TEST(IncrementalGeometricConsistencyRecognizerTest, KCoreReductionKeepsClusters) {
+  for (const std::string strategy :
+       { "Degeneracy", "Bitset", "Coloring", "MaximumWeight", "Heuristic" }) {
+    for (const bool persistent_graph : { false, true }) {
+      SCOPED_TRACE(strategy + (persistent_graph ? " persistent" : ""));
+      GeometricConsistencyParams params = makeParams();
+      params.clique_search_strategy = strategy;
+      params.enable_persistent_consistency_graph = persistent_graph;
+      GeometricConsistencyParams reduced_params = params;
+      reduced_params.enable_k_core_reduction = true;
+      expectSameClusters(params, reduced_params);
     }
   }
-  BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.BuildConsistencyGraph.InvalidatedMatches",
-                         invalidated_cached_matches);
-  BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.BuildConsistencyGraph.CachedMatches",
-                         cached_matches_locations.size());
-
-  // Collect indices of the cache slots that are not used anymore.
-  // 收集不再使用的缓存槽的索引
-  // cache_slot_index_to_match_index初始值为kNoMatchIndex_，判断缓存无效时不对其进行赋值操作
-  std::vector<size_t> free_cache_slot_indices;
-  free_cache_slot_indices.reserve(matches_cache_.size());
-  for (size_t i = 0u; i < matches_cache_.size(); ++i) {
-    if (cache_slot_index_to_match_index[i] == kNoMatchIndex_)
-      free_cache_slot_indices.push_back(i);
+}
+
+// Renumbering the vertices in degeneracy order does not change the clusters, alone or combined
+// with the other index maps between the searched graph and the matches: the k-core reduction,
+// the vertices of the persistent graph and the Morton order.
+TEST(IncrementalGeometricConsistencyRecognizerTest, DegeneracyRelabelingKeepsClusters) {
+  constexpr int kKCoreReduction = 1;
+  constexpr int kPersistentGraph = 2;
+  constexpr int kMortonOrdering = 4;
+  for (const std::string strategy :
+       { "Degeneracy", "Bitset", "Coloring", "MaximumWeight", "Heuristic" }) {
+    for (const int options : { 0, kKCoreReduction, kPersistentGraph,
+                               kKCoreReduction | kPersistentGraph | kMortonOrdering }) {
+      SCOPED_TRACE(strategy + " options " + std::to_string(options));
+      GeometricConsistencyParams params = makeParams();
+      params.clique_search_strategy = strategy;
+      params.enable_k_core_reduction = (options & kKCoreReduction) != 0;
+      params.enable_persistent_consistency_graph = (options & kPersistentGraph) != 0;
+      params.enable_morton_ordering = (options & kMortonOrdering) != 0;
+      GeometricConsistencyParams relabeled_params = params;
+      relabeled_params.enable_degeneracy_relabeling = true;
+      expectSameClusters(params, relabeled_params);
+    }
+  }
+}
+
+// The cache of the incremental recognizer must not change the result: recognizing a sequence of
+// frames with one recognizer gives the clusters of a new recognizer for every frame.
+TEST(IncrementalGeometricConsistencyRecognizerTest, CachedFramesMatchNewRecognizer) {
+  const GeometricConsistencyParams params = makeParams();
+  IncrementalGeometricConsistencyRecognizer recognizer(params, test::kMaxModelRadius);
+  for (unsigned int frame = 0u; frame < 8u; ++frame) {
+    SCOPED_TRACE(frame);
+    const PairwiseMatches matches = test::makeScene(20u + frame % 3u, 200u + 20u * (frame % 4u),
+                                                    frame, 0.05f);
+    recognizer.recognize(matches);
+    IncrementalGeometricConsistencyRecognizer new_recognizer(params, test::kMaxModelRadius);
+    new_recognizer.recognize(matches);
+
+    ASSERT_EQ(new_recognizer.getCandidateClusters().size(),
+              recognizer.getCandidateClusters().size());
+    for (size_t i = 0u; i < recognizer.getCandidateClusters().size(); ++i) {
+      EXPECT_EQ(getSortedModelIds(new_recognizer.getCandidateClusters()[i]),
+                getSortedModelIds(recognizer.getCandidateClusters()[i]));
+    }
+  }
+}
+
+// Evicting cached candidates for limiting the memory only causes the evicted matches to be tested
+// again: the clusters do not change.
+TEST(IncrementalGeometricConsistencyRecognizerTest, CacheMemoryLimitEvictsCandidates) {
+  GeometricConsistencyParams params = makeParams();
+  params.max_num_candidate_clusters = 0;
+  IncrementalGeometricConsistencyRecognizer recognizer(params, test::kMaxModelRadius);
+  params.max_match_cache_memory_mb = 1e-4;
+  IncrementalGeometricConsistencyRecognizer limited_recognizer(params, test::kMaxModelRadius);
+
+  size_t num_evicted_matches = 0u;
+  for (unsigned int frame = 0u; frame < 6u; ++frame) {
+    SCOPED_TRACE(frame);
+    const PairwiseMatches matches = test::makeScene(30u, 200u, frame, 0.01f);
+    recognizer.recognize(matches);
+    limited_recognizer.recognize(matches);
+    num_evicted_matches += limited_recognizer.getCacheStatistics().num_evicted_matches;
+
+    ASSERT_EQ(recognizer.getCandidateClusters().size(),
+              limited_recognizer.getCandidateClusters().size());
+    for (size_t i = 0u; i < recognizer.getCandidateClusters().size(); ++i) {
+      EXPECT_EQ(getSortedModelIds(recognizer.getCandidateClusters()[i]),
+                getSortedModelIds(limited_recognizer.getCandidateClusters()[i]));
+    }
+  }
+  EXPECT_GT(num_evicted_matches, 0u);
+}
+
+// The eviction budget accounts for the positions of the lists: once the candidates of the previous
+// frame can be evicted, the compacted pool fits in the memory limit.
+TEST(IncrementalGeometricConsistencyRecognizerTest, CacheMemoryLimitBoundsCompactedPool) {
+  constexpr double kMaxMemoryMb = 0.01;
+  constexpr size_t kMaxMemoryBytes = static_cast<size_t>(kMaxMemoryMb * 1024.0 * 1024.0);
+  GeometricConsistencyParams params = makeParams();
+  params.max_match_cache_memory_mb = kMaxMemoryMb;
+  IncrementalGeometricConsistencyRecognizer recognizer(params, test::kMaxModelRadius);
+  const PairwiseMatches matches = test::makeScene(30u, 400u, 0u, 0.01f);
+
+  // The candidates cached in the first frame cannot be evicted yet.
+  recognizer.recognize(matches);
+  ASSERT_GT(recognizer.getCacheStatistics().candidates_memory_bytes, kMaxMemoryBytes);
+  recognizer.recognize(matches);
+  EXPECT_LE(recognizer.getCacheStatistics().candidates_memory_bytes, kMaxMemoryBytes);
+  recognizer.recognize(matches);
+  EXPECT_GT(recognizer.getCacheStatistics().num_evicted_matches, 0u);
+}
+
+// Starting the search from the clique of the previous frame only prunes the search: the clusters
+// have the sizes found without warm start.
+TEST(IncrementalGeometricConsistencyRecognizerTest, WarmStartKeepsMaximumCliqueSize) {
+  GeometricConsistencyParams params = makeParams();
+  IncrementalGeometricConsistencyRecognizer recognizer(params, test::kMaxModelRadius);
+  params.enable_warm_start = true;
+  IncrementalGeometricConsistencyRecognizer warm_recognizer(params, test::kMaxModelRadius);
+  for (unsigned int frame = 0u; frame < 8u; ++frame) {
+    SCOPED_TRACE(frame);
+    // Some true matches vanish and come back across the frames.
+    const PairwiseMatches matches = test::makeScene(25u - 3u * (frame % 3u), 250u, frame, 0.05f);
+    recognizer.recognize(matches);
+    warm_recognizer.recognize(matches);
+
+    ASSERT_EQ(1u, recognizer.getCandidateClusters().size());
+    ASSERT_EQ(1u, warm_recognizer.getCandidateClusters().size());
+    EXPECT_EQ(recognizer.getCandidateClusters()[0].size(),
+              warm_recognizer.getCandidateClusters()[0].size());
+  }
+}
+
+// Checks that two recognizers reused and tested the same cached candidates.
+void expectSameCacheStatistics(
+    const IncrementalGeometricConsistencyRecognizer::CacheStatistics& expected,
+    const IncrementalGeometricConsistencyRecognizer::CacheStatistics& statistics) {
+  EXPECT_EQ(expected.num_matches, statistics.num_matches);
+  EXPECT_EQ(expected.num_cached_matches, statistics.num_cached_matches);
+  EXPECT_EQ(expected.num_invalidated_matches, statistics.num_invalidated_matches);
+  EXPECT_EQ(expected.num_evicted_matches, statistics.num_evicted_matches);
+  EXPECT_EQ(expected.num_unchanged_matches, statistics.num_unchanged_matches);
+  EXPECT_EQ(expected.num_cached_pair_tests, statistics.num_cached_pair_tests);
+  EXPECT_EQ(expected.num_new_pair_tests, statistics.num_new_pair_tests);
+  EXPECT_EQ(expected.candidates_memory_bytes, statistics.candidates_memory_bytes);
+}
+
+// The graph kept across frames by the persistent recognizer and the graph built by a recognizer
+// reusing its cache equal the graph rebuilt from scratch, while matches drift, vanish and appear.
+// Static frames, drifts small enough for the cached candidates not to be tested again and big
+// drifts alternate. Building the graphs with several threads changes neither the graphs nor the
+// cache statistics, and partitioning the matches in voxels instead of a grid does not change the
+// graphs. The graphs are also compared with a model small enough for the scene to span several
+// partitions, and for pairs of matches to move beyond the maximum scene distance and back.
+TEST(IncrementalGeometricConsistencyRecognizerTest, CachedGraphsMatchRebuiltGraph) {
+  constexpr float kMaxSteps[] = { 0.0f, 0.001f, 0.05f, 0.5f };
+  constexpr int kNumThreads[] = { 1, 2, 4 };
+  std::vector<std::unique_ptr<ConsistencyGraphProbe>> cached_recognizers;
+  std::vector<std::unique_ptr<ConsistencyGraphProbe>> persistent_recognizers;
+  for (const int num_threads : kNumThreads) {
+    GeometricConsistencyParams params = makeParams();
+    params.num_consistency_graph_threads = num_threads;
+    cached_recognizers.emplace_back(new ConsistencyGraphProbe(params, test::kMaxModelRadius));
+    params.enable_persistent_consistency_graph = true;
+    persistent_recognizers.emplace_back(new ConsistencyGraphProbe(params,
+                                                                  test::kMaxModelRadius));
   }
+  GeometricConsistencyParams voxel_params = makeParams();
+  voxel_params.matches_partitioner = "Voxel";
+  ConsistencyGraphProbe voxel_cached_recognizer(voxel_params, test::kMaxModelRadius);
+  GeometricConsistencyParams persistent_voxel_params = voxel_params;
+  persistent_voxel_params.enable_persistent_consistency_graph = true;
+  ConsistencyGraphProbe voxel_persistent_recognizer(persistent_voxel_params,
+                                                    test::kMaxModelRadius);
+  constexpr float kSmallModelRadius = 4.0f;
+  ConsistencyGraphProbe small_model_cached_recognizer(makeParams(), kSmallModelRadius);
+  ConsistencyGraphProbe small_model_voxel_cached_recognizer(voxel_params, kSmallModelRadius);
+  ConsistencyGraphProbe small_model_voxel_persistent_recognizer(persistent_voxel_params,
+                                                                kSmallModelRadius);
+
+  PairwiseMatches matches = makeDenseScene(300u, 0u);
+  size_t num_edges = 0u;
+  size_t num_partitioned_edges = 0u;
+  size_t num_unchanged_matches = 0u;
+  for (unsigned int frame = 0u; frame < 16u; ++frame) {
+    SCOPED_TRACE(frame);
+    ConsistencyGraphProbe new_recognizer(makeParams(), test::kMaxModelRadius);
+    const EdgeSet expected_edges = new_recognizer.getRebuiltEdges(matches);
+    for (size_t i = 0u; i < cached_recognizers.size(); ++i) {
+      SCOPED_TRACE(::testing::Message() << kNumThreads[i] << " threads");
+      EXPECT_EQ(expected_edges, cached_recognizers[i]->getRebuiltEdges(matches));
+      EXPECT_EQ(expected_edges, persistent_recognizers[i]->getPersistentEdges(matches));
+      expectSameCacheStatistics(cached_recognizers[0]->getCacheStatistics(),
+                                cached_recognizers[i]->getCacheStatistics());
+      expectSameCacheStatistics(persistent_recognizers[0]->getCacheStatistics(),
+                                persistent_recognizers[i]->getCacheStatistics());
+    }
+    EXPECT_EQ(expected_edges, voxel_cached_recognizer.getRebuiltEdges(matches));
+    EXPECT_EQ(expected_edges, voxel_persistent_recognizer.getPersistentEdges(matches));
+    num_edges += expected_edges.size();
 
-  BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.TotalMatches", predicted_matches.size());
-  BENCHMARK_RECORD_VALUE("SM.Worker.Recognition.CachedMatches", cached_matches_locations.size());
-
-  // Build the consistency graph.
-  // 构建一致性图
-  // ConsistencyGraph -> boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS>
-  ConsistencyGraph consistency_graph(predicted_matches.size());
-  std::unordered_map<IdPair, size_t, IdPairHash> new_cache_slot_indices;
-  new_cache_slot_indices.reserve(predicted_matches.size());
-  // cached_matches_locations  一是candidate_consistent_matches，二是centroids_at_caching
-  // cache_slot_index_to_match_index  用kNoMatchIndex_初始化，cache到match的索引映射
-  // match_index_to_cache_slot_index  用kNoMatchIndex_初始化，match的索引到cache的映射
-  // cache_slot_indices_  一IdPair，二size_t
-  processCachedMatches(predicted_matches, cached_matches_locations,
-                       cache_slot_index_to_match_index, new_cache_slot_indices, consistency_graph);
-  processNewMatches(predicted_matches, free_cache_slot_indices, match_index_to_cache_slot_index,
-                    new_cache_slot_indices, consistency_graph);
-
-  // Use the new mapping between match IDs and cache slots.
-  cache_slot_indices_ = std::move(new_cache_slot_indices);
-  return consistency_graph;
+    ConsistencyGraphProbe new_small_model_recognizer(makeParams(), kSmallModelRadius);
+    ConsistencyGraphProbe new_small_model_voxel_recognizer(voxel_params, kSmallModelRadius);
+    const EdgeSet expected_partitioned_edges =
+        new_small_model_recognizer.getRebuiltEdges(matches);
+    EXPECT_EQ(expected_partitioned_edges,
+              new_small_model_voxel_recognizer.getRebuiltEdges(matches));
+    EXPECT_EQ(expected_partitioned_edges, small_model_cached_recognizer.getRebuiltEdges(matches));
+    EXPECT_EQ(expected_partitioned_edges,
+              small_model_voxel_cached_recognizer.getRebuiltEdges(matches));
+    EXPECT_EQ(expected_partitioned_edges,
+              small_model_voxel_persistent_recognizer.getPersistentEdges(matches));
+    num_partitioned_edges += expected_partitioned_edges.size();
+    num_unchanged_matches += persistent_recognizers[0]->getCacheStatistics().num_unchanged_matches;
+
+    matches = makeNextFrame(matches, kMaxSteps[frame % 4u], frame % 2u == 0u ? 0u : 10u,
+                            1000u * (frame + 1u), frame);
+  }
+  EXPECT_GT(num_edges, 0u);
+  EXPECT_GT(num_partitioned_edges, 0u);
+  EXPECT_GT(num_unchanged_matches, 0u);
 }
 
-// 计算一致性距离（scene_dis与model_dis差值）
-// 参数： max_target_distance=50*2
-// 这样是否就没考虑旋转的问题？？？？？？？？？
-inline float IncrementalGeometricConsistencyRecognizer::computeConsistencyDistance(
-    const PairwiseMatch& first_match, const PairwiseMatch& second_match,
-    const float max_target_distance) const {
-  // Get the centroids of the matched segments.
-  // 获取匹配分割的质心
-  pcl::Vector3fMapConst model_point_1 = first_match.centroids_.first.getVector3fMap();
-  pcl::Vector3fMapConst scene_point_1 = first_match.centroids_.second.getVector3fMap();
-  pcl::Vector3fMapConst model_point_2 = second_match.centroids_.first.getVector3fMap();
-  pcl::Vector3fMapConst scene_point_2 = second_match.centroids_.second.getVector3fMap();
-
-  // If the keypoints are so far away in the scene so that they can not fit in the model together,
-  // the matches will not be consistent even if the centroids in the model move.
-  // 如果场景（target）中的关键点离得太远，以至于它们不能一起放入模型中，
-  // 即使模型（source）中的质心移动，匹配也不会是一致的
-  const float scene_distance = (scene_point_1 - scene_point_2).norm();
-  if (scene_distance > max_target_distance)
-    return std::numeric_limits<float>::max();
-
-  // Return the difference between the distances.
-  // 返回距离间的差值
-  const float model_distance = (model_point_1 - model_point_2).norm();
-  return fabs(scene_distance - model_distance);
+// Recognizing the same matches again does not test any pair. The scene has no outliers, whose
+// consistency distances could be within the rounding margin of the resolution.
+TEST(IncrementalGeometricConsistencyRecognizerTest, StaticSceneTestsNoPair) {
+  const PairwiseMatches matches = test::makeScene(25u, 0u, 1u, 0.05f);
+  for (const bool persistent_graph : { false, true }) {
+    SCOPED_TRACE(persistent_graph);
+    GeometricConsistencyParams params = makeParams();
+    params.enable_persistent_consistency_graph = persistent_graph;
+    IncrementalGeometricConsistencyRecognizer recognizer(params, test::kMaxModelRadius);
+    recognizer.recognize(matches);
+    EXPECT_GT(recognizer.getCacheStatistics().num_new_pair_tests, 0u);
+    const std::vector<Id> ids = getSortedModelIds(recognizer.getCandidateClusters().at(0));
+
+    recognizer.recognize(matches);
+    const IncrementalGeometricConsistencyRecognizer::CacheStatistics& statistics =
+        recognizer.getCacheStatistics();
+    EXPECT_EQ(matches.size(), statistics.num_cached_matches);
+    EXPECT_EQ(matches.size(), statistics.num_unchanged_matches);
+    EXPECT_EQ(0u, statistics.num_cached_pair_tests);
+    EXPECT_EQ(0u, statistics.num_new_pair_tests);
+    EXPECT_EQ(ids, getSortedModelIds(recognizer.getCandidateClusters().at(0)));
+  }
 }
 
+} // namespace
 } // namespace bron_kerbosch
@@ -0,0 +1,104 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "recognizers/CandidateListPool.hpp"
+
+namespace bron_kerbosch {
+namespace {
+
+typedef CandidateListPool::Candidate Candidate;
+
+std::vector<Candidate> getList(const CandidateListPool& pool, const size_t list) {
+  const Candidate* first = pool.getList(list);
+  return std::vector<Candidate>(first, first + pool.getListSize(list));
+}
+
+TEST(CandidateListPoolTest, CandidateStoresSlotAndConsistency) {
+  const Candidate consistent = CandidateListPool::makeCandidate(12345u, true);
+  const Candidate inconsistent =
+      CandidateListPool::makeCandidate(CandidateListPool::kMaxCacheSlot, false);
+  EXPECT_EQ(12345u, CandidateListPool::getCacheSlot(consistent));
+  EXPECT_TRUE(CandidateListPool::isConsistent(consistent));
+  EXPECT_EQ(CandidateListPool::kMaxCacheSlot, CandidateListPool::getCacheSlot(inconsistent));
+  EXPECT_FALSE(CandidateListPool::isConsistent(inconsistent));
+}
+
+TEST(CandidateListPoolTest, AssignListInPlaceOrAppended) {
+  CandidateListPool pool;
+  pool.resize(2u);
+  EXPECT_EQ(0u, pool.getListSize(0u));
+
+  const std::vector<Candidate> list_0 = { 1u, 2u, 3u };
+  const std::vector<Candidate> list_1 = { 4u, 5u };
+  pool.assignList(0u, list_0.data(), list_0.data() + list_0.size());
+  pool.assignList(1u, list_1.data(), list_1.data() + list_1.size());
+  EXPECT_EQ(5u, pool.getNumStoredCandidates());
+
+  // A list that is not bigger is written in place.
+  const std::vector<Candidate> smaller = { 6u, 7u };
+  const Candidate* storage_0 = pool.getList(0u);
+  pool.assignList(0u, smaller.data(), smaller.data() + smaller.size());
+  EXPECT_EQ(storage_0, pool.getList(0u));
+  EXPECT_EQ(smaller, getList(pool, 0u));
+  EXPECT_EQ(5u, pool.getNumStoredCandidates());
+  EXPECT_EQ(4u, pool.getNumLiveCandidates());
+
+  // A bigger list is appended, leaving its previous storage unused.
+  const std::vector<Candidate> bigger = { 8u, 9u, 10u, 11u };
+  pool.assignList(1u, bigger.data(), bigger.data() + bigger.size());
+  EXPECT_EQ(bigger, getList(pool, 1u));
+  EXPECT_EQ(smaller, getList(pool, 0u));
+  EXPECT_EQ(9u, pool.getNumStoredCandidates());
+  EXPECT_EQ(6u, pool.getNumLiveCandidates());
+
+  pool.truncateList(1u, 1u);
+  EXPECT_EQ(std::vector<Candidate>({ 8u }), getList(pool, 1u));
+  EXPECT_EQ(3u, pool.getNumLiveCandidates());
+}
+
+TEST(CandidateListPoolTest, CompactKeepsListsAndFiltersSlots) {
+  CandidateListPool pool;
+  pool.resize(3u);
+  const std::vector<Candidate> list_0 = {
+    CandidateListPool::makeCandidate(1u, true), CandidateListPool::makeCandidate(5u, false),
+    CandidateListPool::makeCandidate(2u, false) };
+  const std::vector<Candidate> list_2 = {
+    CandidateListPool::makeCandidate(7u, true), CandidateListPool::makeCandidate(0u, true) };
+  pool.assignList(0u, list_0.data(), list_0.data() + 1u);
+  pool.assignList(2u, list_2.data(), list_2.data() + list_2.size());
+  pool.assignList(0u, list_0.data(), list_0.data() + list_0.size());
+  EXPECT_EQ(6u, pool.getNumStoredCandidates());
+
+  pool.compact();
+  EXPECT_EQ(5u, pool.getNumStoredCandidates());
+  EXPECT_EQ(list_0, getList(pool, 0u));
+  EXPECT_EQ(0u, pool.getListSize(1u));
+  EXPECT_EQ(list_2, getList(pool, 2u));
+
+  // Candidates of the removed cache slots are dropped, keeping the order of the others.
+  pool.compact(5u);
+  EXPECT_EQ(3u, pool.getNumStoredCandidates());
+  EXPECT_EQ(std::vector<Candidate>({ list_0[0], list_0[2] }), getList(pool, 0u));
+  EXPECT_EQ(std::vector<Candidate>({ list_2[1] }), getList(pool, 2u));
+}
+
+TEST(CandidateListPoolTest, FragmentedWhenMostStorageIsUnused) {
+  CandidateListPool pool;
+  pool.resize(2u);
+  const std::vector<Candidate> candidates(5000u, CandidateListPool::makeCandidate(1u, true));
+  pool.assignList(0u, candidates.data(), candidates.data() + candidates.size());
+  EXPECT_FALSE(pool.isFragmented());
+  pool.truncateList(0u, 1000u);
+  EXPECT_TRUE(pool.isFragmented());
+  pool.compact();
+  EXPECT_FALSE(pool.isFragmented());
+  EXPECT_EQ(1000u, pool.getNumStoredCandidates());
+
+  // Small pools are never fragmented.
+  pool.truncateList(0u, 10u);
+  EXPECT_FALSE(pool.isFragmented());
+}
+
+} // namespace
+} // namespace bron_kerbosch
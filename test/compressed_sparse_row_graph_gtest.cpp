@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "recognizers/CompressedSparseRowGraph.hpp"
+#include "test_helpers.hpp"
+
+namespace bron_kerbosch {
+namespace {
+
+using test::TestGraph;
+
+typedef std::vector<std::pair<size_t, size_t>> EdgeList;
+
+// Random edges without self loops, in random order and orientation, some of them duplicated.
+EdgeList makeRandomEdges(const size_t num_vertices, const size_t num_edges,
+                         const unsigned int seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<size_t> vertex(0u, num_vertices - 1u);
+  EdgeList edges;
+  while (edges.size() < num_edges) {
+    const size_t u = vertex(rng);
+    const size_t v = vertex(rng);
+    if (u == v) continue;
+    edges.emplace_back(u, v);
+    if (edges.size() % 7u == 0u) edges.emplace_back(v, u);
+  }
+  std::shuffle(edges.begin(), edges.end(), rng);
+  return edges;
+}
+
+// Gets the targets of the out-edges of a vertex, sorted.
+template <typename Graph>
+std::vector<size_t> getSortedNeighbors(const Graph& graph, const size_t vertex) {
+  std::vector<size_t> neighbors;
+  typename boost::graph_traits<Graph>::out_edge_iterator e_it, e_end;
+  for (boost::tie(e_it, e_end) = boost::out_edges(vertex, graph); e_it != e_end; ++e_it) {
+    EXPECT_EQ(vertex, boost::source(*e_it, graph));
+    neighbors.push_back(boost::target(*e_it, graph));
+  }
+  std::sort(neighbors.begin(), neighbors.end());
+  return neighbors;
+}
+
+// Gets the edges of a graph as pairs with the smaller vertex first, sorted.
+template <typename Graph>
+EdgeList getSortedEdges(const Graph& graph) {
+  EdgeList edges;
+  typename boost::graph_traits<Graph>::edge_iterator e_it, e_end;
+  for (boost::tie(e_it, e_end) = boost::edges(graph); e_it != e_end; ++e_it) {
+    const size_t u = boost::source(*e_it, graph);
+    const size_t v = boost::target(*e_it, graph);
+    edges.emplace_back(std::min(u, v), std::max(u, v));
+  }
+  std::sort(edges.begin(), edges.end());
+  return edges;
+}
+
+// Checks that the graph has the vertices, edges and adjacencies of the reference graph.
+void expectSameGraph(const TestGraph& expected, const CompressedSparseRowGraph& graph) {
+  const size_t num_vertices = boost::num_vertices(expected);
+  ASSERT_EQ(num_vertices, boost::num_vertices(graph));
+  EXPECT_EQ(boost::num_edges(expected), boost::num_edges(graph));
+  EXPECT_EQ(getSortedEdges(expected), getSortedEdges(graph));
+  for (size_t u = 0u; u < num_vertices; ++u) {
+    SCOPED_TRACE(u);
+    EXPECT_EQ(boost::out_degree(u, expected), boost::out_degree(u, graph));
+    EXPECT_EQ(boost::degree(u, expected), boost::degree(u, graph));
+    EXPECT_EQ(getSortedNeighbors(expected, u), getSortedNeighbors(graph, u));
+    for (size_t v = 0u; v < num_vertices; ++v) {
+      EXPECT_EQ(boost::edge(u, v, expected).second, boost::edge(u, v, graph).second);
+    }
+  }
+}
+
+TEST(CompressedSparseRowGraphTest, MatchesAdjacencyList) {
+  for (unsigned int seed = 0u; seed < 4u; ++seed) {
+    SCOPED_TRACE(seed);
+    const size_t num_vertices = 10u + 25u * seed;
+    const EdgeList edges = makeRandomEdges(num_vertices, 3u * num_vertices, seed);
+    TestGraph expected(num_vertices);
+    for (const auto& edge : edges) boost::add_edge(edge.first, edge.second, expected);
+
+    expectSameGraph(expected, CompressedSparseRowGraph(edges.begin(), edges.end(),
+                                                       num_vertices));
+
+    // Sorted edges give the same graph.
+    EdgeList sorted_edges = edges;
+    std::sort(sorted_edges.begin(), sorted_edges.end());
+    expectSameGraph(expected, CompressedSparseRowGraph(sorted_edges.begin(), sorted_edges.end(),
+                                                       num_vertices));
+  }
+}
+
+TEST(CompressedSparseRowGraphTest, AssignReplacesGraph) {
+  CompressedSparseRowGraph graph;
+  for (unsigned int seed = 0u; seed < 4u; ++seed) {
+    SCOPED_TRACE(seed);
+    // The graphs alternately grow and shrink.
+    const size_t num_vertices = seed % 2u == 0u ? 60u : 15u;
+    const EdgeList edges = makeRandomEdges(num_vertices, 2u * num_vertices, seed);
+    TestGraph expected(num_vertices);
+    for (const auto& edge : edges) boost::add_edge(edge.first, edge.second, expected);
+    graph.assign(edges.begin(), edges.end(), num_vertices);
+    expectSameGraph(expected, graph);
+  }
+}
+
+TEST(CompressedSparseRowGraphTest, EmptyGraphs) {
+  const CompressedSparseRowGraph empty_graph;
+  EXPECT_EQ(0u, boost::num_vertices(empty_graph));
+  EXPECT_EQ(0u, boost::num_edges(empty_graph));
+  EXPECT_TRUE(getSortedEdges(empty_graph).empty());
+
+  // Vertices without edges.
+  const EdgeList no_edges;
+  expectSameGraph(TestGraph(5u), CompressedSparseRowGraph(5u));
+  expectSameGraph(TestGraph(5u), CompressedSparseRowGraph(no_edges.begin(), no_edges.end(), 5u));
+}
+
+} // namespace
+} // namespace bron_kerbosch
@@ -0,0 +1,289 @@
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "recognizers/GraphUtilities.hpp"
+#include "WorkStealingThreadPool.h"
+#include "test_helpers.hpp"
+
+namespace bron_kerbosch {
+namespace {
+
+using test::TestGraph;
+using test::isClique;
+using test::makeRandomGraph;
+
+typedef std::vector<size_t> Clique;
+
+constexpr size_t kMinCliqueSize = 3u;
+
+// Seeded random graphs of various densities, each with a planted clique.
+std::vector<TestGraph> makeTestGraphs(const size_t num_vertices,
+                                      const double max_edge_probability = 0.7) {
+  std::vector<TestGraph> graphs;
+  unsigned int seed = 0u;
+  for (const double edge_probability : { 0.1, 0.3, 0.5, 0.7 }) {
+    if (edge_probability > max_edge_probability) break;
+    for (size_t i = 0u; i < 4u; ++i) {
+      graphs.push_back(makeRandomGraph(num_vertices, edge_probability, seed++, 4u + 3u * i));
+    }
+  }
+  return graphs;
+}
+
+// Checks that no vertex of the graph can be added to the clique.
+bool isMaximalClique(const TestGraph& graph, const Clique& clique) {
+  for (size_t v = 0u; v < boost::num_vertices(graph); ++v) {
+    if (std::find(clique.begin(), clique.end(), v) != clique.end()) continue;
+    bool connected_to_all = true;
+    for (const size_t u : clique) {
+      if (!boost::edge(u, v, graph).second) {
+        connected_to_all = false;
+        break;
+      }
+    }
+    if (connected_to_all) return false;
+  }
+  return true;
+}
+
+// Computes the core numbers by peeling the k-core for every k independently: the vertices with
+// less than k neighbors in the remaining graph are removed until none is left.
+std::vector<size_t> computeCoreNumbersByPeeling(const TestGraph& graph) {
+  const size_t num_vertices = boost::num_vertices(graph);
+  std::vector<size_t> core_numbers(num_vertices, 0u);
+  for (size_t k = 1u; ; ++k) {
+    std::vector<bool> in_core(num_vertices, true);
+    for (bool removed = true; removed;) {
+      removed = false;
+      for (size_t v = 0u; v < num_vertices; ++v) {
+        if (!in_core[v]) continue;
+        size_t degree = 0u;
+        TestGraph::adjacency_iterator a_it, a_end;
+        for (boost::tie(a_it, a_end) = boost::adjacent_vertices(v, graph); a_it != a_end; ++a_it) {
+          if (in_core[*a_it]) ++degree;
+        }
+        if (degree < k) {
+          in_core[v] = false;
+          removed = true;
+        }
+      }
+    }
+    bool core_is_empty = true;
+    for (size_t v = 0u; v < num_vertices; ++v) {
+      if (!in_core[v]) continue;
+      core_numbers[v] = k;
+      core_is_empty = false;
+    }
+    if (core_is_empty) return core_numbers;
+  }
+}
+
+double getWeight(const Clique& clique, const std::vector<double>& vertex_weights) {
+  double weight = 0.0;
+  for (const size_t v : clique) weight += vertex_weights[v];
+  return weight;
+}
+
+TEST(GraphUtilitiesTest, ExactStrategiesFindMaximumCliqueSize) {
+  CliqueSearchWorkspace workspace;
+  for (const TestGraph& graph : makeTestGraphs(60u)) {
+    const Clique expected = GraphUtilities::findMaximumClique(graph, kMinCliqueSize);
+    ASSERT_TRUE(isClique(graph, expected));
+
+    const Clique bitset = GraphUtilities::findMaximumCliqueBitset(graph, kMinCliqueSize);
+    EXPECT_TRUE(isClique(graph, bitset));
+    EXPECT_EQ(expected.size(), bitset.size());
+
+    const Clique coloring = GraphUtilities::findMaximumCliqueColoring(graph, kMinCliqueSize);
+    EXPECT_TRUE(isClique(graph, coloring));
+    EXPECT_EQ(expected.size(), coloring.size());
+
+    // The searches reusing a workspace find cliques of the same size.
+    const Clique reused = GraphUtilities::findMaximumCliqueColoring(graph, kMinCliqueSize, nullptr,
+                                                                    nullptr, &workspace);
+    EXPECT_TRUE(isClique(graph, reused));
+    EXPECT_EQ(expected.size(), reused.size());
+  }
+}
+
+TEST(GraphUtilitiesTest, ParallelSearchFindsMaximumCliqueSize) {
+  for (const size_t num_threads : { 1u, 2u, 4u }) {
+    SCOPED_TRACE(num_threads);
+    WorkStealingThreadPool thread_pool(num_threads);
+    CliqueSearchWorkspace workspace;
+    for (const TestGraph& graph : makeTestGraphs(60u)) {
+      const Clique expected = GraphUtilities::findMaximumClique(graph, kMinCliqueSize);
+      const Clique clique = GraphUtilities::findMaximumCliqueParallel(
+          graph, kMinCliqueSize, thread_pool, nullptr, nullptr, &workspace);
+      EXPECT_TRUE(isClique(graph, clique));
+      EXPECT_EQ(expected.size(), clique.size());
+    }
+  }
+}
+
+TEST(GraphUtilitiesTest, FixedWidthKernelsFindMaximumCliqueSize) {
+  CliqueSearchWorkspace workspace;
+  for (const size_t num_vertices : { 50u, 64u, 100u, 200u, 256u }) {
+    SCOPED_TRACE(num_vertices);
+    // Dense graphs of more than 128 vertices take too long for a unit test.
+    for (const TestGraph& graph : makeTestGraphs(num_vertices, num_vertices <= 128u ? 0.7 : 0.3)) {
+      const Clique expected = GraphUtilities::findMaximumCliqueColoring(graph, kMinCliqueSize);
+      Clique clique;
+      if (num_vertices <= 64u) {
+        clique = GraphUtilities::findMaximumCliqueFixedWidth<64u>(graph, kMinCliqueSize, nullptr,
+                                                                  nullptr, &workspace);
+      } else if (num_vertices <= 128u) {
+        clique = GraphUtilities::findMaximumCliqueFixedWidth<128u>(graph, kMinCliqueSize, nullptr,
+                                                                   nullptr, &workspace);
+      } else {
+        clique = GraphUtilities::findMaximumCliqueFixedWidth<256u>(graph, kMinCliqueSize, nullptr,
+                                                                   nullptr, &workspace);
+      }
+      EXPECT_TRUE(isClique(graph, clique));
+      EXPECT_EQ(expected.size(), clique.size());
+    }
+  }
+}
+
+TEST(GraphUtilitiesTest, MaximumWeightCliqueWithUnitWeightsIsMaximumClique) {
+  for (const TestGraph& graph : makeTestGraphs(60u)) {
+    const Clique expected = GraphUtilities::findMaximumClique(graph, kMinCliqueSize);
+    const std::vector<double> unit_weights(boost::num_vertices(graph), 1.0);
+    const Clique clique = GraphUtilities::findMaximumWeightClique(graph, unit_weights,
+                                                                  kMinCliqueSize);
+    EXPECT_TRUE(isClique(graph, clique));
+    EXPECT_EQ(expected.size(), clique.size());
+  }
+}
+
+// With non-negative weights a maximum weight clique is maximal, so its weight is the maximum
+// weight of the maximal cliques.
+TEST(GraphUtilitiesTest, MaximumWeightCliqueIsHeaviestMaximalClique) {
+  std::mt19937 rng(42u);
+  std::uniform_real_distribution<double> weight(0.0, 1.0);
+  for (const TestGraph& graph : makeTestGraphs(30u)) {
+    std::vector<double> vertex_weights(boost::num_vertices(graph));
+    for (double& w : vertex_weights) w = weight(rng);
+
+    double expected_weight = 0.0;
+    for (const Clique& clique : GraphUtilities::findLargestMaximalCliques(graph, kMinCliqueSize,
+                                                                          0u)) {
+      expected_weight = std::max(expected_weight, getWeight(clique, vertex_weights));
+    }
+
+    const Clique clique = GraphUtilities::findMaximumWeightClique(graph, vertex_weights,
+                                                                  kMinCliqueSize);
+    EXPECT_TRUE(isClique(graph, clique));
+    EXPECT_NEAR(expected_weight, getWeight(clique, vertex_weights), 1e-9);
+  }
+}
+
+TEST(GraphUtilitiesTest, LargestMaximalCliquesAreDistinctMaximalAndSorted) {
+  constexpr size_t kMaxNumCliques = 5u;
+  for (const TestGraph& graph : makeTestGraphs(40u)) {
+    const std::vector<Clique> all_cliques = GraphUtilities::findLargestMaximalCliques(
+        graph, kMinCliqueSize, 0u);
+    const std::vector<Clique> cliques = GraphUtilities::findLargestMaximalCliques(
+        graph, kMinCliqueSize, kMaxNumCliques);
+    ASSERT_EQ(std::min(kMaxNumCliques, all_cliques.size()), cliques.size());
+
+    std::set<Clique> distinct_cliques;
+    for (size_t i = 0u; i < cliques.size(); ++i) {
+      EXPECT_TRUE(isClique(graph, cliques[i]));
+      EXPECT_TRUE(isMaximalClique(graph, cliques[i]));
+      EXPECT_GE(cliques[i].size(), kMinCliqueSize);
+      if (i > 0u) EXPECT_GE(cliques[i - 1u].size(), cliques[i].size());
+      // The top-K cliques have the sizes of the K largest maximal cliques.
+      EXPECT_EQ(all_cliques[i].size(), cliques[i].size());
+      Clique sorted_clique = cliques[i];
+      std::sort(sorted_clique.begin(), sorted_clique.end());
+      distinct_cliques.insert(sorted_clique);
+    }
+    EXPECT_EQ(cliques.size(), distinct_cliques.size());
+
+    if (!cliques.empty()) {
+      EXPECT_EQ(GraphUtilities::findMaximumClique(graph, kMinCliqueSize).size(),
+                cliques[0].size());
+    }
+  }
+}
+
+TEST(GraphUtilitiesTest, HeuristicFindsCliqueNotBiggerThanMaximum) {
+  for (const TestGraph& graph : makeTestGraphs(60u)) {
+    const Clique expected = GraphUtilities::findMaximumClique(graph, kMinCliqueSize);
+    for (const auto time_slice : { std::chrono::microseconds(0), std::chrono::microseconds(500) }) {
+      CliqueSearchStatistics statistics;
+      const Clique clique = GraphUtilities::findCliqueHeuristic(graph, kMinCliqueSize, time_slice,
+                                                                &statistics);
+      EXPECT_TRUE(isClique(graph, clique));
+      EXPECT_LE(clique.size(), expected.size());
+      // The planted clique is big enough to be found by the greedy construction.
+      EXPECT_GE(clique.size(), kMinCliqueSize);
+      if (statistics.optimality_proven) EXPECT_EQ(expected.size(), clique.size());
+    }
+  }
+}
+
+TEST(GraphUtilitiesTest, CoreNumbersAndKCoresMatchPeeling) {
+  std::vector<TestGraph> graphs = makeTestGraphs(60u);
+  // Graph with isolated vertices, a path and a clique.
+  graphs.push_back(makeRandomGraph(40u, 0.0, 0u, 6u));
+  for (size_t v = 20u; v + 1u < 40u; ++v) boost::add_edge(v, v + 1u, graphs.back());
+  for (const TestGraph& graph : graphs) {
+    const std::vector<size_t> expected = computeCoreNumbersByPeeling(graph);
+    const size_t expected_degeneracy = *std::max_element(expected.begin(), expected.end());
+
+    std::vector<size_t> core_numbers;
+    EXPECT_EQ(expected_degeneracy, GraphUtilities::computeCoreNumbers(graph, core_numbers));
+    EXPECT_EQ(expected, core_numbers);
+
+    for (size_t k = 0u; k <= expected_degeneracy + 1u; ++k) {
+      std::vector<size_t> expected_k_core;
+      for (size_t v = 0u; v < expected.size(); ++v) {
+        if (expected[v] >= k) expected_k_core.push_back(v);
+      }
+      EXPECT_EQ(expected_k_core, GraphUtilities::findKCore(core_numbers, k));
+    }
+
+    size_t k = 0u;
+    const Clique maximum_k_core = GraphUtilities::findMaximumKCore(graph, &k);
+    EXPECT_EQ(expected_degeneracy, k);
+    EXPECT_EQ(GraphUtilities::findKCore(expected, expected_degeneracy), maximum_k_core);
+    EXPECT_FALSE(maximum_k_core.empty());
+  }
+}
+
+TEST(GraphUtilitiesTest, ParallelCoreNumbersMatchSequential) {
+  WorkStealingThreadPool thread_pool(3u);
+  std::vector<TestGraph> graphs = makeTestGraphs(300u);
+  // Graph with isolated vertices and a long path, i.e. many levels with few vertices.
+  TestGraph path_graph(2000u);
+  for (size_t v = 1000u; v + 1u < 2000u; ++v) boost::add_edge(v, v + 1u, path_graph);
+  graphs.push_back(path_graph);
+  for (const TestGraph& graph : graphs) {
+    std::vector<size_t> expected;
+    std::vector<size_t> core_numbers;
+    const size_t degeneracy = GraphUtilities::computeCoreNumbers(graph, expected);
+    EXPECT_EQ(degeneracy, GraphUtilities::computeCoreNumbersParallel(graph, core_numbers,
+                                                                     thread_pool));
+    EXPECT_EQ(expected, core_numbers);
+  }
+}
+
+TEST(GraphUtilitiesTest, NoCliqueBelowMinimumSize) {
+  const TestGraph graph = makeRandomGraph(30u, 0.05, 7u, 3u);
+  const size_t maximum_clique_size = GraphUtilities::findMaximumClique(graph, 2u).size();
+  const size_t min_clique_size = maximum_clique_size + 1u;
+  EXPECT_TRUE(GraphUtilities::findMaximumClique(graph, min_clique_size).empty());
+  EXPECT_TRUE(GraphUtilities::findMaximumCliqueBitset(graph, min_clique_size).empty());
+  EXPECT_TRUE(GraphUtilities::findMaximumCliqueColoring(graph, min_clique_size).empty());
+  EXPECT_TRUE(GraphUtilities::findLargestMaximalCliques(graph, min_clique_size, 0u).empty());
+}
+
+} // namespace
+} // namespace bron_kerbosch
@@ -0,0 +1,155 @@
+// Microbenchmark of the map from match IDs to cache slots used by the incremental recognizer.
+// Every simulated recognition looks up the IDs of the matches in the map of the previous
+// recognition, builds the map of the current recognition and replaces the old map with it, as
+// IncrementalGeometricConsistencyRecognizer does.
+// 增量识别器中匹配ID到缓存槽映射的微基准测试
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "recognizers/IdPairFlatMap.hpp"
+#include "RecognizerData.h"
+
+using namespace bron_kerbosch;
+
+namespace {
+
+// Hash used before IdPairHash mixed the IDs. Because of the operator precedence, the first ID was
+// shifted by one plus the second ID. The shift amount is reduced modulo 64 as on x86-64.
+struct LegacyIdPairHash {
+  size_t operator() (const IdPair& pair) const {
+    return std::hash<uint64_t>{}(static_cast<uint64_t>(pair.first) <<
+                                 ((1u + static_cast<uint64_t>(pair.second)) & 63u));
+  }
+};
+
+// Sequence of recognitions, each given by the IDs of its matches.
+typedef std::vector<std::vector<IdPair>> Recognitions;
+
+// Generates the IDs of the matches of consecutive recognitions. Every scene segment is matched to
+// the k nearest model segments. Scene segment IDs increase over time and a fraction of the scene
+// segments is replaced in every recognition. Model segment IDs are drawn from a large map.
+Recognitions generateRecognitions(const size_t num_scene_segments, const size_t k,
+                                  const double churn, const size_t num_recognitions,
+                                  const Id num_model_segments, const unsigned seed) {
+  std::mt19937 generator(seed);
+  std::uniform_int_distribution<Id> model_id_distribution(0, num_model_segments - 1);
+  std::uniform_real_distribution<double> churn_distribution(0.0, 1.0);
+  Id next_scene_id = 1000000;
+  std::vector<std::vector<Id>> scene_segments(num_scene_segments);
+  const auto new_segment = [&](std::vector<Id>& segment) {
+    segment.assign(1u, next_scene_id++);
+    for (size_t i = 0u; i < k; ++i) segment.push_back(model_id_distribution(generator));
+  };
+  for (auto& segment : scene_segments) new_segment(segment);
+
+  Recognitions recognitions(num_recognitions);
+  for (auto& ids : recognitions) {
+    for (auto& segment : scene_segments) {
+      if (churn_distribution(generator) < churn) new_segment(segment);
+      for (size_t i = 1u; i < segment.size(); ++i) ids.emplace_back(segment[0], segment[i]);
+    }
+  }
+  return recognitions;
+}
+
+// Runs the recognitions with std::unordered_map and returns a checksum of the slots found.
+template <typename Hash>
+size_t runUnorderedMap(const Recognitions& recognitions) {
+  std::unordered_map<IdPair, size_t, Hash> slots;
+  size_t checksum = 0u;
+  for (const auto& ids : recognitions) {
+    std::unordered_map<IdPair, size_t, Hash> new_slots;
+    new_slots.reserve(ids.size());
+    for (size_t i = 0u; i < ids.size(); ++i) {
+      const auto it = slots.find(ids[i]);
+      if (it != slots.end()) checksum += it->second;
+      new_slots.emplace(ids[i], i);
+    }
+    slots = std::move(new_slots);
+  }
+  return checksum;
+}
+
+// Runs the recognitions with IdPairFlatMap and returns a checksum of the slots found.
+size_t runFlatMap(const Recognitions& recognitions) {
+  IdPairFlatMap slots;
+  IdPairFlatMap new_slots;
+  size_t checksum = 0u;
+  for (const auto& ids : recognitions) {
+    new_slots.clear();
+    new_slots.reserve(ids.size());
+    for (size_t i = 0u; i < ids.size(); ++i) {
+      const size_t slot = slots.find(ids[i]);
+      if (slot != IdPairFlatMap::kNotFound) checksum += slot;
+      new_slots.emplace(ids[i], i);
+    }
+    slots.swap(new_slots);
+  }
+  return checksum;
+}
+
+// Measures the best time per match over several repetitions.
+template <typename Function>
+double measureNanosecondsPerMatch(const Recognitions& recognitions, Function function,
+                                  size_t& checksum) {
+  size_t num_matches = 0u;
+  for (const auto& ids : recognitions) num_matches += ids.size();
+  double best_ns = std::numeric_limits<double>::max();
+  for (int repetition = 0; repetition < 5; ++repetition) {
+    const auto start = std::chrono::steady_clock::now();
+    checksum = function(recognitions);
+    const auto end = std::chrono::steady_clock::now();
+    best_ns = std::min(best_ns, std::chrono::duration<double, std::nano>(end - start).count() /
+                                static_cast<double>(num_matches));
+  }
+  return best_ns;
+}
+
+} // namespace
+
+int main() {
+  struct Scenario {
+    std::string name;
+    size_t num_scene_segments;
+    size_t k;
+    double churn;
+  };
+  const std::vector<Scenario> scenarios = {
+    { "small, k=5, 10% churn", 200u, 5u, 0.1 },
+    { "medium, k=25, 10% churn", 200u, 25u, 0.1 },
+    { "large, k=50, 5% churn", 1000u, 50u, 0.05 },
+    { "large, k=50, 50% churn", 1000u, 50u, 0.5 },
+  };
+
+  std::cout << std::fixed << std::setprecision(1);
+  std::cout << "ns per match (lookup + insertion)\n";
+  std::cout << std::setw(28) << "scenario" << std::setw(14) << "legacy hash" << std::setw(14)
+            << "IdPairHash" << std::setw(14) << "IdPairFlatMap" << "\n";
+  for (const Scenario& scenario : scenarios) {
+    const Recognitions recognitions = generateRecognitions(
+        scenario.num_scene_segments, scenario.k, scenario.churn, 50u, 200000, 42u);
+    size_t legacy_checksum, hash_checksum, flat_checksum;
+    const double legacy_ns = measureNanosecondsPerMatch(
+        recognitions, runUnorderedMap<LegacyIdPairHash>, legacy_checksum);
+    const double hash_ns = measureNanosecondsPerMatch(
+        recognitions, runUnorderedMap<IdPairHash>, hash_checksum);
+    const double flat_ns = measureNanosecondsPerMatch(recognitions, runFlatMap, flat_checksum);
+    std::cout << std::setw(28) << scenario.name << std::setw(14) << legacy_ns << std::setw(14)
+              << hash_ns << std::setw(14) << flat_ns << "\n";
+    if (legacy_checksum != flat_checksum || hash_checksum != flat_checksum) {
+      std::cerr << "The maps found different cache slots.\n";
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,82 @@
+#include <map>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "recognizers/IdPairFlatMap.hpp"
+
+namespace bron_kerbosch {
+namespace {
+
+TEST(IdPairFlatMapTest, EmplaceRejectsDuplicateKeys) {
+  IdPairFlatMap map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_TRUE(map.emplace(IdPair(1, 2), 10u));
+  EXPECT_TRUE(map.emplace(IdPair(2, 1), 20u));
+  EXPECT_FALSE(map.emplace(IdPair(1, 2), 30u));
+  EXPECT_EQ(2u, map.size());
+  // The value of a duplicate key is not overwritten.
+  EXPECT_EQ(10u, map.find(IdPair(1, 2)));
+  EXPECT_EQ(20u, map.find(IdPair(2, 1)));
+}
+
+TEST(IdPairFlatMapTest, FindMissingKey) {
+  IdPairFlatMap map;
+  EXPECT_EQ(IdPairFlatMap::kNotFound, map.find(IdPair(1, 2)));
+  map.emplace(IdPair(1, 2), 0u);
+  EXPECT_EQ(0u, map.find(IdPair(1, 2)));
+  EXPECT_EQ(IdPairFlatMap::kNotFound, map.find(IdPair(2, 1)));
+  EXPECT_EQ(IdPairFlatMap::kNotFound, map.find(IdPair(1, 3)));
+}
+
+TEST(IdPairFlatMapTest, KeepsEntriesWhenGrowing) {
+  IdPairFlatMap map;
+  const size_t initial_capacity = map.capacity();
+  std::mt19937_64 rng(7u);
+  std::map<IdPair, size_t> expected;
+  for (size_t i = 0u; i < 5000u; ++i) {
+    // Keys with few distinct high bits, as the IDs of a map.
+    const IdPair key(static_cast<Id>(rng() % 4096u), static_cast<Id>(rng() % 4096u));
+    EXPECT_EQ(expected.emplace(key, i).second, map.emplace(key, i));
+  }
+  EXPECT_GT(map.capacity(), initial_capacity);
+  // The load factor stays at most one half.
+  EXPECT_LE(2u * map.size(), map.capacity());
+  ASSERT_EQ(expected.size(), map.size());
+  for (const auto& entry : expected) EXPECT_EQ(entry.second, map.find(entry.first));
+}
+
+TEST(IdPairFlatMapTest, ClearKeepsCapacity) {
+  IdPairFlatMap map(1000u);
+  const size_t capacity = map.capacity();
+  EXPECT_LE(2000u, capacity);
+  for (size_t i = 0u; i < 1000u; ++i) map.emplace(IdPair(i, i + 1), i);
+  EXPECT_EQ(capacity, map.capacity());
+
+  map.clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(capacity, map.capacity());
+  EXPECT_EQ(IdPairFlatMap::kNotFound, map.find(IdPair(3, 4)));
+
+  // The keys can be inserted again without growing the storage.
+  for (size_t i = 0u; i < 1000u; ++i) EXPECT_TRUE(map.emplace(IdPair(i, i + 1), 2u * i));
+  EXPECT_EQ(capacity, map.capacity());
+  EXPECT_EQ(6u, map.find(IdPair(3, 4)));
+}
+
+TEST(IdPairFlatMapTest, ForEachVisitsEveryEntryOnce) {
+  IdPairFlatMap map;
+  std::map<IdPair, size_t> expected;
+  for (size_t i = 0u; i < 100u; ++i) {
+    map.emplace(IdPair(i, -static_cast<Id>(i)), i);
+    expected.emplace(IdPair(i, -static_cast<Id>(i)), i);
+  }
+  std::map<IdPair, size_t> visited;
+  map.forEach([&](const IdPair& key, const size_t value) {
+    EXPECT_TRUE(visited.emplace(key, value).second);
+  });
+  EXPECT_EQ(expected, visited);
+}
+
+} // namespace
+} // namespace bron_kerbosch
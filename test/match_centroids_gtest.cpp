@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "recognizers/MatchCentroids.hpp"
+
+namespace bron_kerbosch {
+namespace {
+
+constexpr float kMaxSceneDistance = 12.0f;
+
+// Matches with centroids in a cube larger than the maximum scene distance, so that the scene
+// centroids of the pairs are on both sides of it.
+PairwiseMatches makeMatches(const size_t num_matches, const unsigned int seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+  PairwiseMatches matches;
+  for (size_t i = 0u; i < num_matches; ++i) {
+    const PclPoint model(position(rng), position(rng), position(rng));
+    const PclPoint scene(position(rng), position(rng), position(rng));
+    matches.emplace_back(i, i, model, scene, 1.0f);
+  }
+  return matches;
+}
+
+double getDistance(const PclPoint& p, const PclPoint& q) {
+  const double dx = double(p.x) - double(q.x);
+  const double dy = double(p.y) - double(q.y);
+  const double dz = double(p.z) - double(q.z);
+  return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+// Counts the pairs whose consistency distance is the difference of the scene and model distances
+// and the pairs for which it is the excess of the scene distance.
+struct CutoffCounts {
+  size_t num_within = 0u;
+  size_t num_beyond = 0u;
+};
+
+// Checks a distance computed by the kernels against the scalar definition of the consistency
+// distance, max(|‖s1 − s2‖ − ‖m1 − m2‖|, ‖s1 − s2‖ − d), where d is the maximum scene distance.
+void expectConsistencyDistance(const PairwiseMatch& match_1, const PairwiseMatch& match_2,
+                               const float distance, CutoffCounts& counts) {
+  const double scene_distance = getDistance(match_1.centroids_.second, match_2.centroids_.second);
+  const double difference =
+      std::fabs(scene_distance - getDistance(match_1.centroids_.first, match_2.centroids_.first));
+  const double excess = scene_distance - kMaxSceneDistance;
+  EXPECT_NEAR(std::max(difference, excess), distance, 1e-4);
+  if (excess > difference) {
+    ++counts.num_beyond;
+  } else {
+    ++counts.num_within;
+  }
+}
+
+// Ranges whose sizes are not multiples of 4, 8 or 16, so that the vector loops and the scalar
+// remainder are both used, and do not start at an aligned slot.
+TEST(MatchCentroidsTest, RangeDistancesMatchScalarDefinition) {
+  const PairwiseMatches matches = makeMatches(101u, 1u);
+  std::vector<size_t> match_indices(matches.size());
+  for (size_t i = 0u; i < match_indices.size(); ++i) match_indices[i] = i;
+  MatchCentroids centroids;
+  centroids.assign(matches, match_indices);
+  ASSERT_EQ(matches.size(), centroids.size());
+
+  CutoffCounts counts;
+  for (const size_t begin : { 0u, 3u, 17u }) {
+    for (const size_t size : { 1u, 5u, 13u, 37u, 83u }) {
+      SCOPED_TRACE(::testing::Message() << "begin " << begin << " size " << size);
+      const size_t end = begin + size;
+      for (const size_t slot : { 0u, 42u, 100u }) {
+        std::vector<float> distances(size);
+        centroids.computeConsistencyDistances(slot, begin, end, kMaxSceneDistance,
+                                              distances.data());
+        for (size_t i = 0u; i < size; ++i) {
+          expectConsistencyDistance(matches[slot], matches[begin + i], distances[i], counts);
+        }
+      }
+    }
+  }
+  EXPECT_GT(counts.num_within, 0u);
+  EXPECT_GT(counts.num_beyond, 0u);
+}
+
+// Lists smaller and larger than the gathering blocks, in the order of a shuffled subset of the
+// matches.
+TEST(MatchCentroidsTest, ListDistancesMatchScalarDefinition) {
+  const PairwiseMatches matches = makeMatches(150u, 2u);
+  std::vector<size_t> match_indices;
+  for (size_t i = 0u; i < matches.size(); i += 2u) match_indices.push_back(i);
+  std::mt19937 rng(3u);
+  std::shuffle(match_indices.begin(), match_indices.end(), rng);
+  MatchCentroids centroids;
+  centroids.assign(matches, match_indices);
+  ASSERT_EQ(match_indices.size(), centroids.size());
+
+  CutoffCounts counts;
+  std::uniform_int_distribution<size_t> random_slot(0u, centroids.size() - 1u);
+  for (const size_t size : { 0u, 7u, 37u, 64u, 131u }) {
+    SCOPED_TRACE(size);
+    std::vector<size_t> candidate_slots(size);
+    for (size_t& slot : candidate_slots) slot = random_slot(rng);
+    const size_t slot = random_slot(rng);
+    std::vector<float> distances(size + 1u, -1.0f);
+    centroids.computeConsistencyDistances(slot, candidate_slots, kMaxSceneDistance,
+                                          distances.data());
+    for (size_t i = 0u; i < size; ++i) {
+      expectConsistencyDistance(matches[match_indices[slot]],
+                                matches[match_indices[candidate_slots[i]]], distances[i],
+                                counts);
+    }
+    // Nothing is written after the distances of the list.
+    EXPECT_EQ(-1.0f, distances[size]);
+  }
+  EXPECT_GT(counts.num_within, 0u);
+  EXPECT_GT(counts.num_beyond, 0u);
+}
+
+} // namespace
+} // namespace bron_kerbosch
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "recognizers/IncrementalGeometricConsistencyRecognizer.hpp"
+#include "recognizers/MatchesPartitioner.hpp"
+#include "test_helpers.hpp"
+
+namespace bron_kerbosch {
+namespace {
+
+struct NoPartitionData { };
+
+// Matches with scene centroids clustered around a few points, so that many pairs are closer than
+// the partition size, some of them across partition borders.
+PairwiseMatches makeClusteredMatches(const size_t num_matches, const unsigned int seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> center(-20.0f, 20.0f);
+  std::normal_distribution<float> offset(0.0f, 2.0f);
+  std::vector<PclPoint> centers;
+  for (size_t i = 0u; i < 10u; ++i) centers.emplace_back(center(rng), center(rng), center(rng));
+
+  PairwiseMatches matches;
+  for (size_t i = 0u; i < num_matches; ++i) {
+    const PclPoint& c = centers[i % centers.size()];
+    const PclPoint scene(c.x + offset(rng), c.y + offset(rng), c.z + offset(rng));
+    matches.emplace_back(i, i, PclPoint(0.0f, 0.0f, 0.0f), scene, 1.0f);
+  }
+  return matches;
+}
+
+float getSceneDistance(const PairwiseMatch& a, const PairwiseMatch& b) {
+  const PclPoint& p = a.centroids_.second;
+  const PclPoint& q = b.centroids_.second;
+  return std::sqrt((p.x - q.x) * (p.x - q.x) + (p.y - q.y) * (p.y - q.y) +
+                   (p.z - q.z) * (p.z - q.z));
+}
+
+TEST(MatchesPartitionerTest, CloseMatchesAreInNeighborFlatGridPartitions) {
+  constexpr float kPartitionSize = 3.0f;
+  MatchesFlatGridPartitioning partitioning;
+  for (unsigned int seed = 0u; seed < 5u; ++seed) {
+    const PairwiseMatches matches = makeClusteredMatches(400u, seed);
+    MatchesPartitioner::computeFlatGridPartitioning(matches, kPartitionSize, partitioning);
+
+    // Every match is in exactly one partition.
+    std::vector<size_t> row(matches.size(), matches.size());
+    std::vector<size_t> column(matches.size(), matches.size());
+    const std::vector<size_t>& offsets = partitioning.getPartitionOffsets();
+    ASSERT_EQ(partitioning.getNumPartitions() + 1u, offsets.size());
+    for (size_t i = 0u; i < partitioning.getHeight(); ++i) {
+      for (size_t j = 0u; j < partitioning.getWidth(); ++j) {
+        const size_t partition = partitioning.getPartitionIndex(i, j);
+        for (size_t k = offsets[partition]; k < offsets[partition + 1u]; ++k) {
+          const size_t match_index = partitioning.getMatchIndices()[k];
+          ASSERT_EQ(matches.size(), row[match_index]);
+          row[match_index] = i;
+          column[match_index] = j;
+        }
+      }
+    }
+    ASSERT_EQ(matches.size(), partitioning.getMatchIndices().size());
+
+    for (size_t a = 0u; a < matches.size(); ++a) {
+      for (size_t b = a + 1u; b < matches.size(); ++b) {
+        if (getSceneDistance(matches[a], matches[b]) > kPartitionSize) continue;
+        EXPECT_LE(std::max(row[a], row[b]) - std::min(row[a], row[b]), 1u);
+        EXPECT_LE(std::max(column[a], column[b]) - std::min(column[a], column[b]), 1u);
+      }
+    }
+  }
+}
+
+TEST(MatchesPartitionerTest, CloseMatchesAreInNeighborVoxels) {
+  constexpr float kPartitionSize = 3.0f;
+  for (unsigned int seed = 0u; seed < 5u; ++seed) {
+    const PairwiseMatches matches = makeClusteredMatches(400u, seed);
+    const MatchesVoxelPartitioning<NoPartitionData> partitioning =
+        MatchesPartitioner::computeVoxelPartitioning<NoPartitionData>(matches, kPartitionSize);
+
+    // Every match is in exactly one partition.
+    std::vector<size_t> match_partitions(matches.size(), partitioning.kNoPartition);
+    for (size_t p = 0u; p < partitioning.getNumPartitions(); ++p) {
+      for (const size_t match_index : partitioning[p].match_indices) {
+        ASSERT_EQ(partitioning.kNoPartition, match_partitions[match_index]);
+        match_partitions[match_index] = p;
+      }
+    }
+
+    for (size_t a = 0u; a < matches.size(); ++a) {
+      ASSERT_NE(partitioning.kNoPartition, match_partitions[a]);
+      const std::vector<size_t>& neighbors =
+          partitioning[match_partitions[a]].neighbor_partitions;
+      for (size_t b = 0u; b < matches.size(); ++b) {
+        if (getSceneDistance(matches[a], matches[b]) > kPartitionSize) continue;
+        EXPECT_NE(neighbors.end(),
+                  std::find(neighbors.begin(), neighbors.end(), match_partitions[b]));
+      }
+    }
+  }
+}
+
+TEST(MatchesPartitionerTest, MortonOrderIsPermutation) {
+  const PairwiseMatches matches = makeClusteredMatches(500u, 3u);
+  std::vector<size_t> order;
+  MatchesPartitioner::computeMortonOrder(matches, order);
+  ASSERT_EQ(matches.size(), order.size());
+  std::vector<size_t> sorted_order = order;
+  std::sort(sorted_order.begin(), sorted_order.end());
+  for (size_t i = 0u; i < sorted_order.size(); ++i) EXPECT_EQ(i, sorted_order[i]);
+}
+
+// The clusters found on the Morton ordered matches contain the matches passed to recognize().
+TEST(MatchesPartitionerTest, MortonOrderingKeepsCallerMatches) {
+  GeometricConsistencyParams params;
+  params.resolution = 0.4;
+  params.min_cluster_size = 5;
+  params.max_consistency_distance_for_caching = 3.0f;
+  params.max_num_candidate_clusters = 3;
+  for (const bool persistent_graph : { false, true }) {
+    for (const std::string partitioner : { "Grid", "Voxel" }) {
+      SCOPED_TRACE(partitioner + (persistent_graph ? " persistent" : ""));
+      params.matches_partitioner = partitioner;
+      params.enable_persistent_consistency_graph = persistent_graph;
+      params.enable_morton_ordering = false;
+      IncrementalGeometricConsistencyRecognizer recognizer(params, test::kMaxModelRadius);
+      params.enable_morton_ordering = true;
+      IncrementalGeometricConsistencyRecognizer morton_recognizer(params, test::kMaxModelRadius);
+
+      for (unsigned int frame = 0u; frame < 4u; ++frame) {
+        const PairwiseMatches matches = test::makeScene(20u, 300u, frame, 0.05f);
+        recognizer.recognize(matches);
+        morton_recognizer.recognize(matches);
+        const std::vector<PairwiseMatches>& clusters = recognizer.getCandidateClusters();
+        const std::vector<PairwiseMatches>& morton_clusters =
+            morton_recognizer.getCandidateClusters();
+        ASSERT_FALSE(morton_clusters.empty());
+        ASSERT_EQ(clusters.size(), morton_clusters.size());
+        EXPECT_EQ(clusters[0].size(), morton_clusters[0].size());
+
+        // Every match of the clusters is a match of the frame, with its centroids.
+        for (const PairwiseMatches& cluster : morton_clusters) {
+          for (const PairwiseMatch& match : cluster) {
+            const auto it = std::find_if(matches.begin(), matches.end(),
+                                         [&](const PairwiseMatch& m) {
+              return m.ids_ == match.ids_;
+            });
+            ASSERT_NE(matches.end(), it);
+            EXPECT_EQ(0.0f, getSceneDistance(*it, match));
+          }
+        }
+      }
+    }
+  }
+}
+
+} // namespace
+} // namespace bron_kerbosch
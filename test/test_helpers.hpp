@@ -0,0 +1,128 @@
+#ifndef TEST_HELPERS_HPP_
+#define TEST_HELPERS_HPP_
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <boost/graph/adjacency_list.hpp>
+#include <Eigen/Geometry>
+
+#include "parameter.h"
+#include "RecognizerData.h"
+
+namespace bron_kerbosch {
+namespace test {
+
+// Graph type used for testing the graph algorithms.
+typedef boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS> TestGraph;
+
+// Radius of the models generated by makeScene().
+constexpr float kMaxModelRadius = 60.0f;
+
+// Parameters of the recognizers used in the tests.
+inline GeometricConsistencyParams makeParams() {
+  GeometricConsistencyParams params;
+  params.resolution = 0.4;
+  params.min_cluster_size = 5;
+  params.max_consistency_distance_for_caching = 3.0f;
+  return params;
+}
+
+// Sorted model segment IDs of the matches of a cluster, for comparing clusters regardless of the
+// order of their matches.
+inline std::vector<Id> getSortedModelIds(const PairwiseMatches& cluster) {
+  std::vector<Id> ids;
+  for (const PairwiseMatch& match : cluster) ids.push_back(match.ids_.first);
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+// Transformation from the model to the scene used by makeScene().
+inline Eigen::Affine3f getSceneTransformation() {
+  return Eigen::Translation3f(5.0f, -3.0f, 1.0f) *
+      Eigen::AngleAxisf(0.7f, Eigen::Vector3f::UnitZ());
+}
+
+// Generates the matches of a scene: num_inliers true matches with IDs (i, i), whose model
+// centroids do not depend on the seed, and num_outliers random matches with IDs
+// (1000 + i, 2000 + i). The scene centroids of the true matches are perturbed by up to jitter
+// along every axis. The matches are shuffled.
+// 生成场景匹配：num_inliers个正确匹配与num_outliers个随机匹配
+inline PairwiseMatches makeScene(const size_t num_inliers, const size_t num_outliers,
+                                 const unsigned int seed, const float jitter = 0.0f) {
+  constexpr float kExtent = 40.0f;
+  std::mt19937 model_rng(1234u);
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> position(-kExtent, kExtent);
+  std::uniform_real_distribution<float> noise(-jitter, jitter);
+  const Eigen::Affine3f transformation = getSceneTransformation();
+
+  PairwiseMatches matches;
+  for (size_t i = 0u; i < num_inliers; ++i) {
+    const Eigen::Vector3f model(position(model_rng), position(model_rng),
+                                position(model_rng) * 0.1f);
+    const Eigen::Vector3f scene = transformation * model +
+        Eigen::Vector3f(noise(rng), noise(rng), noise(rng));
+    matches.emplace_back(i, i, PclPoint(model.x(), model.y(), model.z()),
+                         PclPoint(scene.x(), scene.y(), scene.z()), 0.5f + 0.5f * (i % 2u));
+  }
+  for (size_t i = 0u; i < num_outliers; ++i) {
+    const PclPoint model(position(rng), position(rng), position(rng) * 0.1f);
+    const PclPoint scene(position(rng), position(rng), position(rng) * 0.1f);
+    matches.emplace_back(1000 + i, 2000 + i, model, scene, 0.3f);
+  }
+  std::shuffle(matches.begin(), matches.end(), rng);
+  return matches;
+}
+
+// Generates a random graph where every edge exists with the given probability, plus a planted
+// clique of planted_clique_size random vertices.
+// 生成随机图，并植入一个给定大小的团
+inline TestGraph makeRandomGraph(const size_t num_vertices, const double edge_probability,
+                                 const unsigned int seed, size_t planted_clique_size = 0u) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  std::vector<std::vector<bool>> adjacency(num_vertices, std::vector<bool>(num_vertices, false));
+  for (size_t i = 0u; i < num_vertices; ++i) {
+    for (size_t j = i + 1u; j < num_vertices; ++j) {
+      adjacency[i][j] = adjacency[j][i] = uniform(rng) < edge_probability;
+    }
+  }
+
+  std::vector<size_t> vertices(num_vertices);
+  for (size_t i = 0u; i < num_vertices; ++i) vertices[i] = i;
+  std::shuffle(vertices.begin(), vertices.end(), rng);
+  planted_clique_size = std::min(planted_clique_size, num_vertices);
+  for (size_t i = 0u; i < planted_clique_size; ++i) {
+    for (size_t j = i + 1u; j < planted_clique_size; ++j) {
+      adjacency[vertices[i]][vertices[j]] = adjacency[vertices[j]][vertices[i]] = true;
+    }
+  }
+
+  TestGraph graph(num_vertices);
+  for (size_t i = 0u; i < num_vertices; ++i) {
+    for (size_t j = i + 1u; j < num_vertices; ++j) {
+      if (adjacency[i][j]) boost::add_edge(i, j, graph);
+    }
+  }
+  return graph;
+}
+
+// Checks that the vertices are distinct and pairwise connected.
+template <typename Graph, typename Vertex>
+bool isClique(const Graph& graph, const std::vector<Vertex>& vertices) {
+  for (size_t i = 0u; i < vertices.size(); ++i) {
+    for (size_t j = i + 1u; j < vertices.size(); ++j) {
+      if (vertices[i] == vertices[j] || !boost::edge(vertices[i], vertices[j], graph).second) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+} // namespace test
+} // namespace bron_kerbosch
+
+#endif // TEST_HELPERS_HPP_
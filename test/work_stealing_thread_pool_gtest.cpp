@@ -0,0 +1,54 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "WorkStealingThreadPool.h"
+
+namespace bron_kerbosch {
+namespace {
+
+TEST(WorkStealingThreadPoolTest, ParallelForCallsEveryIndexOnce) {
+  WorkStealingThreadPool thread_pool(4u);
+  std::vector<std::atomic<int>> num_calls(1000u);
+  for (std::atomic<int>& n : num_calls) n = 0;
+  std::atomic<bool> valid_worker_indices(true);
+  thread_pool.parallelFor(0u, num_calls.size(), [&](const size_t index, const size_t worker) {
+    ++num_calls[index];
+    if (worker >= thread_pool.getNumThreads()) valid_worker_indices = false;
+  });
+  for (const std::atomic<int>& n : num_calls) EXPECT_EQ(1, n);
+  EXPECT_TRUE(valid_worker_indices);
+}
+
+TEST(WorkStealingThreadPoolTest, CallerIsNotAWorker) {
+  WorkStealingThreadPool thread_pool(2u);
+  EXPECT_EQ(WorkStealingThreadPool::kNotAWorker, thread_pool.getCurrentWorkerIndex());
+  const size_t worker = thread_pool.submit([&] {
+    return thread_pool.getCurrentWorkerIndex();
+  }).get();
+  EXPECT_LT(worker, thread_pool.getNumThreads());
+}
+
+// A parallelFor() called from a worker runs inline on that worker, so it cannot deadlock by
+// waiting for tasks queued behind the busy workers.
+TEST(WorkStealingThreadPoolTest, NestedParallelForRunsInline) {
+  WorkStealingThreadPool thread_pool(2u);
+  std::atomic<size_t> num_inner_calls(0u);
+  std::atomic<bool> inline_calls(true);
+  thread_pool.parallelFor(0u, 4u, [&](const size_t, const size_t outer_worker) {
+    const std::thread::id outer_thread = std::this_thread::get_id();
+    thread_pool.parallelFor(0u, 8u, [&](const size_t, const size_t inner_worker) {
+      if (inner_worker != outer_worker || std::this_thread::get_id() != outer_thread) {
+        inline_calls = false;
+      }
+      ++num_inner_calls;
+    });
+  });
+  EXPECT_EQ(32u, num_inner_calls);
+  EXPECT_TRUE(inline_calls);
+}
+
+} // namespace
+} // namespace bron_kerbosch